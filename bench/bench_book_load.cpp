@@ -0,0 +1,132 @@
+// Load time and peak RSS of a large option book.
+//
+//   bench_book_load [heap|arena] [nb_trades]
+//
+// "heap" news every option separately (fixings of long schedules on the global heap),
+// "arena" builds the same book in an OptionBook. Peak RSS is per process, so run each
+// mode in its own process to compare them.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include <sys/resource.h>
+#include "AmericanCallOption.h"
+#include "AmericanPutOption.h"
+#include "AsianCallOption.h"
+#include "AsianPutOption.h"
+#include "CallOption.h"
+#include "EuropeanDigitalCallOption.h"
+#include "OptionBook.h"
+#include "PutOption.h"
+
+namespace {
+
+// book mix: vanillas, digitals and Americans, a fifth of monthly Asians and a few dailies
+struct Trade {
+    int kind;
+    double expiry;
+    double strike;
+};
+
+std::vector<Trade> makeTrades(std::size_t n) {
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::uniform_real_distribution<double> expiry(0.1, 3.0);
+    std::uniform_real_distribution<double> strike(60.0, 140.0);
+    std::vector<Trade> trades(n);
+    for (Trade& t : trades) {
+        t = {kind(gen), expiry(gen), strike(gen)};
+    }
+    return trades;
+}
+
+void fillSchedule(std::vector<double>& steps, double expiry, int nb_fixings) {
+    steps.resize(nb_fixings);
+    for (int i = 0; i < nb_fixings; ++i) {
+        steps[i] = expiry * (i + 1) / nb_fixings;
+    }
+}
+
+long peakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template <class Add>
+void load(const std::vector<Trade>& trades, Add add) {
+    std::vector<double> steps;
+    for (const Trade& t : trades) {
+        if (t.kind < 30) {
+            add(0, t, steps);
+        } else if (t.kind < 45) {
+            add(1, t, steps);
+        } else if (t.kind < 55) {
+            add(2, t, steps);
+        } else if (t.kind < 75) {
+            add(3, t, steps);
+        } else if (t.kind < 95) {
+            fillSchedule(steps, t.expiry, 12);
+            add(4, t, steps);
+        } else {
+            fillSchedule(steps, t.expiry, 252);
+            add(5, t, steps);
+        }
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    const bool arena = argc < 2 || std::strcmp(argv[1], "arena") == 0;
+    const std::size_t n = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    const std::vector<Trade> trades = makeTrades(n);
+    const long rss_before = peakRssKb();
+
+    double load_ms = 0.0;
+    double release_ms = 0.0;
+    if (arena) {
+        auto start = std::chrono::steady_clock::now();
+        OptionBook book(n * 128);
+        book.reserve(n);
+        load(trades, [&](int kind, const Trade& t, const std::vector<double>& steps) {
+            switch (kind) {
+                case 0: book.add<CallOption>(t.expiry, t.strike); break;
+                case 1: book.add<PutOption>(t.expiry, t.strike); break;
+                case 2: book.add<EuropeanDigitalCallOption>(t.expiry, t.strike); break;
+                case 3: book.add<AmericanPutOption>(t.expiry, t.strike); break;
+                case 4: book.add<AsianCallOption>(steps, t.strike); break;
+                default: book.add<AsianPutOption>(steps, t.strike); break;
+            }
+        });
+        load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("mode=arena trades=%zu\n", book.size());
+        start = std::chrono::steady_clock::now();
+        book.clear();
+        release_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<Option>> book;
+        book.reserve(n);
+        load(trades, [&](int kind, const Trade& t, const std::vector<double>& steps) {
+            switch (kind) {
+                case 0: book.emplace_back(new CallOption(t.expiry, t.strike)); break;
+                case 1: book.emplace_back(new PutOption(t.expiry, t.strike)); break;
+                case 2: book.emplace_back(new EuropeanDigitalCallOption(t.expiry, t.strike)); break;
+                case 3: book.emplace_back(new AmericanPutOption(t.expiry, t.strike)); break;
+                case 4: book.emplace_back(new AsianCallOption(steps, t.strike)); break;
+                default: book.emplace_back(new AsianPutOption(steps, t.strike)); break;
+            }
+        });
+        load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("mode=heap trades=%zu\n", book.size());
+        start = std::chrono::steady_clock::now();
+        book.clear();
+        release_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::printf("load_ms=%.1f release_ms=%.1f book_rss_kb=%ld\n", load_ms, release_ms, peakRssKb() - rss_before);
+    return 0;
+}
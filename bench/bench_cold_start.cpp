@@ -0,0 +1,36 @@
+// Cold start: time from process start to the first Gauss-Hermite price, with the
+// quadrature rules mapped from the table pack or computed. Run each mode in a fresh
+// process, as the default pack is mapped once per process:
+//
+//   bench_cold_start pack [nodes]
+//   bench_cold_start compute [nodes]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "CallOption.h"
+#include "GaussHermitePricer.h"
+#include "TablePack.h"
+
+int main(int argc, char** argv) {
+    const auto start = std::chrono::steady_clock::now();
+    if (argc < 2 || (std::strcmp(argv[1], "pack") != 0 && std::strcmp(argv[1], "compute") != 0)) {
+        std::fprintf(stderr, "usage: %s pack|compute [nodes]\n", argv[0]);
+        return 2;
+    }
+    const bool compute = std::strcmp(argv[1], "compute") == 0;
+    const int nodes = argc > 2 ? std::atoi(argv[2]) : GaussHermitePricer::kDefaultNodes;
+    if (compute) {
+        // an unreadable path leaves the default pack empty
+        setenv("MESIFI_TABLE_PACK", "", 1);
+    }
+
+    CallOption call(1.0, 100.0);
+    GaussHermitePricer pricer(nodes);
+    const double price = pricer.price(&call, 100.0, 0.03, 0.2);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%-8s nodes %4d  tables %3zu  price %.12f  first price after %.1f us\n", argv[1], nodes,
+                TablePack::defaultPack().size(), price, 1e6 * elapsed);
+    return 0;
+}
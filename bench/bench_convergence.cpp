@@ -0,0 +1,417 @@
+// Accuracy against cost: sweeps the resolution of every engine (tree depth, quadrature
+// nodes, Monte Carlo paths) on a reference set of vanilla, digital, American and Asian
+// contracts, and records the absolute error against a high-precision reference, the CPU
+// time and the peak heap use of each run. Writes the runs, with the Pareto frontier of
+// each contract in error against time marked, as CSV and/or JSON:
+//
+//   bench_convergence [--quick] [--csv runs.csv] [--json runs.json]
+//
+// References: the closed form for the European contracts; for the American put, VectorizedCRR
+// on a deep tree, averaged over adjacent depths (which cancels the odd/even oscillation),
+// its change from half the depth as its error; for the Asian call, a moment-matched Monte Carlo
+// run of many paths, its standard error as its error. There is no PDE engine to sweep.
+// Monte Carlo errors are root mean squares over several seeds, the time that of one run.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+#include "AmericanPutOption.h"
+#include "AsianCallOption.h"
+#include "BlackScholesMCPricer.h"
+#include "BlackScholesPricer.h"
+#include "CRRPricer.h"
+#include "CallOption.h"
+#include "EuropeanDigitalCallOption.h"
+#include "FixedDepthCRR.h"
+#include "GaussHermitePricer.h"
+#include "MT.h"
+#include "PutOption.h"
+#include "TurnbullWakemanPricer.h"
+#include "VectorizedCRR.h"
+
+// Heap accounting for the peak-memory column: every allocation carries its size in a
+// header, so the live and peak byte counts are exact.
+namespace {
+
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+std::size_t g_live_bytes = 0;
+std::size_t g_peak_bytes = 0;
+
+void* tracked_new(std::size_t size, std::size_t alignment = kHeader) {
+    const std::size_t header = std::max(alignment, kHeader);
+    void* block = alignment > kHeader ? std::aligned_alloc(alignment, (size + header + alignment - 1) / alignment * alignment)
+                                      : std::malloc(size + header);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(block) = size;
+    g_live_bytes += size;
+    g_peak_bytes = std::max(g_peak_bytes, g_live_bytes);
+    return static_cast<char*>(block) + header;
+}
+
+void tracked_delete(void* p, std::size_t alignment = kHeader) noexcept {
+    if (p) {
+        void* block = static_cast<char*>(p) - std::max(alignment, kHeader);
+        g_live_bytes -= *static_cast<std::size_t*>(block);
+        std::free(block);
+    }
+}
+
+}
+
+void* operator new(std::size_t size) { return tracked_new(size); }
+void* operator new[](std::size_t size) { return tracked_new(size); }
+void* operator new(std::size_t size, std::align_val_t a) { return tracked_new(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a) { return tracked_new(size, static_cast<std::size_t>(a)); }
+void operator delete(void* p) noexcept { tracked_delete(p); }
+void operator delete[](void* p) noexcept { tracked_delete(p); }
+void operator delete(void* p, std::size_t) noexcept { tracked_delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { tracked_delete(p); }
+void operator delete(void* p, std::align_val_t a) noexcept { tracked_delete(p, static_cast<std::size_t>(a)); }
+void operator delete[](void* p, std::align_val_t a) noexcept { tracked_delete(p, static_cast<std::size_t>(a)); }
+void operator delete(void* p, std::size_t, std::align_val_t a) noexcept { tracked_delete(p, static_cast<std::size_t>(a)); }
+void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept { tracked_delete(p, static_cast<std::size_t>(a)); }
+
+namespace {
+
+constexpr double kS0 = 100.0;
+constexpr double kRate = 0.03;
+constexpr double kVol = 0.25;
+constexpr int kSeeds = 4;
+
+// moment-matching blocks large enough for the bias to stay below the standard error
+// (see BlackScholesMCPricer::setMomentMatching())
+std::size_t matchedBlockPairs(int nb_paths) {
+    return std::max(BlackScholesMCPricer::kMinBlockPairs, static_cast<std::size_t>(3.0 * std::sqrt(static_cast<double>(nb_paths))));
+}
+
+struct Settings {
+    bool quick{false};
+    double min_seconds{0.05};
+    int max_mc_log2{20};
+    int max_tree_log2{14};
+    int reference_tree_depth{1 << 15};
+    int reference_mc_paths{1 << 23};
+};
+
+struct Contract {
+    std::string name;
+    Option* option;
+    double reference;
+    double reference_error;
+};
+
+struct Run {
+    std::string engine;
+    std::string contract;
+    std::string parameter;
+    long long resolution;
+    double price;
+    double reference;
+    double abs_error;
+    double std_error;
+    double cpu_seconds;
+    std::size_t peak_bytes;
+    bool pareto{false};
+};
+
+double cpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+// CPU time of one call, repeated for at least min_seconds, and the heap peak of the first
+double measure(const Settings& settings, const std::function<double()>& price, double& result, std::size_t& peak_bytes) {
+    const std::size_t base = g_live_bytes;
+    g_peak_bytes = base;
+    const double start = cpuSeconds();
+    result = price();
+    peak_bytes = g_peak_bytes - base;
+    int runs = 1;
+    double elapsed = cpuSeconds() - start;
+    while (elapsed < settings.min_seconds) {
+        price();
+        ++runs;
+        elapsed = cpuSeconds() - start;
+    }
+    return elapsed / runs;
+}
+
+class Harness {
+private:
+    Settings _settings;
+    std::vector<Run> _runs;
+
+public:
+    explicit Harness(const Settings& settings) : _settings(settings) {}
+
+    void deterministic(const std::string& engine, const Contract& contract, const std::string& parameter, long long resolution,
+                       const std::function<double()>& price) {
+        Run run{engine, contract.name, parameter, resolution, 0.0, contract.reference, 0.0, NAN, 0.0, 0};
+        run.cpu_seconds = measure(_settings, price, run.price, run.peak_bytes);
+        run.abs_error = std::fabs(run.price - contract.reference);
+        add(run);
+    }
+
+    void monteCarlo(const std::string& engine, const Contract& contract, int nb_paths, bool moment_matching) {
+        Run run{engine, contract.name, "paths", nb_paths, 0.0, contract.reference, 0.0, 0.0, 0.0, 0};
+        double squared_error = 0.0;
+        double cpu_seconds = 0.0;
+        for (int seed = 0; seed < kSeeds; ++seed) {
+            MT::setEngine(RNGEngine::Xoshiro256pp, 1000 + seed);
+            double price = 0.0;
+            std::size_t peak_bytes = 0;
+            const double start = cpuSeconds();
+            const std::size_t base = g_live_bytes;
+            g_peak_bytes = base;
+            {
+                BlackScholesMCPricer pricer(contract.option, kS0, kRate, kVol);
+                if (moment_matching) {
+                    pricer.setMomentMatching(true, matchedBlockPairs(nb_paths));
+                }
+                pricer.generate(nb_paths);
+                price = pricer.price();
+                run.std_error += pricer.standardError() / kSeeds;
+            }
+            peak_bytes = g_peak_bytes - base;
+            cpu_seconds += cpuSeconds() - start;
+            squared_error += (price - contract.reference) * (price - contract.reference);
+            run.peak_bytes = std::max(run.peak_bytes, peak_bytes);
+            if (seed == 0) {
+                run.price = price;
+            }
+        }
+        MT::setEngine(RNGEngine::MT19937);
+        run.abs_error = std::sqrt(squared_error / kSeeds);
+        run.cpu_seconds = cpu_seconds / kSeeds;
+        add(run);
+    }
+
+    void add(const Run& run) {
+        _runs.push_back(run);
+        std::printf("%-22s %-14s %-6s %8lld  price %.10f  error %.3e  cpu %.3e s  heap %9zu B\n", run.engine.c_str(), run.contract.c_str(),
+                    run.parameter.c_str(), run.resolution, run.price, run.abs_error, run.cpu_seconds, run.peak_bytes);
+    }
+
+    // a run is on the frontier if no run on the same contract is both faster and more accurate
+    void markPareto() {
+        std::vector<std::size_t> order(_runs.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+            const Run& x = _runs[a];
+            const Run& y = _runs[b];
+            if (x.contract != y.contract) {
+                return x.contract < y.contract;
+            }
+            return x.cpu_seconds != y.cpu_seconds ? x.cpu_seconds < y.cpu_seconds : x.abs_error < y.abs_error;
+        });
+        std::string contract;
+        double best = INFINITY;
+        for (std::size_t i : order) {
+            if (_runs[i].contract != contract) {
+                contract = _runs[i].contract;
+                best = INFINITY;
+            }
+            if (_runs[i].abs_error < best) {
+                _runs[i].pareto = true;
+                best = _runs[i].abs_error;
+            }
+        }
+    }
+
+    bool writeCsv(const char* path) const {
+        FILE* out = std::fopen(path, "w");
+        if (!out) {
+            return false;
+        }
+        std::fprintf(out, "engine,contract,parameter,resolution,price,reference,abs_error,std_error,cpu_seconds,peak_bytes,pareto\n");
+        for (const Run& run : _runs) {
+            std::fprintf(out, "%s,%s,%s,%lld,%.17g,%.17g,%.6e,", run.engine.c_str(), run.contract.c_str(), run.parameter.c_str(), run.resolution,
+                         run.price, run.reference, run.abs_error);
+            if (!std::isnan(run.std_error)) {
+                std::fprintf(out, "%.6e", run.std_error);
+            }
+            std::fprintf(out, ",%.6e,%zu,%d\n", run.cpu_seconds, run.peak_bytes, run.pareto ? 1 : 0);
+        }
+        return std::fclose(out) == 0;
+    }
+
+    bool writeJson(const char* path, const std::vector<Contract>& contracts) const {
+        FILE* out = std::fopen(path, "w");
+        if (!out) {
+            return false;
+        }
+        std::fprintf(out, "{\n  \"contracts\": [\n");
+        for (std::size_t i = 0; i < contracts.size(); ++i) {
+            std::fprintf(out, "    {\"name\": \"%s\", \"reference\": %.17g, \"reference_error\": %.6e}%s\n", contracts[i].name.c_str(),
+                         contracts[i].reference, contracts[i].reference_error, i + 1 < contracts.size() ? "," : "");
+        }
+        std::fprintf(out, "  ],\n  \"runs\": [\n");
+        for (std::size_t i = 0; i < _runs.size(); ++i) {
+            const Run& run = _runs[i];
+            std::fprintf(out,
+                         "    {\"engine\": \"%s\", \"contract\": \"%s\", \"parameter\": \"%s\", \"resolution\": %lld, \"price\": %.17g, "
+                         "\"abs_error\": %.6e, \"std_error\": ",
+                         run.engine.c_str(), run.contract.c_str(), run.parameter.c_str(), run.resolution, run.price, run.abs_error);
+            if (std::isnan(run.std_error)) {
+                std::fprintf(out, "null");
+            } else {
+                std::fprintf(out, "%.6e", run.std_error);
+            }
+            std::fprintf(out, ", \"cpu_seconds\": %.6e, \"peak_bytes\": %zu, \"pareto\": %s}%s\n", run.cpu_seconds, run.peak_bytes,
+                         run.pareto ? "true" : "false", i + 1 < _runs.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+        return std::fclose(out) == 0;
+    }
+};
+
+std::vector<int> powersOfTwo(int from_log2, int to_log2) {
+    std::vector<int> values;
+    for (int k = from_log2; k <= to_log2; ++k) {
+        values.push_back(1 << k);
+    }
+    return values;
+}
+
+void sweepTrees(Harness& harness, const Settings& settings, const Contract& contract) {
+    const Option* option = contract.option;
+    for (int depth : {4, 8, 16, 32, 64}) {
+        harness.deterministic("fixed_depth_crr", contract, "depth", depth,
+                              [=]() { return FixedDepthCRR::price(option, depth, kS0, kRate, kVol); });
+    }
+    for (int depth : powersOfTwo(4, std::min(settings.max_tree_log2, 11))) {
+        harness.deterministic("crr", contract, "depth", depth,
+                              [=]() { return CRRPricer(const_cast<Option*>(option), depth, kS0, kRate, kVol)(); });
+    }
+    for (int depth : powersOfTwo(4, std::min(settings.max_tree_log2, 12))) {
+        harness.deterministic("crr_checkpointed", contract, "depth", depth, [=]() {
+            CRRPricer pricer(const_cast<Option*>(option), depth, kS0, kRate, kVol);
+            pricer.setStorage(CRRStorage::Checkpointed);
+            return pricer();
+        });
+    }
+    VectorizedCRR vectorized;
+    VectorizedCRR truncated(8.0);
+    for (int depth : powersOfTwo(4, settings.max_tree_log2)) {
+        harness.deterministic("vectorized_crr", contract, "depth", depth,
+                              [&, depth]() { return vectorized.price(option, depth, kS0, kRate, kVol); });
+        harness.deterministic("vectorized_crr_trunc8", contract, "depth", depth,
+                              [&, depth]() { return truncated.price(option, depth, kS0, kRate, kVol); });
+    }
+}
+
+void sweepQuadrature(Harness& harness, const Contract& contract) {
+    for (int nodes : {4, 8, 16, 32, 64, 128}) {
+        GaussHermitePricer pricer(nodes);
+        harness.deterministic("gauss_hermite", contract, "nodes", nodes,
+                              [&]() { return pricer.price(contract.option, kS0, kRate, kVol); });
+    }
+}
+
+void sweepMonteCarlo(Harness& harness, const Settings& settings, const Contract& contract) {
+    for (int nb_paths : powersOfTwo(10, settings.max_mc_log2)) {
+        harness.monteCarlo("mc", contract, nb_paths, false);
+        // the block-based standard error needs at least two blocks
+        if (static_cast<std::size_t>(nb_paths) >= 4 * matchedBlockPairs(nb_paths)) {
+            harness.monteCarlo("mc_moment_matched", contract, nb_paths, true);
+        }
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    Settings settings;
+    const char* csv_path = nullptr;
+    const char* json_path = nullptr;
+    for (int a = 1; a < argc; ++a) {
+        if (std::strcmp(argv[a], "--quick") == 0) {
+            settings.quick = true;
+            settings.min_seconds = 0.01;
+            settings.max_mc_log2 = 16;
+            settings.max_tree_log2 = 12;
+            settings.reference_tree_depth = 1 << 13;
+            settings.reference_mc_paths = 1 << 20;
+        } else if (std::strcmp(argv[a], "--csv") == 0 && a + 1 < argc) {
+            csv_path = argv[++a];
+        } else if (std::strcmp(argv[a], "--json") == 0 && a + 1 < argc) {
+            json_path = argv[++a];
+        } else {
+            std::fprintf(stderr, "usage: %s [--quick] [--csv runs.csv] [--json runs.json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    CallOption call(1.0, 100.0);
+    PutOption otm_put(0.5, 85.0);
+    EuropeanDigitalCallOption digital(1.0, 105.0);
+    AmericanPutOption american(1.0, 105.0);
+    std::vector<double> fixings;
+    for (int m = 1; m <= 12; ++m) {
+        fixings.push_back(m / 12.0);
+    }
+    AsianCallOption asian(fixings, 100.0);
+
+    std::vector<Contract> contracts;
+    contracts.push_back({"call_atm_1y", &call, BlackScholesPricer(&call, kS0, kRate, kVol)(), 0.0});
+    contracts.push_back({"put_otm_6m", &otm_put, BlackScholesPricer(&otm_put, kS0, kRate, kVol)(), 0.0});
+    contracts.push_back({"digital_105_1y", &digital, BlackScholesPricer(&digital, kS0, kRate, kVol)(), 0.0});
+    {
+        VectorizedCRR reference;
+        const auto smoothed = [&](int depth) {
+            return 0.5 * (reference.price(&american, depth, kS0, kRate, kVol) + reference.price(&american, depth + 1, kS0, kRate, kVol));
+        };
+        const double coarse = smoothed(settings.reference_tree_depth / 2);
+        const double fine = smoothed(settings.reference_tree_depth);
+        contracts.push_back({"american_put_105_1y", &american, fine, std::fabs(fine - coarse)});
+    }
+    {
+        MT::setEngine(RNGEngine::Xoshiro256pp, 42);
+        BlackScholesMCPricer reference(&asian, kS0, kRate, kVol);
+        reference.setMomentMatching(true, matchedBlockPairs(settings.reference_mc_paths));
+        reference.generate(settings.reference_mc_paths);
+        contracts.push_back({"asian_call_12m", &asian, reference.price(), reference.standardError()});
+        MT::setEngine(RNGEngine::MT19937);
+    }
+    for (const Contract& contract : contracts) {
+        std::printf("reference %-20s %.12f +- %.1e\n", contract.name.c_str(), contract.reference, contract.reference_error);
+    }
+
+    Harness harness(settings);
+    for (const Contract& contract : contracts) {
+        if (contract.option->isAsianOption()) {
+            harness.deterministic("turnbull_wakeman", contract, "fixings", static_cast<long long>(fixings.size()),
+                                  [&]() { return TurnbullWakemanPricer(&asian, kS0, kRate, kVol)(); });
+        } else {
+            sweepTrees(harness, settings, contract);
+            if (!contract.option->isAmericanOption()) {
+                sweepQuadrature(harness, contract);
+            }
+        }
+        if (!contract.option->isAmericanOption()) {
+            sweepMonteCarlo(harness, settings, contract);
+        }
+    }
+    harness.markPareto();
+
+    if (csv_path && !harness.writeCsv(csv_path)) {
+        std::fprintf(stderr, "cannot write %s\n", csv_path);
+        return 1;
+    }
+    if (json_path && !harness.writeJson(json_path, contracts)) {
+        std::fprintf(stderr, "cannot write %s\n", json_path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Single-contract pricing of deep CRR trees on one core: CRRPricer (full trees), a plain
+// scalar rolling induction, VectorizedCRR, and VectorizedCRR truncated at 6 and 8
+// standard deviations.
+//
+//   bench_deep_crr [depth...]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "AmericanPutOption.h"
+#include "CRRPricer.h"
+#include "CallOption.h"
+#include "VectorizedCRR.h"
+
+namespace {
+
+constexpr double kS0 = 100.0;
+constexpr double kRate = 0.03;
+constexpr double kVol = 0.25;
+
+// rolling induction with the payoff called per node, as a scalar reference
+double scalarRolling(const Option& option, int depth) {
+    double U = 0.0;
+    double D = 0.0;
+    double R = 0.0;
+    CRRPricer::treeFactors(option.getExpiry(), depth, kRate, kVol, U, D, R);
+    const double q = (R - D) / (U - D);
+    std::vector<double> values(depth + 1);
+    for (int i = 0; i <= depth; ++i) {
+        values[i] = option.payoff(kS0 * std::pow(U, i) * std::pow(D, depth - i));
+    }
+    for (int n = depth - 1; n >= 0; --n) {
+        for (int i = 0; i <= n; ++i) {
+            const double cont = (q * values[i + 1] + (1.0 - q) * values[i]) / R;
+            const double intrinsic = option.isAmericanOption() ? option.payoff(kS0 * std::pow(U, i) * std::pow(D, n - i)) : 0.0;
+            values[i] = intrinsic >= cont ? intrinsic : cont;
+        }
+    }
+    return values[0];
+}
+
+template <class Price>
+double milliseconds(double& result, Price price) {
+    int runs = 0;
+    const auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        result = price();
+        ++runs;
+        elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 200.0);
+    return elapsed / runs;
+}
+
+void run(const char* label, Option& option, int depth) {
+    VectorizedCRR vectorized;
+    double full = 0.0;
+    double scalar = 0.0;
+    double fast = 0.0;
+    const double t_full = depth <= 10000 ? milliseconds(full, [&]() { return CRRPricer(&option, depth, kS0, kRate, kVol)(); }) : NAN;
+    const double t_scalar = milliseconds(scalar, [&]() { return scalarRolling(option, depth); });
+    const double t_fast = milliseconds(fast, [&]() { return vectorized.price(&option, depth, kS0, kRate, kVol); });
+    std::printf("%-9s depth=%6d CRRPricer=%9.2f ms scalar_rolling=%8.2f ms vectorized=%7.3f ms speedup=%6.1fx diff=%.1e\n", label, depth,
+                t_full, t_scalar, t_fast, (std::isnan(t_full) ? t_scalar : t_full) / t_fast, std::fabs(scalar - fast));
+    for (double k : {6.0, 8.0}) {
+        VectorizedCRR truncated(k);
+        double pruned = 0.0;
+        const double t_pruned = milliseconds(pruned, [&]() { return truncated.price(&option, depth, kS0, kRate, kVol); });
+        std::printf("%-9s depth=%6d truncated(%g sd)=%7.3f ms vs vectorized %5.1fx error=%.1e\n", label, depth, k, t_pruned, t_fast / t_pruned,
+                    std::fabs(pruned - fast));
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> depths;
+    for (int a = 1; a < argc; ++a) {
+        depths.push_back(std::atoi(argv[a]));
+    }
+    if (depths.empty()) {
+        depths = {2000, 5000, 10000, 20000};
+    }
+    AmericanPutOption put(1.0, 105.0);
+    CallOption call(1.0, 95.0);
+    for (int depth : depths) {
+        run("american", put, depth);
+        run("european", call, depth);
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Many short Monte Carlo jobs on heterogeneous contracts: one BlackScholesMCPricer per
+// contract against a single BlackScholesMCBatch holding them all, for European calls and
+// puts on one date and Asian calls on 12 fixings.
+//
+//   bench_mc_batch [nb_contracts] [nb_paths] [mt19937|xoshiro|pcg64|streams]
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "AsianCallOption.h"
+#include "BlackScholesMCBatch.h"
+#include "BlackScholesMCPricer.h"
+#include "CallOption.h"
+#include "MT.h"
+#include "PutOption.h"
+
+namespace {
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void run(const char* label, std::vector<Option*>& options, int nb_paths) {
+    const std::size_t n = options.size();
+    std::vector<double> single(n);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t j = 0; j < n; ++j) {
+        BlackScholesMCPricer pricer(options[j], 80.0 + 0.1 * (j % 400), 0.01 + 0.001 * (j % 40), 0.1 + 0.002 * (j % 150));
+        pricer.generate(nb_paths);
+        single[j] = pricer.price();
+    }
+    const double single_s = seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    BlackScholesMCBatch batch;
+    batch.reserve(n);
+    for (std::size_t j = 0; j < n; ++j) {
+        batch.add(options[j], 80.0 + 0.1 * (j % 400), 0.01 + 0.001 * (j % 40), 0.1 + 0.002 * (j % 150));
+    }
+    batch.generate(nb_paths);
+    const double batch_s = seconds(start);
+
+    double diff = 0.0;
+    for (std::size_t j = 0; j < n; ++j) {
+        diff += std::fabs(batch.price(j) - single[j]);
+    }
+    const double paths = static_cast<double>(n) * nb_paths;
+    std::printf("%-8s contracts=%zu paths=%d single=%7.2f Mpath/s batch=%7.2f Mpath/s speedup=%5.2fx mean_abs_diff=%.3f\n", label, n,
+                nb_paths, paths / single_s / 1e6, paths / batch_s / 1e6, single_s / batch_s, diff / n);
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const int nb_paths = argc > 2 ? std::atoi(argv[2]) : 4000;
+    const char* engine = argc > 3 ? argv[3] : "mt19937";
+    if (std::strcmp(engine, "xoshiro") == 0) {
+        MT::setEngine(RNGEngine::Xoshiro256pp, 1);
+    } else if (std::strcmp(engine, "pcg64") == 0) {
+        MT::setEngine(RNGEngine::PCG64, 1);
+    } else if (std::strcmp(engine, "streams") == 0) {
+        MT::setEngine(RNGEngine::Xoshiro256ppStreams, 1);
+    } else {
+        MT::setEngine(RNGEngine::MT19937, 1);
+    }
+
+    std::vector<CallOption> calls;
+    std::vector<PutOption> puts;
+    std::vector<AsianCallOption> asians;
+    std::vector<double> fixings;
+    for (int k = 1; k <= 12; ++k) {
+        fixings.push_back(k / 12.0);
+    }
+    for (std::size_t j = 0; j < n; ++j) {
+        const double expiry = 0.25 + 0.25 * (j % 8);
+        const double strike = 80.0 + 0.5 * (j % 80);
+        calls.emplace_back(expiry, strike);
+        puts.emplace_back(expiry, strike);
+        asians.emplace_back(fixings, strike);
+    }
+    std::vector<Option*> vanilla;
+    std::vector<Option*> asian;
+    for (std::size_t j = 0; j < n; ++j) {
+        vanilla.push_back(j % 2 == 0 ? static_cast<Option*>(&calls[j]) : static_cast<Option*>(&puts[j]));
+        asian.push_back(&asians[j]);
+    }
+    run("vanilla", vanilla, nb_paths);
+    run("asian", asian, nb_paths);
+    return 0;
+}
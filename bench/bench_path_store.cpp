@@ -0,0 +1,107 @@
+// Cost of writing every simulated path to a PathStore: a 12-fixing Asian call simulated
+// with and without a store attached, the size of the file, and the time to reprice the
+// option from the file instead of re-simulating. A pricer runs on every core (or on the
+// given number of threads), each with its own store, so the encoding threads of the
+// stores compete with the pricers for the cores: the overhead in wall time and in CPU
+// time of the whole process is what the stores cost a machine that is fully busy.
+//
+//   bench_path_store [nb_paths per thread] [file prefix] [threads]
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AsianCallOption.h"
+#include "BlackScholesMCPricer.h"
+#include "MT.h"
+#include "PathStore.h"
+
+namespace {
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double processCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + 1e-9 * static_cast<double>(ts.tv_nsec);
+}
+
+struct Run {
+    double wall;
+    double cpu;
+    std::vector<double> prices;
+    double bytes;
+};
+
+// one pricer per thread, seeded by its thread index, writing to prefix.<thread> if store
+Run simulate(AsianCallOption& option, int nb_paths, unsigned threads, const std::string& prefix, bool store) {
+    Run run{0.0, 0.0, std::vector<double>(threads), 0.0};
+    std::vector<double> bytes(threads);
+    const auto start = std::chrono::steady_clock::now();
+    const double cpu = processCpuSeconds();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            MT::setEngine(RNGEngine::Xoshiro256pp, 5 + t);
+            BlackScholesMCPricer pricer(&option, 100.0, 0.03, 0.2);
+            if (store) {
+                PathStoreWriter writer(prefix + "." + std::to_string(t), option.getTimeSteps());
+                pricer.setPathStore(&writer);
+                pricer.generate(nb_paths);
+                writer.finish();
+                bytes[t] = static_cast<double>(writer.getBytesWritten());
+            } else {
+                pricer.generate(nb_paths);
+            }
+            run.prices[t] = pricer.price();
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    run.wall = seconds(start);
+    run.cpu = processCpuSeconds() - cpu;
+    for (double b : bytes) {
+        run.bytes += b;
+    }
+    return run;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const int nb_paths = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    const std::string prefix = argc > 2 ? argv[2] : "bench_path_store.bin";
+    const unsigned threads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<double> fixings;
+    for (int m = 1; m <= 12; ++m) {
+        fixings.push_back(m / 12.0);
+    }
+    AsianCallOption option(fixings, 100.0);
+
+    const Run plain = simulate(option, nb_paths, threads, prefix, false);
+    const Run stored = simulate(option, nb_paths, threads, prefix, true);
+
+    const auto start = std::chrono::steady_clock::now();
+    PathStore store(prefix + ".0");
+    const double replayed = store.price(option, 0.03);
+    const double t_replay = seconds(start);
+    for (unsigned t = 0; t < threads; ++t) {
+        std::remove((prefix + "." + std::to_string(t)).c_str());
+    }
+
+    const double spots = 12.0 * nb_paths * threads;
+    std::printf("%u threads, %d paths each\n", threads, nb_paths);
+    std::printf("simulate        %8.3f s  (CPU %.3f s)  price %.12f\n", plain.wall, plain.cpu, plain.prices[0]);
+    std::printf("simulate+store  %8.3f s  (CPU %.3f s)  price %.12f\n", stored.wall, stored.cpu, stored.prices[0]);
+    std::printf("overhead        %7.1f%% wall, %.1f%% CPU, %.2f ns of CPU per spot  %.1f MB, %.1f bits per spot\n",
+                100.0 * (stored.wall / plain.wall - 1.0), 100.0 * (stored.cpu / plain.cpu - 1.0), 1e9 * (stored.cpu - plain.cpu) / spots,
+                stored.bytes / 1e6, 8.0 * stored.bytes / spots);
+    std::printf("replay          %8.3f s  price %.12f  %s\n", t_replay, replayed, replayed == plain.prices[0] ? "identical" : "DIFFERENT");
+    return replayed == plain.prices[0] && stored.prices == plain.prices ? 0 : 1;
+}
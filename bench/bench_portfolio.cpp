@@ -0,0 +1,77 @@
+// Throughput on a synthetic book drawn by PortfolioGenerator with its default mix: load
+// into an OptionBook, closed-form batch over the Europeans, VectorizedCRR over the
+// Americans and a BlackScholesMCBatch over everything but the Americans. Optionally writes
+// the book as CSV for other tools.
+//
+//   bench_portfolio [nb_trades] [seed] [book.csv]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include "BlackScholesBatch.h"
+#include "BlackScholesMCBatch.h"
+#include "OptionBook.h"
+#include "PortfolioGenerator.h"
+#include "VectorizedCRR.h"
+
+namespace {
+
+constexpr int kTreeDepth = 200;
+constexpr int kPaths = 100;
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t nb_trades = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const std::uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+
+    auto start = std::chrono::steady_clock::now();
+    PortfolioGenerator generator;
+    generator.generate(nb_trades, seed);
+    std::printf("generate      %8zu trades            %8.3f s\n", nb_trades, seconds(start));
+    if (argc > 3) {
+        std::ofstream csv(argv[3]);
+        generator.writeCsv(csv);
+    }
+
+    start = std::chrono::steady_clock::now();
+    OptionBook book;
+    generator.fill(book);
+    std::printf("book load     %8zu options           %8.3f s\n", book.size(), seconds(start));
+
+    BlackScholesBatchInput input;
+    const std::vector<std::size_t> rows = generator.fill(input);
+    std::vector<double> prices;
+    start = std::chrono::steady_clock::now();
+    BlackScholesBatch::price(input, prices);
+    double elapsed = seconds(start);
+    std::printf("closed form   %8zu europeans         %8.3f s  %10.0f /s\n", rows.size(), elapsed, rows.size() / elapsed);
+
+    VectorizedCRR crr;
+    std::size_t americans = 0;
+    double total = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < generator.trades().size(); ++i) {
+        const SyntheticTrade& t = generator.trades()[i];
+        if (t.kind == ProductKind::American) {
+            const MarketQuote& q = generator.market()[t.underlying];
+            total += crr.price(book[i], kTreeDepth, q.spot, q.rate, q.volatility);
+            ++americans;
+        }
+    }
+    elapsed = seconds(start);
+    std::printf("crr depth %d %7zu americans         %8.3f s  %10.0f /s\n", kTreeDepth, americans, elapsed, americans / elapsed);
+
+    BlackScholesMCBatch batch;
+    const std::vector<std::size_t> contracts = generator.fill(batch, book);
+    start = std::chrono::steady_clock::now();
+    batch.generate(kPaths);
+    elapsed = seconds(start);
+    std::printf("mc %d paths %8zu contracts         %8.3f s  %10.0f /s\n", kPaths, contracts.size(), elapsed, contracts.size() / elapsed);
+    return total > 0.0 ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+// Throughput of uniform and normal draws: the MT19937 engine behind MT one value at a
+// time (the previous only path), then the bulk fills of every engine through MT. The
+// interleaved streams need an AVX2 build (-DCMAKE_CXX_FLAGS=-march=native) to pay off.
+//
+//   bench_rng [nb_values]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "MT.h"
+
+namespace {
+
+template <class Fill>
+double millionsPerSecond(std::vector<double>& out, double& checksum, Fill fill) {
+    const auto start = std::chrono::steady_clock::now();
+    fill(out.data(), out.size());
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (double v : out) {
+        checksum += v;
+    }
+    return out.size() / seconds / 1e6;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000000;
+    std::vector<double> out(n);
+    double checksum = 0.0;
+
+    MT::setEngine(RNGEngine::MT19937, 1);
+    const double unif_single = millionsPerSecond(out, checksum, [](double* o, std::size_t m) {
+        for (std::size_t i = 0; i < m; ++i) {
+            o[i] = MT::rand_unif();
+        }
+    });
+    const double norm_single = millionsPerSecond(out, checksum, [](double* o, std::size_t m) {
+        for (std::size_t i = 0; i < m; ++i) {
+            o[i] = MT::rand_norm();
+        }
+    });
+    std::printf("%-22s uniform=%7.1f M/s normal=%7.1f M/s\n", "mt19937 rand_*", unif_single, norm_single);
+
+    const struct {
+        const char* label;
+        RNGEngine engine;
+    } engines[] = {{"mt19937 fill", RNGEngine::MT19937},
+                   {"xoshiro256++ fill", RNGEngine::Xoshiro256pp},
+                   {"pcg64 fill", RNGEngine::PCG64},
+                   {"xoshiro256++ x4 fill", RNGEngine::Xoshiro256ppStreams}};
+    for (const auto& e : engines) {
+        MT::setEngine(e.engine, 1);
+        const double unif = millionsPerSecond(out, checksum, MT::fill_uniform);
+        const double norm = millionsPerSecond(out, checksum, MT::fill_normal);
+        std::printf("%-22s uniform=%7.1f M/s normal=%7.1f M/s (x%.1f, x%.1f)\n", e.label, unif, norm, unif / unif_single, norm / norm_single);
+    }
+    std::printf("checksum %.3f\n", checksum);
+    return 0;
+}
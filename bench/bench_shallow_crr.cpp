@@ -0,0 +1,63 @@
+// Throughput of shallow CRR trees: generic CRRPricer against the compile-time depth
+// kernels of FixedDepthCRR, for American puts and European calls.
+//
+//   bench_shallow_crr [nb_options]
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "AmericanPutOption.h"
+#include "CRRPricer.h"
+#include "CallOption.h"
+#include "FixedDepthCRR.h"
+
+namespace {
+
+template <class Price>
+double millionsPerSecond(std::size_t n, double& checksum, Price price) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t j = 0; j < n; ++j) {
+        checksum += price(j);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return n / seconds / 1e6;
+}
+
+template <class O>
+void run(const char* label, const std::vector<O>& options, int depth) {
+    const double S0 = 100.0;
+    const double r = 0.03;
+    const double vol = 0.25;
+    double generic_sum = 0.0;
+    double fixed_sum = 0.0;
+    CRRPricer pricer;
+    const double generic = millionsPerSecond(options.size(), generic_sum, [&](std::size_t j) {
+        pricer.reconfigure(const_cast<O*>(&options[j]), depth, S0, r, vol);
+        return pricer();
+    });
+    const double fixed = millionsPerSecond(options.size(), fixed_sum, [&](std::size_t j) {
+        return FixedDepthCRR::price(&options[j], depth, S0, r, vol);
+    });
+    std::printf("%-9s depth=%2d generic=%7.3f Mopt/s fixed=%7.3f Mopt/s speedup=%5.2fx mean_diff=%.1e\n", label, depth, generic, fixed,
+                fixed / generic, std::abs(generic_sum - fixed_sum) / options.size());
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::vector<AmericanPutOption> puts;
+    std::vector<CallOption> calls;
+    for (std::size_t j = 0; j < n; ++j) {
+        const double expiry = 0.25 + 0.5 * (j % 7);
+        const double strike = 80.0 + 0.5 * (j % 80);
+        puts.emplace_back(expiry, strike);
+        calls.emplace_back(expiry, strike);
+    }
+    for (int depth : {3, 8, 16, 32, 64}) {
+        run("american", puts, depth);
+        run("european", calls, depth);
+    }
+    return 0;
+}
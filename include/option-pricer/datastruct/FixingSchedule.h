@@ -0,0 +1,95 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+/// Ordered fixing dates of a path-dependent option.
+///
+/// Schedules of up to kInlineCapacity dates live inline in the object, so the
+/// common monthly or weekly schedules need no allocation at all. Longer
+/// schedules spill to a std::pmr::vector drawing from the allocator given at
+/// construction, so a whole book can be built in one arena.
+class FixingSchedule {
+public:
+  static constexpr std::size_t kInlineCapacity = 24;
+  using allocator_type = std::pmr::polymorphic_allocator<double>;
+
+  FixingSchedule() : FixingSchedule(allocator_type()) {}
+  explicit FixingSchedule(const allocator_type& alloc) : _size(0), _alloc(alloc) {}
+
+  FixingSchedule(const double* first, const double* last, const allocator_type& alloc = allocator_type())
+      : _size(0), _alloc(alloc) {
+    assign(first, last);
+  }
+
+  FixingSchedule(const FixingSchedule& other, const allocator_type& alloc = allocator_type())
+      : _size(0), _alloc(alloc) {
+    assign(other.begin(), other.end());
+  }
+
+  FixingSchedule& operator=(const FixingSchedule& other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  ~FixingSchedule() { release(); }
+
+  /// Replace the dates by [first, last).
+  void assign(const double* first, const double* last) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n > kInlineCapacity) {
+      double* heap = _alloc.allocate(n);
+      std::copy(first, last, heap);
+      release();
+      _storage.heap = heap;
+    } else {
+      release();
+      std::copy(first, last, _storage.local);
+    }
+    _size = n;
+  }
+
+  std::size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  bool isInline() const { return _size <= kInlineCapacity; }
+
+  const double* data() const { return isInline() ? _storage.local : _storage.heap; }
+  const double* begin() const { return data(); }
+  const double* end() const { return data() + _size; }
+
+  double operator[](std::size_t i) const { return data()[i]; }
+
+  /// @throws std::out_of_range if the schedule is empty.
+  double back() const {
+    if (_size == 0) {
+      throw std::out_of_range("FixingSchedule: empty schedule");
+    }
+    return data()[_size - 1];
+  }
+
+  std::vector<double> toVector() const { return std::vector<double>(begin(), end()); }
+
+  allocator_type get_allocator() const { return _alloc; }
+
+private:
+  // a spilled schedule reuses the inline bytes for its pointer
+  union Storage {
+    double local[kInlineCapacity];
+    double* heap;
+  };
+
+  void release() {
+    if (!isInline()) {
+      _alloc.deallocate(_storage.heap, _size);
+    }
+    _size = 0;
+  }
+
+  std::size_t _size;
+  allocator_type _alloc;
+  Storage _storage;
+};
@@ -0,0 +1,291 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Storage policy of a Lattice.
+///
+/// FullHistory keeps every level, as needed to read the tree after the
+/// induction (exercise boundary, display). Rolling keeps two rows only:
+/// level n lives in row n % 2, so a backward induction reads level n + 1 and
+/// writes level n in O(width) memory.
+enum class LatticeMode { FullHistory, Rolling };
+
+/// Contiguous, non-owning view of one lattice row.
+template <class T>
+class LatticeRow {
+public:
+  LatticeRow(T* data, std::size_t size) : _data(data), _size(size) {}
+
+  T* data() const { return _data; }
+  std::size_t size() const { return _size; }
+  T* begin() const { return _data; }
+  T* end() const { return _data + _size; }
+  T& operator[](std::size_t i) const { return _data[i]; }
+
+private:
+  T* _data;
+  std::size_t _size;
+};
+
+/// Recombining lattice with Branching children per node.
+///
+/// Level n holds n * (Branching - 1) + 1 nodes: n + 1 for a binomial tree,
+/// 2n + 1 for a trinomial one. All levels live in one flat buffer aligned on
+/// kAlignment bytes, and every row starts on an aligned boundary with its
+/// width padded to a whole number of kAlignment bytes, so that a kernel can
+/// run full-width vector loads over a row. The padding is value-initialised
+/// and never read by the checked accessors.
+///
+/// setNode and getNode check their indices; node() and row() do not and
+/// compile to a plain indexed load.
+template <class T, int Branching>
+class Lattice {
+  static_assert(Branching >= 2, "Lattice: branching must be at least 2");
+
+public:
+  static constexpr std::size_t kAlignment = 64;
+
+  Lattice() : _depth(0), _mode(LatticeMode::FullHistory) { setDepth(0); }
+  explicit Lattice(int depth, LatticeMode mode = LatticeMode::FullHistory) : _depth(0), _mode(mode) {
+    setDepth(depth);
+  }
+
+  Lattice(const Lattice& other) : _depth(0), _mode(other._mode) {
+    setDepth(other._depth);
+    std::copy(other._buffer.get(), other._buffer.get() + _used, _buffer.get());
+  }
+
+  Lattice& operator=(const Lattice& other) {
+    if (this != &other) {
+      _mode = other._mode;
+      setDepth(other._depth);
+      std::copy(other._buffer.get(), other._buffer.get() + _used, _buffer.get());
+    }
+    return *this;
+  }
+
+  ~Lattice() { destroy(); }
+
+  /// Exchange the nodes, depth, mode and buffers of two lattices without copying.
+  void swap(Lattice& other) noexcept {
+    std::swap(_depth, other._depth);
+    std::swap(_mode, other._mode);
+    _offsets.swap(other._offsets);
+    _buffer.swap(other._buffer);
+    std::swap(_capacity, other._capacity);
+    std::swap(_used, other._used);
+  }
+
+  static constexpr int branching() { return Branching; }
+
+  /// Number of nodes of level n.
+  static constexpr int width(int n) { return n * (Branching - 1) + 1; }
+
+  /// Set the depth of the lattice.
+  ///
+  /// All nodes are reset to T(). The buffer is never released when the
+  /// lattice shrinks, so going back to a depth (or mode) the lattice has
+  /// had before does not allocate.
+  ///
+  /// @param depth the number of levels in the lattice, less one.
+  ///
+  /// @throws std::invalid_argument if depth < 0.
+  void setDepth(int depth) {
+    if (depth < 0) {
+      throw std::invalid_argument("Lattice: depth must be >= 0");
+    }
+    _depth = depth;
+    const int rows = _mode == LatticeMode::Rolling ? std::min(2, _depth + 1) : _depth + 1;
+    _offsets.resize(rows + 1);
+    _offsets[0] = 0;
+    for (int n = 0; n < rows; ++n) {
+      const int w = _mode == LatticeMode::Rolling ? width(_depth) : width(n);
+      _offsets[n + 1] = _offsets[n] + padded(static_cast<std::size_t>(w));
+    }
+    reserve(_offsets[rows]);
+    _used = _offsets[rows];
+    std::fill(_buffer.get(), _buffer.get() + _used, T());
+  }
+
+  /// Set the depth to 0 and give the buffer back to the heap.
+  void release() {
+    destroy();
+    setDepth(0);
+  }
+
+  /// Switch between full-history and rolling storage; resets the nodes.
+  void setMode(LatticeMode mode) {
+    _mode = mode;
+    setDepth(_depth);
+  }
+
+  int depth() const { return _depth; }
+  LatticeMode mode() const { return _mode; }
+
+  /// Set a node in the lattice.
+  ///
+  /// @param n the level of the lattice (0 <= n <= depth()).
+  /// @param i the index of the node in the level (0 <= i < width(n)).
+  /// @param value the value to be stored in the node.
+  ///
+  /// @throws std::out_of_range if n or i are out of range.
+  void setNode(int n, int i, const T& value) {
+    checkIndices(n, i);
+    node(n, i) = value;
+  }
+
+  /// @brief Get a node in the lattice.
+  ///
+  /// In rolling mode, level n reads whatever was last written to row n % 2.
+  ///
+  /// @param n the level of the lattice (0 <= n <= depth()).
+  /// @param i the index of the node in the level (0 <= i < width(n)).
+  ///
+  /// @return the value stored in the node.
+  ///
+  /// @throws std::out_of_range if n or i are out of range.
+  T getNode(int n, int i) const {
+    checkIndices(n, i);
+    return node(n, i);
+  }
+
+  /// Unchecked access to node i of level n.
+  T& node(int n, int i) { return _buffer.get()[_offsets[slot(n)] + i]; }
+  const T& node(int n, int i) const { return _buffer.get()[_offsets[slot(n)] + i]; }
+
+  /// Unchecked view of the width(n) nodes of level n, aligned on kAlignment.
+  LatticeRow<T> row(int n) { return LatticeRow<T>(_buffer.get() + _offsets[slot(n)], width(n)); }
+  LatticeRow<const T> row(int n) const { return LatticeRow<const T>(_buffer.get() + _offsets[slot(n)], width(n)); }
+
+  /// Display the lattice in a formatted manner.
+  ///
+  /// The lattice is displayed with each level on a separate line,
+  /// and each node is separated by a space. Binomial lattices also show
+  /// the branches between levels. A rolling lattice only shows its last
+  /// two levels.
+  ///
+  /// @param os the output stream to write to (default is std::cout).
+  void display(std::ostream& os = std::cout) const {
+    int nodeWidth = static_cast<int>(valueWidth());
+    int gap = nodeWidth + 2;
+    if (gap % 2 != 0) {
+      gap += 1;
+    }
+
+    const int first = _mode == LatticeMode::Rolling ? std::max(0, _depth - 1) : 0;
+    int indent = 0;
+    int pad = 0;
+    int connIndent = 0;
+    std::ostringstream ss;
+    std::string val;
+
+    for (int n = first; n <= _depth; ++n) {
+      indent = static_cast<int>((width(_depth) - width(n)) * (gap / 2.0));
+      os << std::string(indent, ' ');
+
+      const int w = width(n);
+      for (int i = 0; i < w; ++i) {
+        ss.str("");
+        ss.clear();
+        ss << node(n, i);
+        val = ss.str();
+        pad = gap - static_cast<int>(val.size());
+        if (pad < 1) pad = 1;
+        os << val;
+        if (i < w - 1) {
+          os << std::string(pad, ' ');
+        }
+      }
+      os << '\n';
+
+      if (Branching == 2 && n < _depth) {
+        connIndent = indent - 1;
+        if (connIndent < 0) connIndent = 0;
+        os << std::string(connIndent, ' ');
+        for (int i = 0; i < w; ++i) {
+          os << "/ \\";
+          if (i < w - 1) {
+            os << std::string(gap - 3, ' ');
+          }
+        }
+        os << '\n';
+      }
+    }
+  }
+
+private:
+  struct AlignedDelete {
+    void operator()(T* p) const { ::operator delete(p, std::align_val_t(kAlignment)); }
+  };
+
+  int _depth;
+  LatticeMode _mode;
+  std::vector<std::size_t> _offsets;
+  std::unique_ptr<T, AlignedDelete> _buffer;
+  std::size_t _capacity = 0;
+  std::size_t _used = 0;
+
+  int slot(int n) const { return _mode == LatticeMode::Rolling ? (n & 1) : n; }
+
+  /// Round a row width up to a whole number of kAlignment bytes.
+  static std::size_t padded(std::size_t w) {
+    const std::size_t per_line = std::max<std::size_t>(1, kAlignment / sizeof(T));
+    return (w + per_line - 1) / per_line * per_line;
+  }
+
+  /// Grow the buffer to hold at least n elements, never shrinking it.
+  void reserve(std::size_t n) {
+    if (n <= _capacity) {
+      return;
+    }
+    destroy();
+    T* p = static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kAlignment)));
+    std::uninitialized_value_construct_n(p, n);
+    _buffer.reset(p);
+    _capacity = n;
+  }
+
+  void destroy() {
+    if (_buffer) {
+      std::destroy_n(_buffer.get(), _capacity);
+      _buffer.reset();
+      _capacity = 0;
+    }
+  }
+
+  /// @brief Check if the indices are valid.
+  ///
+  /// @param n the level of the lattice (0 <= n <= depth()).
+  /// @param i the index of the node in the level (0 <= i < width(n)).
+  ///
+  /// @throws std::out_of_range if n or i are out of range.
+  void checkIndices(int n, int i) const {
+    if (n < 0 || n > _depth) throw std::out_of_range("Lattice: n out of range");
+    if (i < 0 || i >= width(n)) throw std::out_of_range("Lattice: i out of range");
+  }
+
+  /// @brief Compute the maximum width of the values in the displayed levels.
+  ///
+  /// @return The maximum width of the values when converted to a string.
+  std::size_t valueWidth() const {
+    std::size_t w = 1;
+    const int first = _mode == LatticeMode::Rolling ? std::max(0, _depth - 1) : 0;
+    for (int n = first; n <= _depth; ++n) {
+      for (const auto& v : row(n)) {
+        std::ostringstream ss;
+        ss << v;
+        const std::size_t len = ss.str().size();
+        if (len > w) w = len;
+      }
+    }
+    return w;
+  }
+};
@@ -0,0 +1,221 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "Lattice.h"
+
+/// Streaming export and import of full-history lattices.
+///
+/// Every writer makes a single pass over the rows and formats into a fixed
+/// stack buffer, so the extra memory does not depend on the depth. Formats:
+///
+/// - binary: a 24-byte header (magic "OPLT", version, branching, depth,
+///   sizeof(T), reserved) followed by the rows, level 0 first, as raw native
+///   values without the row padding. readBinary() reloads it.
+/// - CSV: one "level,index,value" line per node, numbers written with
+///   std::to_chars (shortest round-trip form for floating point).
+/// - DOT: a Graphviz digraph keeping at most max_levels levels and
+///   max_nodes nodes per level; edges join each kept node to the kept nodes
+///   it can reach on the next kept level.
+class LatticeIO {
+public:
+  LatticeIO() = delete;
+
+  static constexpr std::uint32_t kVersion = 1;
+
+  /// @throws std::invalid_argument if the lattice is rolling.
+  /// @throws std::runtime_error if the stream fails.
+  template <class T, int Branching>
+  static void writeBinary(const Lattice<T, Branching>& lattice, std::ostream& os) {
+    static_assert(std::is_trivially_copyable<T>::value, "LatticeIO: binary dumps need trivially copyable nodes");
+    checkFullHistory(lattice);
+    const std::uint32_t header[6] = {kMagic, kVersion, static_cast<std::uint32_t>(Branching),
+                                     static_cast<std::uint32_t>(lattice.depth()), static_cast<std::uint32_t>(sizeof(T)), 0};
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (int n = 0; n <= lattice.depth(); ++n) {
+      const auto row = lattice.row(n);
+      os.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(T)));
+    }
+    checkStream(os);
+  }
+
+  /// Reload a binary dump, resizing the lattice to the dumped depth in full-history mode.
+  ///
+  /// The dumped depth is checked before anything is allocated: it must fit an int, and
+  /// the rows it implies must fit in the bytes left in the stream when the stream can
+  /// seek (a non-seekable stream is only checked when it runs out). The dump is read
+  /// into a new lattice that replaces the given one only once every row is read, so on
+  /// error the lattice is left unchanged.
+  ///
+  /// @throws std::invalid_argument if the stream does not hold a dump of a
+  /// Lattice<T, Branching>, or is truncated.
+  template <class T, int Branching>
+  static void readBinary(std::istream& is, Lattice<T, Branching>& lattice) {
+    static_assert(std::is_trivially_copyable<T>::value, "LatticeIO: binary dumps need trivially copyable nodes");
+    std::uint32_t header[6] = {};
+    if (!is.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != kMagic) {
+      throw std::invalid_argument("LatticeIO: not a lattice dump");
+    }
+    if (header[1] != kVersion || header[2] != static_cast<std::uint32_t>(Branching) || header[4] != sizeof(T)) {
+      throw std::invalid_argument("LatticeIO: dump does not match the lattice type");
+    }
+    // in floating point, so that a corrupt depth cannot wrap the byte count around
+    const double depth = header[3];
+    const double bytes = ((depth + 1.0) + (Branching - 1.0) * depth * (depth + 1.0) / 2.0) * sizeof(T);
+    if (header[3] > static_cast<std::uint32_t>(std::numeric_limits<int>::max()) || bytes > bytesLeft(is)) {
+      throw std::invalid_argument("LatticeIO: truncated lattice dump");
+    }
+    Lattice<T, Branching> loaded(static_cast<int>(header[3]));
+    for (int n = 0; n <= loaded.depth(); ++n) {
+      auto row = loaded.row(n);
+      if (!is.read(reinterpret_cast<char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(T)))) {
+        throw std::invalid_argument("LatticeIO: truncated lattice dump");
+      }
+    }
+    lattice.swap(loaded);
+  }
+
+  /// @throws std::invalid_argument if the lattice is rolling.
+  /// @throws std::runtime_error if the stream fails.
+  template <class T, int Branching>
+  static void writeCsv(const Lattice<T, Branching>& lattice, std::ostream& os) {
+    checkFullHistory(lattice);
+    char buffer[kBufferSize];
+    char* cursor = buffer;
+    os << "level,index,value\n";
+    for (int n = 0; n <= lattice.depth(); ++n) {
+      const auto row = lattice.row(n);
+      for (std::size_t i = 0; i < row.size(); ++i) {
+        if (buffer + kBufferSize - cursor < kMaxLine) {
+          os.write(buffer, cursor - buffer);
+          cursor = buffer;
+        }
+        // each field is far shorter than kMaxLine / 3, separators included
+        const std::ptrdiff_t field = kMaxLine / 3;
+        cursor = format(cursor, cursor + field - 1, n);
+        *cursor++ = ',';
+        cursor = format(cursor, cursor + field - 1, i);
+        *cursor++ = ',';
+        cursor = format(cursor, cursor + field - 1, row[i]);
+        *cursor++ = '\n';
+      }
+    }
+    os.write(buffer, cursor - buffer);
+    checkStream(os);
+  }
+
+  /// @param max_levels the number of levels kept, at least 2 (the first and last level are always kept).
+  /// @param max_nodes the number of nodes kept per level, at least 2 (the two extreme nodes are always kept).
+  ///
+  /// @throws std::invalid_argument if the lattice is rolling or a limit is below 2.
+  /// @throws std::runtime_error if the stream fails.
+  template <class T, int Branching>
+  static void writeDot(const Lattice<T, Branching>& lattice, std::ostream& os, int max_levels = 32, int max_nodes = 32) {
+    checkFullHistory(lattice);
+    if (max_levels < 2 || max_nodes < 2) {
+      throw std::invalid_argument("LatticeIO: DOT limits must be at least 2");
+    }
+    const int depth = lattice.depth();
+    const int level_stride = std::max(1, (depth + max_levels - 2) / (max_levels - 1));
+    char value[kMaxLine];
+
+    os << "digraph lattice {\n  rankdir=LR;\n  node [shape=box, fontsize=10];\n";
+    for (int n = 0; n <= depth; n = nextKept(n, level_stride, depth)) {
+      const auto row = lattice.row(n);
+      const int width = static_cast<int>(row.size());
+      const int node_stride = stride(width, max_nodes);
+      for (int i = 0; i < width; i = nextKept(i, node_stride, width - 1)) {
+        char* end = format(value, value + kMaxLine, row[i]);
+        os << "  n" << n << '_' << i << " [label=\"" << std::string(value, end) << "\"];\n";
+      }
+      if (n == depth) {
+        break;
+      }
+      // (n, i) reaches (m, i) .. (m, i + (Branching - 1) * (m - n))
+      const int m = nextKept(n, level_stride, depth);
+      const int next_width = Lattice<T, Branching>::width(m);
+      const int next_stride = stride(next_width, max_nodes);
+      const int reach = (Branching - 1) * (m - n);
+      for (int i = 0; i < width; i = nextKept(i, node_stride, width - 1)) {
+        for (int j = firstKeptFrom(i, next_stride, next_width - 1); j <= i + reach; j = nextKept(j, next_stride, next_width - 1)) {
+          os << "  n" << n << '_' << i << " -> n" << m << '_' << j << ";\n";
+        }
+      }
+    }
+    os << "}\n";
+    checkStream(os);
+  }
+
+private:
+  static constexpr std::uint32_t kMagic = 0x544c504f;  // "OPLT" little-endian
+  static constexpr std::size_t kBufferSize = 1 << 16;
+  static constexpr std::ptrdiff_t kMaxLine = 96;
+
+  template <class T>
+  static char* format(char* first, char* last, const T& v) {
+    if constexpr (std::is_same<T, bool>::value) {
+      *first = v ? '1' : '0';
+      return first + 1;
+    } else {
+      return std::to_chars(first, last, v).ptr;
+    }
+  }
+
+  /// Stride keeping at most max_count of count indices, both ends included.
+  static int stride(int count, int max_count) {
+    return count <= max_count ? 1 : (count - 1 + max_count - 2) / (max_count - 1);
+  }
+
+  /// Next kept index after k: k + stride, clamped to last; one past last once last is reached.
+  static int nextKept(int k, int stride, int last) {
+    if (k >= last) {
+      return last + 1;
+    }
+    return std::min(k + stride, last);
+  }
+
+  /// Smallest kept index >= k.
+  static int firstKeptFrom(int k, int stride, int last) {
+    return std::min((k + stride - 1) / stride * stride, last);
+  }
+
+  /// Bytes between the read position and the end of the stream; the largest streamsize
+  /// if the stream cannot seek.
+  static double bytesLeft(std::istream& is) {
+    const double unknown = static_cast<double>(std::numeric_limits<std::streamsize>::max());
+    const std::istream::pos_type here = is.tellg();
+    if (here == std::istream::pos_type(-1)) {
+      is.clear();
+      return unknown;
+    }
+    is.seekg(0, std::ios::end);
+    const std::istream::pos_type end = is.tellg();
+    is.clear();
+    is.seekg(here);
+    if (end == std::istream::pos_type(-1) || !is) {
+      is.clear();
+      return unknown;
+    }
+    return static_cast<double>(end - here);
+  }
+
+  template <class T, int Branching>
+  static void checkFullHistory(const Lattice<T, Branching>& lattice) {
+    if (lattice.mode() != LatticeMode::FullHistory) {
+      throw std::invalid_argument("LatticeIO: a rolling lattice only holds two levels");
+    }
+  }
+
+  static void checkStream(const std::ostream& os) {
+    if (!os) {
+      throw std::runtime_error("LatticeIO: write failed");
+    }
+  }
+};
@@ -0,0 +1,32 @@
+#ifndef SABRMODEL_H
+#define SABRMODEL_H
+
+#include <cstddef>
+#include <vector>
+#include "Option.h"
+
+class SABRModel {
+private:
+    double _alpha;
+    double _beta;
+    double _rho;
+    double _nu;
+public:
+    SABRModel(double alpha, double beta, double rho, double nu);
+
+    double getAlpha() const;
+    double getBeta() const;
+    double getRho() const;
+    double getNu() const;
+
+    double impliedVolatility(double forward, double strike, double expiry) const;
+    void impliedVolatilities(double forward, double expiry, const double* strikes, double* vols, std::size_t n) const;
+    std::vector<double> impliedVolatilities(double forward, double expiry, const std::vector<double>& strikes) const;
+    void jacobian(double forward, double strike, double expiry, double& vol, double grad[3]) const;
+
+    std::vector<double> priceChain(double spot, double interest_rate, double expiry, const std::vector<double>& strikes, const std::vector<OptionType>& types) const;
+
+    static SABRModel calibrate(double forward, double expiry, const std::vector<double>& strikes, const std::vector<double>& market_vols, double beta, double* rmse = nullptr);
+};
+
+#endif
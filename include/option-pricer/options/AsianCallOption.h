@@ -8,7 +8,9 @@ private:
     double _strike;
 public:
     AsianCallOption(std::vector<double> timeSteps, double strike);
+    AsianCallOption(const std::vector<double>& timeSteps, double strike, const allocator_type& alloc);
     double payoff(double asset_price) const override;
+    double getStrike() const;
     OptionType getOptionType() const override;
 };
 
@@ -1,14 +1,25 @@
 #ifndef ASIANOPTION_H
 #define ASIANOPTION_H
 #include "EuropeanVanillaOption.h"
+#include "FixingSchedule.h"
 #include <vector>
 
 class AsianOption : public Option {
 private:
-    std::vector<double> _timeSteps;
+    FixingSchedule _timeSteps;
+    double _valuation_date{0.0};
+    std::size_t _nb_past_fixings{0};
+    double _past_fixing_sum{0.0};
 public:
+    using allocator_type = FixingSchedule::allocator_type;
     AsianOption(std::vector<double> timeSteps);
+    AsianOption(const double* first, const double* last, const allocator_type& alloc);
     std::vector<double> getTimeSteps() const override;
+    const FixingSchedule& getFixings() const;
+    void setPastFixings(double valuation_date, const std::vector<double>& fixings);
+    double getValuationDate() const;
+    std::size_t getNbPastFixings() const;
+    double getPastFixingSum() const;
     double payoffPath(const std::vector<double>& path) const override;
     bool isAsianOption() const override;
 };
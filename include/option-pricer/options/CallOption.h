@@ -8,6 +8,7 @@ public:
     CallOption(double expiry, double strike);
     OptionType getOptionType() const override;
     double payoff(double asset_price) const override;
+    void payoffBatch(const double* asset_prices, double* payoffs, std::size_t n) const override;
 };
 
 #endif
\ No newline at end of file
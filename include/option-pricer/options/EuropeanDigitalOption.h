@@ -14,6 +14,7 @@ public:
     double payoff(double asset_price) const override = 0;
 
     double getStrike() const;
+    std::vector<double> getPayoffKinks() const override;
 
     friend class BlackScholesPricer; // give access to _strike
 };
@@ -1,5 +1,6 @@
 #ifndef OPTION_H
 #define OPTION_H
+#include <cstddef>
 #include <vector>
 
 enum class OptionType {
@@ -18,6 +19,8 @@ public:
     virtual ~Option(){}
     virtual std::vector<double> getTimeSteps() const;
     virtual double payoffPath(const std::vector<double>& path) const;
+    virtual void payoffBatch(const double* asset_prices, double* payoffs, std::size_t n) const;
+    virtual std::vector<double> getPayoffKinks() const;
     virtual bool isAsianOption() const;
     virtual bool isAmericanOption() const;
 };
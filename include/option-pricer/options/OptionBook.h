@@ -0,0 +1,51 @@
+#ifndef OPTIONBOOK_H
+#define OPTIONBOOK_H
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+#include "Option.h"
+
+class OptionBook {
+private:
+    std::pmr::monotonic_buffer_resource _arena;
+    std::pmr::vector<Option*> _options;
+
+    void destroyAll();
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    explicit OptionBook(std::size_t initial_bytes = 0, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    OptionBook(const OptionBook&) = delete;
+    OptionBook& operator=(const OptionBook&) = delete;
+    ~OptionBook();
+
+    /// Construct a T in the book's arena and return it. Allocator-aware options (those
+    /// with an allocator_type, such as the Asian options) get the arena as trailing
+    /// allocator argument, so their fixings land in the arena as well. The book keeps
+    /// ownership: the option lives until clear() or the book's destruction.
+    template <class T, class... Args>
+    T* add(Args&&... args) {
+        allocator_type alloc(&_arena);
+        void* storage = _arena.allocate(sizeof(T), alignof(T));
+        T* option;
+        if constexpr (std::uses_allocator_v<T, allocator_type>) {
+            option = ::new (storage) T(std::forward<Args>(args)..., alloc);
+        } else {
+            option = ::new (storage) T(std::forward<Args>(args)...);
+        }
+        _options.push_back(option);
+        return option;
+    }
+
+    void reserve(std::size_t n);
+    std::size_t size() const;
+    Option* operator[](std::size_t i) const;
+    const std::pmr::vector<Option*>& options() const;
+    std::pmr::memory_resource* resource();
+    void clear();
+};
+
+#endif
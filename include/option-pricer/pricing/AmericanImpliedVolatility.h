@@ -0,0 +1,26 @@
+#ifndef AMERICANIMPLIEDVOLATILITY_H
+#define AMERICANIMPLIEDVOLATILITY_H
+
+#include <vector>
+#include "AmericanOption.h"
+#include "PricerPool.h"
+
+class AmericanImpliedVolatility {
+private:
+    int _depth;
+    double _tolerance;
+    int _max_iterations;
+    std::vector<double> _values;
+    std::vector<double> _ratios;
+
+    double latticePrice(const AmericanOption* option, double S0, double r, double volatility);
+    double europeanGuess(const AmericanOption* option, double price, double S0, double r) const;
+public:
+    AmericanImpliedVolatility(int depth, double tolerance = 1e-8, int max_iterations = 50);
+    int getDepth() const;
+    double solve(const AmericanOption* option, double price, double S0, double r);
+    static std::vector<double> solve(const std::vector<const AmericanOption*>& options, const std::vector<double>& prices, double S0, double r, int depth, unsigned nb_threads = 0);
+    static std::vector<double> solve(PricerPool<AmericanImpliedVolatility>& pool, const std::vector<const AmericanOption*>& options, const std::vector<double>& prices, double S0, double r);
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef BLACK76PRICER_H
+#define BLACK76PRICER_H
+
+#include <algorithm>
+#include <cmath>
+#include "EuropeanDigitalOption.h"
+#include "EuropeanVanillaOption.h"
+#include "NormalDistribution.h"
+
+class Black76Pricer {
+private:
+    EuropeanVanillaOption* _option{nullptr};
+    EuropeanDigitalOption* _digital_option{nullptr};
+    double _strike;
+    double _forward;
+    double _discount_factor;
+    double _volatility;
+    bool _is_digital;
+
+    double stdDev() const;
+public:
+    Black76Pricer(EuropeanVanillaOption* option, double forward, double discount_factor, double volatility);
+    Black76Pricer(EuropeanDigitalOption* option, double forward, double discount_factor, double volatility);
+    double price() const;
+    double delta() const;
+    double operator()() const;
+
+    /// Black-76 price from the forward, the discount factor to expiry and the total
+    /// standard deviation sigma * sqrt(T). Digitals are cash-or-nothing paying 1.
+    /// A zero standard deviation gives the discounted intrinsic value on the forward.
+    static double price(OptionType type, bool digital, double forward, double strike, double discount_factor, double std_dev) {
+        const double w = type == OptionType::Call ? 1.0 : -1.0;
+        if (std_dev <= 0.0) {
+            if (digital) {
+                return w * (forward - strike) >= 0.0 ? discount_factor : 0.0;
+            }
+            return discount_factor * std::max(w * (forward - strike), 0.0);
+        }
+        const double d1 = std::log(forward / strike) / std_dev + 0.5 * std_dev;
+        const double d2 = d1 - std_dev;
+        if (digital) {
+            return discount_factor * NormalDistribution::cdf(w * d2);
+        }
+        return w * discount_factor * (forward * NormalDistribution::cdf(w * d1) - strike * NormalDistribution::cdf(w * d2));
+    }
+
+    /// Sensitivity of price() to the forward.
+    static double delta(OptionType type, bool digital, double forward, double strike, double discount_factor, double std_dev) {
+        const double w = type == OptionType::Call ? 1.0 : -1.0;
+        if (std_dev <= 0.0) {
+            return (digital || w * (forward - strike) <= 0.0) ? 0.0 : w * discount_factor;
+        }
+        const double d1 = std::log(forward / strike) / std_dev + 0.5 * std_dev;
+        if (digital) {
+            return w * discount_factor * NormalDistribution::pdf(d1 - std_dev) / (forward * std_dev);
+        }
+        return w * discount_factor * NormalDistribution::cdf(w * d1);
+    }
+};
+
+#endif
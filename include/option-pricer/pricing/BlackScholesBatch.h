@@ -0,0 +1,45 @@
+#ifndef BLACKSCHOLESBATCH_H
+#define BLACKSCHOLESBATCH_H
+
+#include <cstddef>
+#include <vector>
+#include "Option.h"
+
+struct BlackScholesBatchInput {
+    std::vector<OptionType> type;
+    std::vector<unsigned char> is_digital;
+    std::vector<double> spot;
+    std::vector<double> strike;
+    std::vector<double> expiry;
+    std::vector<double> rate;
+    std::vector<double> volatility;
+
+    std::size_t size() const;
+    void reserve(std::size_t n);
+    void add(OptionType option_type, bool digital, double asset_price, double option_strike, double option_expiry, double interest_rate, double option_volatility);
+};
+
+struct BlackScholesGreeks {
+    std::vector<double> price;
+    std::vector<double> delta;
+    std::vector<double> gamma;
+    std::vector<double> vega;
+    std::vector<double> theta;
+    std::vector<double> rho;
+    std::vector<double> vanna;
+    std::vector<double> volga;
+
+    void resize(std::size_t n);
+};
+
+class BlackScholesBatch {
+public:
+    BlackScholesBatch() = delete;
+
+    static void price(const BlackScholesBatchInput& input, std::vector<double>& prices);
+    static void price(const BlackScholesBatchInput& input, double* prices, std::size_t begin, std::size_t end);
+    static void greeks(const BlackScholesBatchInput& input, BlackScholesGreeks& greeks);
+    static void greeks(const BlackScholesBatchInput& input, BlackScholesGreeks& greeks, std::size_t begin, std::size_t end);
+};
+
+#endif
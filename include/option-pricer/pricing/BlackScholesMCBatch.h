@@ -0,0 +1,64 @@
+#ifndef BLACKSCHOLESMCBATCH_H
+#define BLACKSCHOLESMCBATCH_H
+
+#include <cstddef>
+#include <vector>
+#include "Option.h"
+
+class BlackScholesMCBatch {
+public:
+    static constexpr std::size_t kLanes = 8;
+
+private:
+    enum class Payoff { Vanilla, Path };
+
+    struct Contract {
+        Option* option;
+        double initial_price;
+        double discount;
+        Payoff payoff;
+        double w;
+        double strike;
+        std::size_t steps;
+        std::size_t table;
+        int nb_paths;
+        double estimate;
+        double M2;
+    };
+
+    struct Group {
+        std::size_t steps;
+        std::size_t lanes;
+        std::size_t contracts[kLanes];
+        std::size_t table;
+    };
+
+    std::vector<Contract> _contracts;
+    std::vector<double> _drift_dt;
+    std::vector<double> _vol_sqrt_dt;
+    bool _grouped{false};
+    std::vector<Group> _groups;
+    std::vector<double> _lane_drift;
+    std::vector<double> _lane_vol;
+    std::vector<double> _lane_growth2;
+    std::vector<double> _normals;
+    std::vector<double> _paths;
+    std::vector<double> _path;
+
+    void group();
+    void simulate(const Group& group, int nb_paths);
+    void record(Contract& contract, double payoff_discounted);
+    const Contract& contractAt(std::size_t j) const;
+public:
+    BlackScholesMCBatch();
+    std::size_t add(Option* option, double initial_price, double interest_rate, double volatility);
+    std::size_t size() const;
+    void reserve(std::size_t n);
+    void clear();
+    void generate(int nb_paths);
+    int getNbPaths(std::size_t j) const;
+    double price(std::size_t j) const;
+    std::vector<double> confidenceInterval(std::size_t j) const;
+};
+
+#endif
@@ -1,29 +1,60 @@
 #ifndef BLACKSCHOLESMCPRICER_H
 #define BLACKSCHOLESMCPRICER_H
 
+#include <cstddef>
 #include <vector>
 #include "Option.h"
 #include "EuropeanVanillaOption.h"
+#include "Histogram.h"
+#include "PathStore.h"
+#include "TDigest.h"
 
 class BlackScholesMCPricer {
 private:
-    Option* _option;
-    double _initial_price;
-    double _interest_rate;
-    double _volatility;
-    int _nb_paths;
-    double _estimate;
-    double _M2;
-    double _maturity;
+    Option* _option{nullptr};
+    double _initial_price{0.0};
+    double _interest_rate{0.0};
+    double _volatility{0.0};
+    int _nb_paths{0};
+    double _estimate{0.0};
+    double _M2{0.0};
+    double _maturity{0.0};
     std::vector<double> _time_steps;
     std::vector<double> _drift_dt;
     std::vector<double> _vol_sqrt_dt;
+    std::vector<double> _path_pos;
+    std::vector<double> _path_neg;
+    std::vector<double> _normals;
+    bool _moment_matching{false};
+    std::size_t _block_pairs{1024};
+    std::vector<int> _batch_paths;
+    std::vector<double> _batch_means;
+    TDigest* _quantiles{nullptr};
+    Histogram* _histogram{nullptr};
+    std::vector<double> _block_payoffs;
+    PathStoreWriter* _path_store{nullptr};
+    std::vector<double> _block_paths;
+
+    void matchMoments(std::size_t pairs);
+    void simulatePair(const double* z, double df, bool with_negative, double& payoff_pos, double& payoff_neg);
+    void record(double payoff_discounted);
+    void reset();
 public:
+    static constexpr std::size_t kMinBlockPairs = 1024;
+
+    BlackScholesMCPricer();
     BlackScholesMCPricer(Option* option, double initial_price, double interest_rate, double volatility);
+    void reconfigure(Option* option, double initial_price, double interest_rate, double volatility);
     double price();
     int getNbPaths() const;
+    double getM2() const;
     void generate(int nb_paths);
+    void setMomentMatching(bool enabled, std::size_t block_pairs = 1024);
+    bool getMomentMatching() const;
+    void setSketches(TDigest* quantiles, Histogram* histogram = nullptr);
+    void setPathStore(PathStoreWriter* store);
     double operator()();
+    double standardError();
     std::vector<double> confidenceInterval();
 };
 
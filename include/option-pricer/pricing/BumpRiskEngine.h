@@ -0,0 +1,29 @@
+#ifndef BUMPRISKENGINE_H
+#define BUMPRISKENGINE_H
+
+#include <vector>
+#include "Option.h"
+
+struct Bump {
+    double spot_shift{0.0};
+    double vol_shift{0.0};
+    double rate_shift{0.0};
+};
+
+class BumpRiskEngine {
+private:
+    Option* _option;
+    double _initial_price;
+    double _interest_rate;
+    double _volatility;
+    std::vector<Bump> _bumps;
+public:
+    BumpRiskEngine(Option* option, double initial_price, double interest_rate, double volatility);
+    void addBump(const Bump& bump);
+    void addBumps(const std::vector<Bump>& bumps);
+    const std::vector<Bump>& getBumps() const;
+    std::vector<double> priceMC(int nb_paths) const;
+    std::vector<double> priceCRR(int depth) const;
+};
+
+#endif
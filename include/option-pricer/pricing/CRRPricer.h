@@ -1,25 +1,59 @@
 #ifndef CRRPRICER_H
 #define CRRPRICER_H
+#include <cstddef>
+#include <vector>
 #include "Option.h"
 #include "BinaryTree.h" 
 
+enum class CRRStorage { FullTree, Checkpointed };
+
 class CRRPricer{
 private:
-    Option* _option;
-    int _depth;
-    double _S0, _U, _D, _R;
+    struct Segment {
+        int index{-1};
+        unsigned long long last_use{0};
+        std::vector<double> values;
+        std::vector<char> exercise;
+    };
+
+    Option* _option{nullptr};
+    int _depth{0};
+    double _S0{0.0}, _U{0.0}, _D{0.0}, _R{0.0};
     BinaryTree<double> _optionTree;
     BinaryTree<bool> _exerciseTree;
+    int _allocated_depth{-1};
     
+    CRRStorage _storage{CRRStorage::FullTree};
+    int _requested_interval{0};
+    int _interval{0};
+    std::vector<double> _checkpoints;
+    std::vector<double> _rolling;
+    std::vector<Segment> _segments;
+    unsigned long long _use_counter{0};
+
     bool _computed{false};
     static double binom_coeff(int N, int k);
+    void setTree(Option* option, int depth, double S0, double U, double D, double R);
+    void computeCheckpointed();
+    std::size_t checkpointOffset(int n) const;
+    const Segment& segment(int n);
+    void checkNode(int n, int i) const;
 public:
+    CRRPricer();
     CRRPricer(Option* option, int depth, double S0, double U, double D, double R);
     CRRPricer(Option* option, int depth, double S0, double r, double volatility);
+    void reconfigure(Option* option, int depth, double S0, double U, double D, double R);
+    void reconfigure(Option* option, int depth, double S0, double r, double volatility);
     void compute();
     double get(int n, int i);
     double operator()(bool closed_form = false);
     bool getExercise(int n, int i);
+    void setStorage(CRRStorage storage, int interval = 0, std::size_t cached_segments = 4);
+    CRRStorage getStorage() const;
+    int getCheckpointInterval() const;
+    const BinaryTree<double>& getOptionTree() const;
+    const BinaryTree<bool>& getExerciseTree() const;
+    static void treeFactors(double expiry, int depth, double r, double volatility, double& U, double& D, double& R);
 };
 
 #endif
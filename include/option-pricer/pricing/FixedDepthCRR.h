@@ -0,0 +1,80 @@
+#ifndef FIXEDDEPTHCRR_H
+#define FIXEDDEPTHCRR_H
+
+#include <array>
+#include <utility>
+#include "Option.h"
+
+class FixedDepthCRR {
+public:
+    FixedDepthCRR() = delete;
+
+    static constexpr int kMaxDepth = 64;
+    /// Deepest tree whose levels are fully unrolled; deeper kernels loop over the levels,
+    /// which keeps the build of the kernel table to a few seconds.
+    static constexpr int kMaxUnrolledDepth = 8;
+
+    static bool supports(int depth);
+    static double price(const Option* option, int depth, double S0, double U, double D, double R);
+    static double price(const Option* option, int depth, double S0, double r, double volatility);
+
+    /// Price on a CRR tree of compile-time depth with gross factors U, D, R (as given by
+    /// CRRPricer::treeFactors). The tree lives in std::array rows on the stack. Up to
+    /// kMaxUnrolledDepth the levels are unrolled by a fold expression and every node loop
+    /// has a constant trip count; deeper trees run the same node loop from a loop over the
+    /// levels. Inputs are not checked; the dispatching price() overloads do that.
+    template <int Depth, bool American>
+    static double kernel(const Option& option, double S0, double U, double D, double R) {
+        static_assert(Depth >= 1, "FixedDepthCRR: depth must be at least 1");
+        const double q = (R - D) / (U - D);
+        const double pu = q / R;
+        const double pd = (1.0 - q) / R;
+        const double ratio = U / D;
+
+        std::array<double, Depth + 1> ratios;
+        std::array<double, Depth + 1> down;
+        ratios[0] = 1.0;
+        down[0] = S0;
+        for (int i = 1; i <= Depth; ++i) {
+            ratios[i] = ratios[i - 1] * ratio;
+            down[i] = down[i - 1] * D;
+        }
+
+        std::array<double, Depth + 1> values;
+        for (int i = 0; i <= Depth; ++i) {
+            values[i] = option.payoff(down[Depth] * ratios[i]);
+        }
+        if constexpr (Depth <= kMaxUnrolledDepth) {
+            induct<Depth, American>(std::make_integer_sequence<int, Depth>(), values, option, ratios, down, pu, pd);
+        } else {
+            for (int n = Depth - 1; n >= 0; --n) {
+                level<Depth, American>(n, values, option, ratios, down, pu, pd);
+            }
+        }
+        return values[0];
+    }
+
+private:
+    template <int Depth, bool American, int... Steps>
+    static void induct(std::integer_sequence<int, Steps...>, std::array<double, Depth + 1>& values, const Option& option,
+                       const std::array<double, Depth + 1>& ratios, const std::array<double, Depth + 1>& down, double pu, double pd) {
+        (level<Depth, American>(Depth - 1 - Steps, values, option, ratios, down, pu, pd), ...);
+    }
+
+    // level N overwrites values[0..N] in place from level N + 1, ascending in i
+    template <int Depth, bool American>
+    static void level(int N, std::array<double, Depth + 1>& values, const Option& option, const std::array<double, Depth + 1>& ratios,
+                      const std::array<double, Depth + 1>& down, double pu, double pd) {
+        for (int i = 0; i <= N; ++i) {
+            const double cont = pu * values[i + 1] + pd * values[i];
+            if constexpr (American) {
+                const double intrinsic = option.payoff(down[N] * ratios[i]);
+                values[i] = intrinsic >= cont ? intrinsic : cont;
+            } else {
+                values[i] = cont;
+            }
+        }
+    }
+};
+
+#endif
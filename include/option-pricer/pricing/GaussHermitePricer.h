@@ -0,0 +1,30 @@
+#ifndef GAUSSHERMITEPRICER_H
+#define GAUSSHERMITEPRICER_H
+
+#include <vector>
+#include "Option.h"
+
+class GaussHermitePricer {
+private:
+    int _nodes;
+    std::vector<double> _hermite_nodes;
+    std::vector<double> _hermite_weights;
+    std::vector<double> _legendre_nodes;
+    std::vector<double> _legendre_weights;
+    std::vector<double> _spots;
+    std::vector<double> _weights;
+    std::vector<double> _payoffs;
+    std::vector<double> _breaks;
+
+    double integrate(const Option& option);
+public:
+    static constexpr int kDefaultNodes = 48;
+
+    explicit GaussHermitePricer(int nodes = kDefaultNodes);
+    int getNodes() const;
+    double price(const Option* option, double S0, double r, double volatility);
+    static void computeRules(int nodes, std::vector<double>& hermite_nodes, std::vector<double>& hermite_weights,
+                             std::vector<double>& legendre_nodes, std::vector<double>& legendre_weights);
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef MCSHARD_H
+#define MCSHARD_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Histogram.h"
+#include "Option.h"
+#include "TDigest.h"
+
+/// A Monte Carlo run split into chunks of paths, shared by a coordinator and its workers.
+///
+/// Both sides are built with the same option and job; the workers send a fingerprint of
+/// theirs on connection and are turned away if it does not match the coordinator's. The
+/// fingerprint covers the job, the option's schedule and type, and its payoff on a few
+/// probe paths around the initial price, which tells apart strikes and payoff shapes;
+/// options whose payoffs only differ away from the probes need distinct job ids.
+/// Chunk c simulates paths [c * chunk_paths, (c + 1) * chunk_paths) with a fresh
+/// BlackScholesMCPricer drawing from MT substream c of seed (see MT::setSubstream()), so
+/// its result does not depend on where it runs.
+struct MCShardJob {
+    std::uint64_t job_id{0};
+    double initial_price{0.0};
+    double interest_rate{0.0};
+    double volatility{0.0};
+    std::uint64_t seed{0};
+    std::uint64_t chunk_paths{1u << 18};
+    double digest_compression{0.0}; // 0: no quantile sketch
+    double histogram_lower{0.0};
+    double histogram_upper{0.0};
+    int histogram_bins{0};          // 0: no histogram
+};
+
+class MCShardCoordinator {
+private:
+    struct Chunk {
+        bool done{false};
+        int attempts{0};
+        std::uint64_t nb_paths{0};
+        double mean{0.0};
+        double M2{0.0};
+        std::string digest;
+        std::string histogram;
+    };
+
+    Option* _option;
+    MCShardJob _job;
+    int _listen_fd{-1};
+    double _worker_timeout{60.0};
+    double _run_timeout{0.0};
+    std::vector<Chunk> _chunks;
+    std::uint64_t _nb_paths{0};
+    double _mean{0.0};
+    double _M2{0.0};
+    std::unique_ptr<TDigest> _quantiles;
+    std::unique_ptr<Histogram> _histogram;
+    int _reissued{0};
+    int _workers{0};
+
+    void plan(std::uint64_t nb_paths);
+    void merge();
+public:
+    MCShardCoordinator(Option* option, const MCShardJob& job);
+    MCShardCoordinator(const MCShardCoordinator&) = delete;
+    MCShardCoordinator& operator=(const MCShardCoordinator&) = delete;
+    ~MCShardCoordinator();
+
+    unsigned short listen(const std::string& address = "127.0.0.1", unsigned short port = 0);
+    void setWorkerTimeout(double seconds);
+    void setRunTimeout(double seconds);
+    void run(std::uint64_t nb_paths);
+    void runLocal(std::uint64_t nb_paths);
+
+    std::uint64_t getNbPaths() const;
+    double price() const;
+    std::vector<double> confidenceInterval() const;
+    TDigest& getQuantiles();
+    Histogram& getHistogram();
+    int getReissued() const;
+    int getWorkers() const;
+};
+
+class MCShardWorker {
+private:
+    Option* _option;
+    MCShardJob _job;
+    std::function<void(std::uint64_t)> _on_chunk;
+public:
+    MCShardWorker(Option* option, const MCShardJob& job);
+    void setChunkCallback(std::function<void(std::uint64_t)> on_chunk);
+    std::uint64_t run(const std::string& host, unsigned short port);
+};
+
+#endif
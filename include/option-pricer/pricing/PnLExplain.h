@@ -0,0 +1,55 @@
+#ifndef PNLEXPLAIN_H
+#define PNLEXPLAIN_H
+
+#include <cstddef>
+#include <vector>
+#include "BlackScholesBatch.h"
+#include "EuropeanDigitalOption.h"
+#include "EuropeanVanillaOption.h"
+
+struct MarketData {
+    double spot;
+    double rate;
+    double volatility;
+};
+
+struct PnLExplainLine {
+    double delta{0.0};
+    double gamma{0.0};
+    double vega{0.0};
+    double theta{0.0};
+    double rho{0.0};
+    double vanna{0.0};
+    double volga{0.0};
+    double explained{0.0};
+    double actual{0.0};
+    double unexplained{0.0};
+};
+
+class PnLExplain {
+private:
+    double _elapsed;
+    unsigned _nb_threads;
+    BlackScholesBatchInput _start;
+    BlackScholesBatchInput _end;
+    std::vector<double> _quantity;
+    BlackScholesGreeks _greeks;
+    std::vector<double> _end_prices;
+    std::vector<PnLExplainLine> _lines;
+    PnLExplainLine _total;
+    bool _computed{false};
+
+    void addPosition(OptionType type, bool digital, double strike, double expiry, double quantity, const MarketData& start, const MarketData& end);
+    void explainRange(std::size_t begin, std::size_t end);
+public:
+    PnLExplain(double elapsed, unsigned nb_threads = 0);
+    void addPosition(EuropeanVanillaOption* option, double quantity, const MarketData& start, const MarketData& end);
+    void addPosition(EuropeanDigitalOption* option, double quantity, const MarketData& start, const MarketData& end);
+    std::size_t size() const;
+    void compute();
+    const PnLExplainLine& position(std::size_t i) const;
+    const std::vector<PnLExplainLine>& positions() const;
+    const PnLExplainLine& total() const;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef PORTFOLIOMCSCHEDULER_H
+#define PORTFOLIOMCSCHEDULER_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "BlackScholesMCPricer.h"
+#include "Option.h"
+
+class PortfolioMCScheduler {
+private:
+    struct Trade {
+        BlackScholesMCPricer pricer;
+        double quantity;
+        double seconds;
+    };
+
+    std::vector<Trade> _trades;
+    int _pilot_paths{2048};
+    int _batch_paths{8192};
+    int _batches{0};
+    double _elapsed{0.0};
+
+    void simulate(Trade& trade, int nb_paths);
+    double variance(std::size_t j);
+    void checkIndex(std::size_t j) const;
+public:
+    PortfolioMCScheduler();
+    std::size_t add(Option* option, double initial_price, double interest_rate, double volatility, double quantity = 1.0);
+    std::size_t size() const;
+    void setBatchPaths(int pilot_paths, int batch_paths);
+    bool run(double target_half_width, double max_seconds = std::numeric_limits<double>::infinity());
+    double price();
+    double standardError();
+    std::vector<double> confidenceInterval();
+    double price(std::size_t j);
+    int getNbPaths(std::size_t j) const;
+    double getSecondsPerPath(std::size_t j) const;
+    int getBatches() const;
+    double getElapsed() const;
+};
+
+#endif
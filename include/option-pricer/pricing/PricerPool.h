@@ -0,0 +1,82 @@
+#ifndef PRICERPOOL_H
+#define PRICERPOOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/// One reusable pricer per worker thread.
+///
+/// Batch paths hand each worker its own pricer and reconfigure() it for every job, so
+/// once the pricers have grown to the largest job seen, pricing does not allocate. The
+/// pool is meant to be kept alive across batches. Monte Carlo pricers draw from the MT
+/// engine of their worker thread, which the caller's MT::setEngine() does not seed: a job
+/// that needs reproducible draws seeds it itself.
+template <class Pricer>
+class PricerPool {
+private:
+    std::vector<std::unique_ptr<Pricer>> _pricers;
+public:
+    /// Build nb_threads pricers, each constructed from args (0 uses the hardware concurrency).
+    template <class... Args>
+    explicit PricerPool(unsigned nb_threads, const Args&... args) {
+        if (nb_threads == 0) {
+            nb_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        _pricers.reserve(nb_threads);
+        for (unsigned w = 0; w < nb_threads; ++w) {
+            _pricers.push_back(std::make_unique<Pricer>(args...));
+        }
+    }
+
+    unsigned size() const { return static_cast<unsigned>(_pricers.size()); }
+
+    Pricer& operator[](unsigned worker) { return *_pricers.at(worker); }
+
+    /// Run job(pricer, j) for j in [0, n), splitting the range in contiguous chunks, one
+    /// per worker and its pricer. A worker gets at least min_per_thread jobs, so small
+    /// batches run on fewer threads. The first exception thrown by a job is rethrown once
+    /// every worker has finished.
+    template <class Job>
+    void forEach(std::size_t n, Job job, std::size_t min_per_thread = 1) {
+        const std::size_t workers = std::max<std::size_t>(1, std::min<std::size_t>(size(), n / std::max<std::size_t>(1, min_per_thread)));
+        if (workers == 1) {
+            Pricer& pricer = *_pricers[0];
+            for (std::size_t j = 0; j < n; ++j) {
+                job(pricer, j);
+            }
+            return;
+        }
+        std::vector<std::exception_ptr> errors(workers);
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        const std::size_t chunk = (n + workers - 1) / workers;
+        for (std::size_t w = 0; w < workers; ++w) {
+            threads.emplace_back([&, w]() {
+                Pricer& pricer = *_pricers[w];
+                const std::size_t end = std::min(n, (w + 1) * chunk);
+                try {
+                    for (std::size_t j = w * chunk; j < end; ++j) {
+                        job(pricer, j);
+                    }
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        for (const std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef TURNBULLWAKEMANPRICER_H
+#define TURNBULLWAKEMANPRICER_H
+
+#include "AsianCallOption.h"
+#include "AsianPutOption.h"
+#include "AsianOption.h"
+
+class TurnbullWakemanPricer {
+private:
+    AsianOption* _option;
+    double _strike;
+    double _asset_price;
+    double _interest_rate;
+    double _volatility;
+public:
+    TurnbullWakemanPricer(AsianCallOption* option, double asset_price, double interest_rate, double volatility);
+    TurnbullWakemanPricer(AsianPutOption* option, double asset_price, double interest_rate, double volatility);
+    double price() const;
+    double operator()() const;
+};
+
+#endif
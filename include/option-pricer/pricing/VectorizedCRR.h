@@ -0,0 +1,22 @@
+#ifndef VECTORIZEDCRR_H
+#define VECTORIZEDCRR_H
+
+#include <vector>
+#include "Option.h"
+
+class VectorizedCRR {
+private:
+    std::vector<double> _values;
+    std::vector<double> _ratios;
+    std::vector<double> _spots;
+    std::vector<double> _intrinsic;
+    double _truncation;
+public:
+    explicit VectorizedCRR(double truncation = 0.0);
+    void setTruncation(double truncation);
+    double getTruncation() const;
+    double price(const Option* option, int depth, double S0, double U, double D, double R);
+    double price(const Option* option, int depth, double S0, double r, double volatility);
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+/// Fixed-bin histogram over [lower, upper), with underflow and overflow counts.
+///
+/// The memory is set by the number of bins. Histograms with the same bins merge by
+/// adding their counts.
+class Histogram {
+private:
+    double _lower;
+    double _upper;
+    double _inverse_width;
+    std::vector<std::uint64_t> _counts;
+    std::uint64_t _underflow{0};
+    std::uint64_t _overflow{0};
+public:
+    Histogram(double lower, double upper, int bins);
+    void add(double value);
+    void add(const double* values, std::size_t n);
+    void merge(const Histogram& other);
+    void clear();
+    int getBins() const;
+    double getLower() const;
+    double getUpper() const;
+    double getEdge(int i) const;
+    std::uint64_t getCount(int i) const;
+    std::uint64_t getUnderflow() const;
+    std::uint64_t getOverflow() const;
+    std::uint64_t getTotal() const;
+    void save(std::ostream& os) const;
+    static Histogram load(std::istream& is);
+};
+
+#endif
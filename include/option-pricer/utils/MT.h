@@ -1,8 +1,25 @@
 #ifndef MT_H
 #define MT_H
 
+#include <cstddef>
+#include <cstdint>
 #include <random>
 
+/// Engines behind MT. MT19937 is the default.
+enum class RNGEngine {
+    MT19937,
+    Xoshiro256pp,
+    PCG64,
+    Xoshiro256ppStreams
+};
+
+/// Process-wide access to the random draws of the pricers.
+///
+/// The engine state is per thread: each thread starts on MT19937 seeded from
+/// std::random_device, and setEngine() / setSubstream() only select and seed the engine
+/// of the calling thread. Pricers running on different threads (a PricerPool, say) thus
+/// draw independently without locking; a worker that needs reproducible draws seeds its
+/// own engine.
 class MT {
 private:
     static std::mt19937& generator();
@@ -11,8 +28,15 @@ public:
     MT(const MT&) = delete;
     MT& operator=(const MT&) = delete;
 
+    static void setEngine(RNGEngine engine);
+    static void setEngine(RNGEngine engine, std::uint64_t seed);
+    static void setSubstream(std::uint64_t seed, std::uint64_t index);
+    static RNGEngine getEngine();
+
     static double rand_unif();
     static double rand_norm();
+    static void fill_uniform(double* out, std::size_t n);
+    static void fill_normal(double* out, std::size_t n);
 };
 
 #endif
@@ -0,0 +1,22 @@
+#ifndef NORMALDISTRIBUTION_H
+#define NORMALDISTRIBUTION_H
+
+#include <cmath>
+
+class NormalDistribution {
+public:
+    NormalDistribution() = delete;
+
+    /// Cumulative distribution function of the standard normal distribution.
+    static double cdf(double x) {
+        return 0.5 * std::erfc(-x * M_SQRT1_2);
+    }
+
+    /// Probability density function of the standard normal distribution.
+    static double pdf(double x) {
+        constexpr double inv_sqrt_2pi = 0.39894228040143267794;
+        return inv_sqrt_2pi * std::exp(-0.5 * x * x);
+    }
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef PCG64_H
+#define PCG64_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// PCG64 (O'Neill): 128-bit linear congruential state with the XSL-RR output, 64-bit
+/// outputs, period 2^128.
+///
+/// Generators built with the same seed and different streams are independent sequences.
+/// Matches pcg64_srandom_r(seed, stream) of the reference implementation. The state uses
+/// the compiler's 128-bit integer where it has one and a pair of 64-bit words otherwise;
+/// both give the same sequence.
+class PCG64 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit PCG64(std::uint64_t seed = 0xcafef00dd15ea5e5ULL, std::uint64_t stream = 0xa02bdbf7bb3c0a7ULL);
+
+    void seed(std::uint64_t seed, std::uint64_t stream = 0xa02bdbf7bb3c0a7ULL);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() {
+        advance();
+        const std::uint64_t folded = stateHigh() ^ stateLow();
+        const unsigned rot = static_cast<unsigned>(stateHigh() >> 58);
+        return (folded >> rot) | (folded << ((64 - rot) & 63));
+    }
+
+    void fill_uniform(double* out, std::size_t n);
+    void fill_normal(double* out, std::size_t n);
+
+private:
+    static constexpr std::uint64_t kMultiplierHigh = 0x2360ed051fc65da4ULL;
+    static constexpr std::uint64_t kMultiplierLow = 0x4385df649fccf645ULL;
+
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128;
+
+    static constexpr uint128 kMultiplier = (static_cast<uint128>(kMultiplierHigh) << 64) | kMultiplierLow;
+
+    uint128 _state{0};
+    uint128 _increment{1};
+
+    void advance() { _state = _state * kMultiplier + _increment; }
+    std::uint64_t stateHigh() const { return static_cast<std::uint64_t>(_state >> 64); }
+    std::uint64_t stateLow() const { return static_cast<std::uint64_t>(_state); }
+    void reset(std::uint64_t stream) {
+        _state = 0;
+        _increment = (static_cast<uint128>(stream) << 1) | 1;
+    }
+    void addToState(std::uint64_t x) { _state += x; }
+#else
+    std::uint64_t _state_high{0};
+    std::uint64_t _state_low{0};
+    std::uint64_t _increment_high{0};
+    std::uint64_t _increment_low{1};
+
+    // full 128-bit product of two 64-bit words, from 32-bit halves
+    static void multiply(std::uint64_t a, std::uint64_t b, std::uint64_t& high, std::uint64_t& low) {
+        const std::uint64_t a0 = a & 0xffffffffULL, a1 = a >> 32;
+        const std::uint64_t b0 = b & 0xffffffffULL, b1 = b >> 32;
+        const std::uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        const std::uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffULL) + (p10 & 0xffffffffULL);
+        low = (p00 & 0xffffffffULL) | (mid << 32);
+        high = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    }
+    void advance() {
+        std::uint64_t high;
+        std::uint64_t low;
+        multiply(_state_low, kMultiplierLow, high, low);
+        high += _state_high * kMultiplierLow + _state_low * kMultiplierHigh;
+        _state_low = low + _increment_low;
+        _state_high = high + _increment_high + (_state_low < low);
+    }
+    std::uint64_t stateHigh() const { return _state_high; }
+    std::uint64_t stateLow() const { return _state_low; }
+    void reset(std::uint64_t stream) {
+        _state_high = 0;
+        _state_low = 0;
+        _increment_high = stream >> 63;
+        _increment_low = (stream << 1) | 1;
+    }
+    void addToState(std::uint64_t x) {
+        _state_low += x;
+        _state_high += _state_low < x;
+    }
+#endif
+};
+
+#endif
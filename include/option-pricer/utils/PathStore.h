@@ -0,0 +1,116 @@
+#ifndef PATHSTORE_H
+#define PATHSTORE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Option.h"
+
+/// Writes simulated paths to a chunked, losslessly compressed file.
+///
+/// Layout, in native byte order: a 64-byte header (magic "OPPATHST", version, number of
+/// time steps, paths per chunk, number of paths and of chunks, offset of the chunk
+/// index), the time steps, the chunks, then the index: one 32-byte entry per chunk with
+/// its offset, size, number of paths, encoding and checksum (FNV-1a on 64-bit words, in
+/// four lanes). Paths are stored whole, spot after spot, and a chunk holds chunk_paths
+/// paths (the last one fewer). Each spot is XORed with a prediction and stored without
+/// the leading zero bytes that the XORs of its path share (see writeChunk()); a chunk
+/// that would not shrink is stored raw. The header gets its path count and index offset
+/// only in finish(), so an interrupted file is rejected on reading.
+///
+/// add() only copies the paths: full chunks are encoded and written by a thread of the
+/// writer, one chunk at a time, while the caller fills the next one, so the caller waits
+/// only when the disk or the encoder falls behind.
+///
+/// The paths of a Black-Scholes simulation are continuous random values, so a path on
+/// its own barely shrinks; the antithetic path of a pair is predicted from its partner
+/// almost exactly, so BlackScholesMCPricer output takes a little over half the raw size.
+class PathStoreWriter {
+private:
+    std::ofstream _out;
+    std::string _path;
+    std::vector<double> _time_steps;
+    std::size_t _chunk_paths;
+    std::vector<double> _chunk;
+    std::size_t _chunk_size{0};
+    std::uint64_t _nb_paths{0};
+    bool _finished{false};
+
+    // hand-off to the writing thread, under _mutex
+    std::thread _worker;
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::vector<double> _pending;
+    std::size_t _pending_size{0};
+    bool _stop{false};
+    std::exception_ptr _error;
+    std::uint64_t _offset{0};
+
+    // used by the writing thread only, until it is joined
+    std::vector<double> _work;
+    std::vector<std::uint64_t> _encoded;
+    std::vector<std::uint64_t> _xor;
+    std::vector<double> _products;
+    std::vector<unsigned char> _index;
+
+    void handOff(bool last);
+    void run();
+    std::uint64_t writeChunk(const double* spots, std::size_t nb_paths);
+public:
+    static constexpr std::uint32_t kVersion = 2;
+    static constexpr std::size_t kDefaultChunkPaths = 4096;
+
+    PathStoreWriter(const std::string& path, const std::vector<double>& time_steps, std::size_t chunk_paths = kDefaultChunkPaths);
+    PathStoreWriter(const PathStoreWriter&) = delete;
+    PathStoreWriter& operator=(const PathStoreWriter&) = delete;
+    ~PathStoreWriter();
+
+    void add(const double* paths, std::size_t nb_paths);
+    void finish();
+    const std::vector<double>& getTimeSteps() const;
+    std::uint64_t getNbPaths() const;
+    std::uint64_t getBytesWritten() const;
+};
+
+/// Memory-mapped reader of a PathStoreWriter file.
+///
+/// Chunks are decoded on demand, the last one cached, so reading paths in order decodes
+/// each chunk once. price() replays a stored simulation through Option::payoffPath with
+/// the arithmetic of BlackScholesMCPricer, so it reproduces the price of the run that
+/// wrote the paths bit for bit, and prices any other payoff on the same paths.
+class PathStore {
+private:
+    const unsigned char* _base{nullptr};
+    std::size_t _size{0};
+    std::vector<double> _time_steps;
+    std::uint64_t _nb_paths{0};
+    std::uint64_t _chunk_paths{0};
+    std::uint64_t _nb_chunks{0};
+    const unsigned char* _index{nullptr};
+    std::vector<double> _decoded;
+    std::vector<double> _products;
+    std::size_t _decoded_chunk{static_cast<std::size_t>(-1)};
+
+    void unmap();
+    const double* chunk(std::size_t c);
+public:
+    explicit PathStore(const std::string& path);
+    PathStore(const PathStore&) = delete;
+    PathStore& operator=(const PathStore&) = delete;
+    ~PathStore();
+
+    std::uint64_t getNbPaths() const;
+    std::size_t getNbSteps() const;
+    std::uint64_t getNbChunks() const;
+    const std::vector<double>& getTimeSteps() const;
+    void path(std::uint64_t i, std::vector<double>& spots);
+    double price(const Option& option, double interest_rate);
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef PORTFOLIOGENERATOR_H
+#define PORTFOLIOGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "BlackScholesBatch.h"
+#include "BlackScholesMCBatch.h"
+#include "Option.h"
+#include "OptionBook.h"
+#include "PortfolioMCScheduler.h"
+
+enum class ProductKind { EuropeanVanilla, EuropeanDigital, American, Asian };
+
+/// Distributions a synthetic book is drawn from. Weights are relative and need not sum to 1.
+struct PortfolioMix {
+    // product types, and the share of calls within each
+    double european_vanilla{0.45};
+    double european_digital{0.10};
+    double american{0.20};
+    double asian{0.25};
+    double call_share{0.5};
+
+    // maturities: a tenor bucket, then a uniform factor in [1 - jitter, 1 + jitter]
+    std::vector<double> tenors{1.0 / 12.0, 0.25, 0.5, 1.0, 2.0, 3.0, 5.0, 10.0};
+    std::vector<double> tenor_weights{8.0, 12.0, 15.0, 25.0, 15.0, 10.0, 10.0, 5.0};
+    double tenor_jitter{0.1};
+
+    // strikes: log(K / F) normal with standard deviation log_moneyness_sd * sqrt(T), clipped
+    double log_moneyness_sd{0.2};
+    double max_log_moneyness{1.5};
+
+    // Asian fixing counts, evenly spaced up to the expiry
+    std::vector<int> asian_fixings{4, 12, 52, 252};
+    std::vector<double> asian_fixing_weights{15.0, 50.0, 25.0, 10.0};
+
+    // market data, one quote per underlying: spots log-uniform, rates and volatilities uniform
+    std::size_t nb_underlyings{100};
+    double min_spot{5.0};
+    double max_spot{1000.0};
+    double min_rate{0.0};
+    double max_rate{0.06};
+    double min_volatility{0.08};
+    double max_volatility{0.8};
+
+    // whole quantities, log-uniform
+    double min_quantity{1.0};
+    double max_quantity{1000.0};
+};
+
+struct SyntheticTrade {
+    ProductKind kind;
+    OptionType type;
+    std::size_t underlying;
+    double expiry;
+    double strike;
+    int nb_fixings;
+    double quantity;
+};
+
+struct MarketQuote {
+    double spot;
+    double rate;
+    double volatility;
+};
+
+/// Deterministic synthetic books and market data for benchmarks and pipeline tests.
+///
+/// generate() draws the quotes, then the trades, from its own xoshiro256++ stream and
+/// plain arithmetic on its outputs (no <random> distributions, whose algorithms are left
+/// to the standard library). The draws themselves are the same everywhere, but the
+/// quotes and trades go through std::exp, std::log and std::cos, which libm may round
+/// differently: a seed gives the same book with the same toolchain and libm,
+/// and books built elsewhere can differ in the last bits. The fill() overloads load the
+/// book into the batch inputs of the pricing engines.
+class PortfolioGenerator {
+private:
+    PortfolioMix _mix;
+    std::vector<MarketQuote> _market;
+    std::vector<SyntheticTrade> _trades;
+
+    void checkBook(const OptionBook& book) const;
+public:
+    explicit PortfolioGenerator(const PortfolioMix& mix = PortfolioMix());
+
+    void generate(std::size_t nb_trades, std::uint64_t seed);
+    const PortfolioMix& getMix() const;
+    const std::vector<SyntheticTrade>& trades() const;
+    const std::vector<MarketQuote>& market() const;
+
+    void fill(OptionBook& book) const;
+    std::vector<std::size_t> fill(BlackScholesBatchInput& input) const;
+    std::vector<std::size_t> fill(BlackScholesMCBatch& batch, const OptionBook& book) const;
+    std::vector<std::size_t> fill(PortfolioMCScheduler& scheduler, const OptionBook& book) const;
+    void writeCsv(std::ostream& os) const;
+};
+
+#endif
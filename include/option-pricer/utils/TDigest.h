@@ -0,0 +1,60 @@
+#ifndef TDIGEST_H
+#define TDIGEST_H
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+/// Mergeable streaming quantile sketch: a merging t-digest (Dunning and Ertl).
+///
+/// Values are buffered and periodically merged into weighted centroids, small near the
+/// tails and large in the middle (k1 scale function), so that tail quantiles are the
+/// most accurate. A digest of compression d holds at most about d centroids and a buffer
+/// of 5d values, whatever the number of values added. Two digests merge into one of the
+/// same accuracy, which is how per-thread or per-checkpoint digests are combined.
+///
+/// Queries interpolate linearly between the centroid means, pinned at the minimum and
+/// maximum, and compress the digest first, hence are not const.
+class TDigest {
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    double _compression;
+    std::vector<Centroid> _centroids;
+    std::vector<Centroid> _buffer;
+    std::vector<Centroid> _merged;
+    std::vector<double> _knots_q;
+    std::vector<double> _knots_x;
+    double _total{0.0};
+    double _min;
+    double _max;
+
+    void buildKnots();
+    double integrateKnots(double from, double to) const;
+    void checkNotEmpty() const;
+public:
+    static constexpr double kDefaultCompression = 200.0;
+
+    explicit TDigest(double compression = kDefaultCompression);
+    void add(double value);
+    void add(const double* values, std::size_t n);
+    void merge(const TDigest& other);
+    void compress();
+    void clear();
+    double count() const;
+    double min() const;
+    double max() const;
+    double getCompression() const;
+    std::size_t centroids();
+    double quantile(double p);
+    double tailMean(double from, double to);
+    double expectedShortfall(double level);
+    void save(std::ostream& os);
+    static TDigest load(std::istream& is);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef TABLEPACK_H
+#define TABLEPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Read-only view of one table of a TablePack.
+struct TableView {
+    const double* data{nullptr};
+    std::size_t size{0};
+
+    const double* begin() const { return data; }
+    const double* end() const { return data + size; }
+    double operator[](std::size_t i) const { return data[i]; }
+    bool empty() const { return size == 0; }
+};
+
+/// Named tables of doubles in one memory-mapped file, read in place.
+///
+/// Layout, in native byte order: a 64-byte header (magic "OPTBLPAK", version, table
+/// count, file size, FNV-1a 64 checksum of everything after the header), a directory of
+/// 64-byte entries (name of up to 39 characters, offset, count) sorted by name, then the
+/// tables, each on a 64-byte boundary. Opening a pack maps the file and checks the
+/// header; lookups are a binary search of the directory, and the tables are never
+/// copied or parsed. TablePackWriter writes packs; the build runs make_table_pack to
+/// produce the library's own.
+class TablePack {
+private:
+    const unsigned char* _base{nullptr};
+    std::size_t _size{0};
+    std::uint32_t _count{0};
+
+    void unmap();
+public:
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kMaxName = 39;
+
+    TablePack() = default;
+    explicit TablePack(const std::string& path, bool verify_checksum = true);
+    TablePack(const TablePack&) = delete;
+    TablePack& operator=(const TablePack&) = delete;
+    TablePack(TablePack&& other) noexcept;
+    TablePack& operator=(TablePack&& other) noexcept;
+    ~TablePack();
+
+    bool empty() const;
+    std::size_t size() const;
+    std::string name(std::size_t i) const;
+    TableView find(const std::string& name) const;
+    TableView at(const std::string& name) const;
+
+    static const TablePack& defaultPack();
+    static const std::string& defaultPackPath();
+};
+
+/// Builds a TablePack file.
+class TablePackWriter {
+private:
+    std::vector<std::string> _names;
+    std::vector<std::vector<double>> _tables;
+public:
+    void add(const std::string& name, const std::vector<double>& values);
+    void write(const std::string& path) const;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef XOSHIRO256PP_H
+#define XOSHIRO256PP_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// xoshiro256++ (Blackman and Vigna): 256 bits of state, 64-bit outputs, period 2^256 - 1.
+///
+/// Satisfies UniformRandomBitGenerator, so it can drive the <random> distributions, but
+/// fill_uniform() and fill_normal() are much faster ways to get doubles in bulk.
+class Xoshiro256pp {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256pp(std::uint64_t seed = 0x853c49e6748fea9bULL);
+    Xoshiro256pp(std::uint64_t s0, std::uint64_t s1, std::uint64_t s2, std::uint64_t s3);
+
+    void seed(std::uint64_t seed);
+    void jump();
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(_s[0] + _s[3], 23) + _s[0];
+        const std::uint64_t t = _s[1] << 17;
+        _s[2] ^= _s[0];
+        _s[3] ^= _s[1];
+        _s[1] ^= _s[2];
+        _s[0] ^= _s[3];
+        _s[2] ^= t;
+        _s[3] = rotl(_s[3], 45);
+        return result;
+    }
+
+    void fill_uniform(double* out, std::size_t n);
+    void fill_normal(double* out, std::size_t n);
+
+private:
+    friend class Xoshiro256ppStreams;
+
+    std::uint64_t _s[4];
+
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+/// Four interleaved xoshiro256++ streams stepped together.
+///
+/// The state is stored stream-minor, so one step of all the streams is one instruction
+/// per operation on a 256-bit vector. That needs AVX2 (-mavx2 or -march=native): without
+/// a 64-bit vector rotate, an SSE2-only build is slower than a single Xoshiro256pp.
+/// Stream l starts l jumps of 2^128 after the seeded generator, so the streams never
+/// overlap. Outputs are interleaved: value i of a fill comes from stream i % kStreams. A
+/// fill whose size is not a multiple of kStreams discards the unused outputs of its last
+/// step.
+class Xoshiro256ppStreams {
+public:
+    static constexpr std::size_t kStreams = 4;
+
+    explicit Xoshiro256ppStreams(std::uint64_t seed = 0x853c49e6748fea9bULL);
+
+    void seed(std::uint64_t seed);
+
+    void fill_bits(std::uint64_t* out, std::size_t n);
+    void fill_uniform(double* out, std::size_t n);
+    void fill_normal(double* out, std::size_t n);
+
+private:
+    alignas(32) std::uint64_t _s0[kStreams];
+    alignas(32) std::uint64_t _s1[kStreams];
+    alignas(32) std::uint64_t _s2[kStreams];
+    alignas(32) std::uint64_t _s3[kStreams];
+
+    void step(std::uint64_t* out, std::size_t steps);
+};
+
+#endif
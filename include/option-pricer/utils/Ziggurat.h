@@ -0,0 +1,72 @@
+#ifndef ZIGGURAT_H
+#define ZIGGURAT_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/// Standard normal draws from 64-bit random words: the ziggurat method of Marsaglia and
+/// Tsang with 256 layers.
+///
+/// A draw uses a single word 98.5% of the time: 8 bits pick the layer, 52 bits the abscissa
+/// and its sign. The tail beyond 3.654 is sampled exactly with Marsaglia's method.
+class Ziggurat {
+public:
+    Ziggurat() = delete;
+
+    /// Map a random word to a double in [0, 1) with 52 random bits.
+    static double uniform(std::uint64_t bits) {
+        const std::uint64_t mantissa = (bits >> 12) | 0x3ff0000000000000ULL;
+        double u = 0.0;
+        std::memcpy(&u, &mantissa, sizeof(double));
+        return u - 1.0;
+    }
+
+    /// @param next a callable returning uniform random 64-bit words.
+    template <class Bits>
+    static double normal(Bits& next) {
+        const Tables& t = tables();
+        for (;;) {
+            const std::uint64_t bits = next();
+            const unsigned i = static_cast<unsigned>(bits & 0xff);
+            const std::uint64_t mantissa = (bits >> 12) | 0x4000000000000000ULL;
+            double u = 0.0;
+            std::memcpy(&u, &mantissa, sizeof(double));
+            u -= 3.0; // [-1, 1)
+            const double x = u * t.x[i];
+            if (std::fabs(x) < t.x[i + 1]) {
+                return x;
+            }
+            if (i == 0) {
+                return tail(next, u < 0.0);
+            }
+            if (t.f[i + 1] + (t.f[i] - t.f[i + 1]) * uniform(next()) < std::exp(-0.5 * x * x)) {
+                return x;
+            }
+        }
+    }
+
+private:
+    /// x[i] is the right edge of layer i (x[0] is the base strip, x[256] = 0), f[i] the density there.
+    struct Tables {
+        double x[257];
+        double f[257];
+    };
+
+    static constexpr double kTailStart = 3.6541528853610088;
+
+    static const Tables& tables();
+
+    template <class Bits>
+    static double tail(Bits& next, bool negative) {
+        double x = 0.0;
+        double y = 0.0;
+        do {
+            x = -std::log(1.0 - uniform(next())) / kTailStart;
+            y = -std::log(1.0 - uniform(next()));
+        } while (2.0 * y < x * x);
+        return negative ? -(kTailStart + x) : kTailStart + x;
+    }
+};
+
+#endif
@@ -1,4 +1,5 @@
 // MAIN1
+#include <cmath>
 #include <iostream>
 #include "CallOption.h"
 #include "PutOption.h"
@@ -0,0 +1,406 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "SABRModel.h"
+#include "BlackScholesBatch.h"
+
+namespace {
+
+/// Forward-mode dual number carrying the derivatives with respect to (alpha, rho, nu).
+struct Dual3 {
+    double v;
+    double d[3];
+};
+
+Dual3 variable(double v, int k) {
+    Dual3 x{v, {0.0, 0.0, 0.0}};
+    x.d[k] = 1.0;
+    return x;
+}
+
+Dual3 operator+(const Dual3& a, const Dual3& b) { return {a.v + b.v, {a.d[0] + b.d[0], a.d[1] + b.d[1], a.d[2] + b.d[2]}}; }
+Dual3 operator-(const Dual3& a, const Dual3& b) { return {a.v - b.v, {a.d[0] - b.d[0], a.d[1] - b.d[1], a.d[2] - b.d[2]}}; }
+Dual3 operator-(const Dual3& a) { return {-a.v, {-a.d[0], -a.d[1], -a.d[2]}}; }
+Dual3 operator*(const Dual3& a, const Dual3& b) {
+    return {a.v * b.v, {a.d[0] * b.v + a.v * b.d[0], a.d[1] * b.v + a.v * b.d[1], a.d[2] * b.v + a.v * b.d[2]}};
+}
+Dual3 operator/(const Dual3& a, const Dual3& b) {
+    const double inv = 1.0 / b.v;
+    const double q = a.v * inv;
+    return {q, {(a.d[0] - q * b.d[0]) * inv, (a.d[1] - q * b.d[1]) * inv, (a.d[2] - q * b.d[2]) * inv}};
+}
+Dual3 operator+(const Dual3& a, double b) { return {a.v + b, {a.d[0], a.d[1], a.d[2]}}; }
+Dual3 operator+(double a, const Dual3& b) { return b + a; }
+Dual3 operator-(double a, const Dual3& b) { return -b + a; }
+Dual3 operator*(const Dual3& a, double b) { return {a.v * b, {a.d[0] * b, a.d[1] * b, a.d[2] * b}}; }
+Dual3 operator*(double a, const Dual3& b) { return b * a; }
+Dual3 operator/(const Dual3& a, double b) { return a * (1.0 / b); }
+Dual3 sqrt(const Dual3& a) {
+    const double s = std::sqrt(a.v);
+    const double f = 0.5 / s;
+    return {s, {a.d[0] * f, a.d[1] * f, a.d[2] * f}};
+}
+Dual3 log(const Dual3& a) {
+    const double f = 1.0 / a.v;
+    return {std::log(a.v), {a.d[0] * f, a.d[1] * f, a.d[2] * f}};
+}
+
+double value(const Dual3& x) { return x.v; }
+
+// below this |z| the ratio z / x(z) is replaced by its second order expansion
+constexpr double kSmallZ = 1e-4;
+
+/**
+ * Hagan et al. lognormal implied volatility with the Obloj (2008) leading term.
+ * Templated on the parameter type; with Dual3 it yields the volatility and its exact
+ * gradient with respect to (alpha, rho, nu). Plain volatilities go through haganSlice().
+ */
+template <class Real>
+Real haganVol(double F, double K, double T, double beta, const Real& alpha, const Real& rho, const Real& nu) {
+    using std::log;
+    using std::sqrt;
+    const double c = 1.0 - beta;
+    const double l = std::log(F / K);
+    const double fk_c = std::pow(F * K, c);
+    const double fk_c2 = std::sqrt(fk_c);
+
+    // (F^c - K^c) / c, written with expm1 so that it stays accurate near the money and for beta = 1
+    const double q = c == 0.0 ? l : std::pow(K, c) * std::expm1(c * l) / c;
+    // l / q, with its limit 1 / K^c at the money
+    const double l_over_q = l == 0.0 ? 1.0 / std::pow(K, c) : l / q;
+
+    const Real z = nu / alpha * q;
+    Real leading;
+    if (std::fabs(value(z)) < kSmallZ) {
+        // nu l / x(z) = alpha (l / q) (z / x(z)), z / x(z) = 1 - rho z / 2 + (2 - 3 rho^2) z^2 / 12 + O(z^3)
+        const Real z_over_x = 1.0 - 0.5 * rho * z + (2.0 - 3.0 * rho * rho) * z * z / 12.0;
+        leading = alpha * l_over_q * z_over_x;
+    } else {
+        const Real x = log((sqrt(1.0 - 2.0 * rho * z + z * z) + z - rho) / (1.0 - rho));
+        leading = nu * l / x;
+    }
+
+    const Real correction = 1.0 + (c * c / 24.0 * alpha * alpha / fk_c + 0.25 * rho * beta * nu * alpha / fk_c2 + (2.0 - 3.0 * rho * rho) / 24.0 * nu * nu) * T;
+    return leading * correction;
+}
+
+// the terms of haganVol that only depend on the model, the forward and the expiry
+struct SliceTerms {
+    double forward;
+    double c;
+    double inv_c;
+    double forward_c;
+    double alpha;
+    double rho;
+    double nu;
+    double nu_over_alpha;
+    double inv_one_minus_rho;
+    double rho_term;     // (2 - 3 rho^2) / 12
+    double correction_a; // c^2 alpha^2 T / 24
+    double correction_b; // rho beta nu alpha T / 4
+    double correction_c; // (2 - 3 rho^2) nu^2 T / 24
+};
+
+/**
+ * haganVol over a strike slice: per strike one log, one exp, one expm1, one sqrt and the
+ * log of x(z), with both branches of the expansion computed and selected, so the body
+ * has no branch. Lognormal is beta = 1, where (F^c - K^c) / c is just log(F / K).
+ */
+template <bool Lognormal>
+void haganSlice(const SliceTerms& s, const double* strikes, double* vols, std::size_t n) {
+    for (std::size_t j = 0; j < n; ++j) {
+        const double l = std::log(s.forward / strikes[j]);
+        const double k_c = Lognormal ? 1.0 : s.forward_c * std::exp(-s.c * l);
+        const double fk_c = s.forward_c * k_c;
+        const double q = Lognormal ? l : k_c * std::expm1(s.c * l) * s.inv_c;
+        const double l_over_q = l == 0.0 ? 1.0 / k_c : l / q;
+        const double z = s.nu_over_alpha * q;
+        const double expansion = s.alpha * l_over_q * (1.0 - 0.5 * s.rho * z + s.rho_term * z * z);
+        const double x = std::log((std::sqrt(1.0 - 2.0 * s.rho * z + z * z) + z - s.rho) * s.inv_one_minus_rho);
+        const double exact = s.nu * l / x;
+        const double leading = std::fabs(z) < kSmallZ ? expansion : exact;
+        vols[j] = leading * (1.0 + s.correction_a / fk_c + s.correction_b / std::sqrt(fk_c) + s.correction_c);
+    }
+}
+
+void checkInputs(double forward, double strike, double expiry) {
+    if (forward <= 0.0 || strike <= 0.0 || expiry < 0.0) {
+        throw std::invalid_argument("SABRModel: forward and strike must be positive, expiry nonnegative");
+    }
+}
+
+/**
+ * Solve the 3x3 system A x = b by Cramer's rule.
+ * @return false if the system is singular.
+ */
+bool solve3(const double A[3][3], const double b[3], double x[3]) {
+    const double det = A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1]) - A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0]) + A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
+    if (!(std::fabs(det) > 0.0)) {
+        return false;
+    }
+    for (int k = 0; k < 3; ++k) {
+        double M[3][3];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                M[i][j] = j == k ? b[i] : A[i][j];
+            }
+        }
+        x[k] = (M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1]) - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0]) + M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0])) / det;
+    }
+    return true;
+}
+
+}
+
+/**
+ * @brief Construct a SABR model.
+ * @param alpha The initial volatility level, > 0.
+ * @param beta The CEV exponent, in [0, 1].
+ * @param rho The correlation between the forward and its volatility, in (-1, 1).
+ * @param nu The volatility of volatility, >= 0.
+ * @throws std::invalid_argument if a parameter is out of range.
+ */
+SABRModel::SABRModel(double alpha, double beta, double rho, double nu) : _alpha(alpha), _beta(beta), _rho(rho), _nu(nu) {
+    if (!(_alpha > 0.0) || _beta < 0.0 || _beta > 1.0 || !(std::fabs(_rho) < 1.0) || _nu < 0.0) {
+        throw std::invalid_argument("SABRModel: invalid parameters");
+    }
+}
+
+double SABRModel::getAlpha() const {
+    return _alpha;
+}
+
+double SABRModel::getBeta() const {
+    return _beta;
+}
+
+double SABRModel::getRho() const {
+    return _rho;
+}
+
+double SABRModel::getNu() const {
+    return _nu;
+}
+
+/**
+ * @brief Black implied volatility of the SABR model for one strike.
+ * @param forward The forward of the underlying at expiry.
+ * @param strike The strike of the option.
+ * @param expiry The time to expiry.
+ * @return The lognormal (Black) implied volatility.
+ * @throws std::invalid_argument if forward or strike is not positive.
+ */
+double SABRModel::impliedVolatility(double forward, double strike, double expiry) const {
+    checkInputs(forward, strike, expiry);
+    double vol = 0.0;
+    impliedVolatilities(forward, expiry, &strike, &vol, 1);
+    return vol;
+}
+
+/**
+ * @brief Black implied volatilities of the SABR model for a whole strike slice.
+ * @details The strikes are checked in a first pass. The terms that only depend on the
+ * model, the forward and the expiry (F^(1 - beta), the correction coefficients, the
+ * ratios of parameters) are then computed once, and the loop over strikes is a
+ * straight, branch-free kernel with no allocation nor virtual call. The scalar
+ * impliedVolatility() goes through the same kernel, so both agree bit for bit.
+ * @param forward The forward of the underlying at expiry.
+ * @param expiry The time to expiry.
+ * @param strikes The strikes, n entries.
+ * @param vols Output volatilities, n entries.
+ * @param n The number of strikes.
+ * @throws std::invalid_argument if forward or a strike is not positive, or the expiry
+ * is negative; vols is then left unchanged.
+ */
+void SABRModel::impliedVolatilities(double forward, double expiry, const double* strikes, double* vols, std::size_t n) const {
+    checkInputs(forward, forward, expiry);
+    for (std::size_t j = 0; j < n; ++j) {
+        if (!(strikes[j] > 0.0)) {
+            throw std::invalid_argument("SABRModel: strikes must be positive");
+        }
+    }
+    SliceTerms s;
+    s.forward = forward;
+    s.c = 1.0 - _beta;
+    s.inv_c = s.c == 0.0 ? 0.0 : 1.0 / s.c;
+    s.forward_c = std::pow(forward, s.c);
+    s.alpha = _alpha;
+    s.rho = _rho;
+    s.nu = _nu;
+    s.nu_over_alpha = _nu / _alpha;
+    s.inv_one_minus_rho = 1.0 / (1.0 - _rho);
+    s.rho_term = (2.0 - 3.0 * _rho * _rho) / 12.0;
+    s.correction_a = s.c * s.c / 24.0 * _alpha * _alpha * expiry;
+    s.correction_b = 0.25 * _rho * _beta * _nu * _alpha * expiry;
+    s.correction_c = (2.0 - 3.0 * _rho * _rho) / 24.0 * _nu * _nu * expiry;
+    if (s.c == 0.0) {
+        haganSlice<true>(s, strikes, vols, n);
+    } else {
+        haganSlice<false>(s, strikes, vols, n);
+    }
+}
+
+/**
+ * @brief Black implied volatilities of the SABR model for a whole strike slice.
+ * @param forward The forward of the underlying at expiry.
+ * @param expiry The time to expiry.
+ * @param strikes The strikes.
+ * @return The implied volatilities, one per strike.
+ */
+std::vector<double> SABRModel::impliedVolatilities(double forward, double expiry, const std::vector<double>& strikes) const {
+    std::vector<double> vols(strikes.size());
+    impliedVolatilities(forward, expiry, strikes.data(), vols.data(), strikes.size());
+    return vols;
+}
+
+/**
+ * @brief Implied volatility and its exact gradient with respect to (alpha, rho, nu).
+ * @details The gradient is obtained by forward-mode differentiation of the closed form,
+ * so it is exact up to rounding and costs about one extra evaluation.
+ * @param forward The forward of the underlying at expiry.
+ * @param strike The strike of the option.
+ * @param expiry The time to expiry.
+ * @param vol Output implied volatility.
+ * @param grad Output derivatives d(vol)/d(alpha), d(vol)/d(rho), d(vol)/d(nu).
+ */
+void SABRModel::jacobian(double forward, double strike, double expiry, double& vol, double grad[3]) const {
+    checkInputs(forward, strike, expiry);
+    const Dual3 v = haganVol(forward, strike, expiry, _beta, variable(_alpha, 0), variable(_rho, 1), variable(_nu, 2));
+    vol = v.v;
+    grad[0] = v.d[0];
+    grad[1] = v.d[1];
+    grad[2] = v.d[2];
+}
+
+/**
+ * @brief Price a chain of vanilla options sharing an expiry directly from the SABR parameters.
+ * @details The volatilities of the whole slice are evaluated first, then the chain is
+ * priced by a single call to the Black-Scholes batch kernel.
+ * @param spot The spot of the underlying.
+ * @param interest_rate The interest rate of the risk-free asset.
+ * @param expiry The common expiry of the chain.
+ * @param strikes The strikes of the chain.
+ * @param types The type of each option of the chain.
+ * @return The prices, one per strike.
+ * @throws std::invalid_argument if strikes and types differ in size.
+ */
+std::vector<double> SABRModel::priceChain(double spot, double interest_rate, double expiry, const std::vector<double>& strikes, const std::vector<OptionType>& types) const {
+    if (strikes.size() != types.size()) {
+        throw std::invalid_argument("SABRModel: strikes and types must have the same size");
+    }
+    const double forward = spot * std::exp(interest_rate * expiry);
+    const std::vector<double> vols = impliedVolatilities(forward, expiry, strikes);
+
+    BlackScholesBatchInput input;
+    input.reserve(strikes.size());
+    for (std::size_t j = 0; j < strikes.size(); ++j) {
+        input.add(types[j], false, spot, strikes[j], expiry, interest_rate, vols[j]);
+    }
+    std::vector<double> prices;
+    BlackScholesBatch::price(input, prices);
+    return prices;
+}
+
+/**
+ * @brief Calibrate (alpha, rho, nu) to an expiry slice of market volatilities, beta fixed.
+ * @details Levenberg-Marquardt on the volatility residuals, using the exact Jacobian of
+ * jacobian(). Steps are projected back onto alpha > 0, |rho| < 1, nu >= 0. The starting
+ * point takes alpha from the volatility of the strike closest to the forward.
+ * @param forward The forward of the underlying at expiry.
+ * @param expiry The time to expiry.
+ * @param strikes The quoted strikes, at least three.
+ * @param market_vols The quoted Black volatilities, one per strike.
+ * @param beta The fixed CEV exponent.
+ * @param rmse Optional output root mean square volatility error of the fit.
+ * @return The calibrated model.
+ * @throws std::invalid_argument if fewer than three quotes are given or sizes differ.
+ */
+SABRModel SABRModel::calibrate(double forward, double expiry, const std::vector<double>& strikes, const std::vector<double>& market_vols, double beta, double* rmse) {
+    const std::size_t n = strikes.size();
+    if (n < 3 || market_vols.size() != n) {
+        throw std::invalid_argument("SABRModel: calibration needs at least three strikes with one volatility each");
+    }
+    constexpr int kMaxIterations = 200;
+    constexpr double kRhoBound = 0.9999;
+
+    std::size_t atm = 0;
+    for (std::size_t j = 1; j < n; ++j) {
+        if (std::fabs(std::log(strikes[j] / forward)) < std::fabs(std::log(strikes[atm] / forward))) {
+            atm = j;
+        }
+    }
+    double p[3] = {market_vols[atm] * std::pow(forward, 1.0 - beta), 0.0, 0.3};
+
+    std::vector<double> residuals(n);
+    std::vector<double> J(3 * n);
+    auto evaluate = [&](const double params[3], bool with_jacobian) {
+        const SABRModel model(params[0], beta, params[1], params[2]);
+        double cost = 0.0;
+        double vol = 0.0;
+        for (std::size_t j = 0; j < n; ++j) {
+            if (with_jacobian) {
+                model.jacobian(forward, strikes[j], expiry, vol, &J[3 * j]);
+            } else {
+                vol = model.impliedVolatility(forward, strikes[j], expiry);
+            }
+            residuals[j] = vol - market_vols[j];
+            cost += residuals[j] * residuals[j];
+        }
+        return cost;
+    };
+
+    double cost = evaluate(p, true);
+    double lambda = 1e-3;
+    for (int iter = 0; iter < kMaxIterations && cost > 1e-24; ++iter) {
+        double A[3][3] = {{0.0}};
+        double g[3] = {0.0, 0.0, 0.0};
+        for (std::size_t j = 0; j < n; ++j) {
+            const double* row = &J[3 * j];
+            for (int a = 0; a < 3; ++a) {
+                g[a] -= row[a] * residuals[j];
+                for (int b = 0; b < 3; ++b) {
+                    A[a][b] += row[a] * row[b];
+                }
+            }
+        }
+
+        bool accepted = false;
+        double step_size = 0.0;
+        while (!accepted && lambda < 1e12) {
+            double M[3][3];
+            for (int a = 0; a < 3; ++a) {
+                for (int b = 0; b < 3; ++b) {
+                    M[a][b] = A[a][b] + (a == b ? lambda * std::max(A[a][a], 1e-12) : 0.0);
+                }
+            }
+            double delta[3];
+            if (!solve3(M, g, delta)) {
+                lambda *= 4.0;
+                continue;
+            }
+            double trial[3] = {std::max(p[0] + delta[0], 1e-8 * p[0]), std::clamp(p[1] + delta[1], -kRhoBound, kRhoBound), std::max(p[2] + delta[2], 0.0)};
+            const double trial_cost = evaluate(trial, false);
+            if (trial_cost < cost) {
+                step_size = std::fabs(trial[0] - p[0]) / p[0] + std::fabs(trial[1] - p[1]) + std::fabs(trial[2] - p[2]);
+                std::copy(trial, trial + 3, p);
+                lambda = std::max(lambda / 3.0, 1e-12);
+                accepted = true;
+            } else {
+                lambda *= 4.0;
+            }
+        }
+        if (!accepted) {
+            break;
+        }
+        cost = evaluate(p, true);
+        if (step_size < 1e-12) {
+            break;
+        }
+    }
+
+    if (rmse) {
+        *rmse = std::sqrt(cost / static_cast<double>(n));
+    }
+    return SABRModel(p[0], beta, p[1], p[2]);
+}
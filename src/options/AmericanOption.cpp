@@ -1,3 +1,4 @@
+#include <stdexcept>
 #include "AmericanOption.h"
 
 AmericanOption::AmericanOption(double expiry, double strike) : Option(expiry), _strike(strike) {
@@ -4,6 +4,16 @@
 
 AsianCallOption::AsianCallOption(std::vector<double> timeSteps, double strike) : AsianOption(std::move(timeSteps)), _strike(strike) {}
 
+/**
+ * Allocator-extended constructor for AsianCallOption.
+ *
+ * The fixing dates are copied into a schedule allocated from alloc when they do not fit inline.
+ * @param timeSteps the time steps of the option.
+ * @param strike the strike price of the option.
+ * @param alloc the allocator of the fixing schedule.
+ */
+AsianCallOption::AsianCallOption(const std::vector<double>& timeSteps, double strike, const allocator_type& alloc) : AsianOption(timeSteps.data(), timeSteps.data() + timeSteps.size(), alloc), _strike(strike) {}
+
 /**
  * @brief The payoff of an Asian call option.
  *
@@ -14,6 +24,15 @@ double AsianCallOption::payoff(double asset_price) const {
     return std::max(asset_price - _strike, 0.0);
 }
 
+/**
+ * @brief Returns the strike of the option.
+ *
+ * @return The strike the average is compared to.
+ */
+double AsianCallOption::getStrike() const {
+    return _strike;
+}
+
 /**
  * Returns the type of the option.
  *
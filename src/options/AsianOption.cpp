@@ -1,9 +1,22 @@
 #include "AsianOption.h"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
-#include <utility>
 #include <vector>
 
-AsianOption::AsianOption(std::vector<double> timeSteps) : Option(timeSteps.empty() ? 0.0 : timeSteps.back()), _timeSteps(std::move(timeSteps)) {
+AsianOption::AsianOption(std::vector<double> timeSteps) : AsianOption(timeSteps.data(), timeSteps.data() + timeSteps.size(), allocator_type()) {}
+
+/**
+ * @brief Allocator-extended constructor.
+ * @details Schedules of up to FixingSchedule::kInlineCapacity dates are stored inline;
+ * longer ones are allocated from alloc, so options built in an OptionBook keep their
+ * fixings in the book's arena.
+ * @param first The first fixing date.
+ * @param last One past the last fixing date.
+ * @param alloc The allocator of the fixing schedule.
+ * @throws std::invalid_argument if the schedule is empty.
+ */
+AsianOption::AsianOption(const double* first, const double* last, const allocator_type& alloc) : Option(first == last ? 0.0 : *(last - 1)), _timeSteps(first, last, alloc) {
     if (_timeSteps.empty()) {
         throw std::invalid_argument("AsianOption: time steps cannot be empty");
     }
@@ -12,12 +25,82 @@ AsianOption::AsianOption(std::vector<double> timeSteps) : Option(timeSteps.empty
 /**
  * @brief Returns the time steps associated with the Asian option.
  *
+ * These are the fixing dates still to be simulated, as times from the valuation date:
+ * the whole schedule for a new option, the remaining fixings for a seasoned one (see
+ * setPastFixings()).
  * @return A vector containing the time steps associated with the Asian option.
  */
 std::vector<double> AsianOption::getTimeSteps() const {
+    std::vector<double> steps(_timeSteps.begin() + _nb_past_fixings, _timeSteps.end());
+    for (double& t : steps) {
+        t -= _valuation_date;
+    }
+    return steps;
+}
+
+/**
+ * @brief Returns the fixing dates without copying them.
+ *
+ * @return The fixing schedule of the Asian option.
+ */
+const FixingSchedule& AsianOption::getFixings() const {
     return _timeSteps;
 }
 
+/**
+ * @brief Season the option: set the valuation date and the fixings already observed.
+ * @details The fixings on or before the valuation date are known. Only their sum is
+ * kept: payoffPath() then expects a path over the remaining fixings only and folds the
+ * sum into the average, and getTimeSteps() returns the remaining fixing dates measured
+ * from the valuation date, so the engines simulate from the spot on the valuation date
+ * and never redraw the past. setPastFixings(0.0, {}) makes the option new again. Pricers
+ * already configured with the option must be reconfigured.
+ * @param valuation_date The valuation date, in [0, expiry).
+ * @param fixings The observed fixings, one per fixing date on or before the valuation date.
+ * @throws std::invalid_argument if the valuation date is out of range, the number of
+ * fixings does not match the schedule, or a fixing is not a positive finite price.
+ */
+void AsianOption::setPastFixings(double valuation_date, const std::vector<double>& fixings) {
+    if (!(valuation_date >= 0.0 && valuation_date < getExpiry())) {
+        throw std::invalid_argument("AsianOption: valuation date must be in [0, expiry)");
+    }
+    const std::size_t past = static_cast<std::size_t>(std::upper_bound(_timeSteps.begin(), _timeSteps.end(), valuation_date) - _timeSteps.begin());
+    if (fixings.size() != past) {
+        throw std::invalid_argument("AsianOption: one past fixing needed per fixing date up to the valuation date");
+    }
+    double sum = 0.0;
+    for (double fixing : fixings) {
+        if (!(fixing > 0.0) || !std::isfinite(fixing)) {
+            throw std::invalid_argument("AsianOption: past fixings must be positive prices");
+        }
+        sum += fixing;
+    }
+    _valuation_date = valuation_date;
+    _nb_past_fixings = past;
+    _past_fixing_sum = sum;
+}
+
+/**
+ * @return The valuation date, 0 for a new option.
+ */
+double AsianOption::getValuationDate() const {
+    return _valuation_date;
+}
+
+/**
+ * @return The number of fixings already observed.
+ */
+std::size_t AsianOption::getNbPastFixings() const {
+    return _nb_past_fixings;
+}
+
+/**
+ * @return The sum of the fixings already observed.
+ */
+double AsianOption::getPastFixingSum() const {
+    return _past_fixing_sum;
+}
+
 /**
  * @brief Calculates the payoff path for an Asian option.
  *
@@ -28,17 +111,21 @@ std::vector<double> AsianOption::getTimeSteps() const {
  * 
  * This function calculates the payoff path for an Asian option by
  * taking the average of the spot prices and then calling
- * the payoff function with this average.
+ * the payoff function with this average. For a seasoned option the path
+ * holds the remaining fixings only, and the past fixings join the average.
  */
 double AsianOption::payoffPath(const std::vector<double>& path) const {
     if (path.empty()) {
         throw std::invalid_argument("AsianOption: path cannot be empty");
     }
-    double sum = 0.0;
+    if (_nb_past_fixings > 0 && path.size() != _timeSteps.size() - _nb_past_fixings) {
+        throw std::invalid_argument("AsianOption: a seasoned option needs a path over its remaining fixings");
+    }
+    double sum = _past_fixing_sum;
     for (double price : path) {
         sum += price;
     }
-    const double avg = sum / path.size();
+    const double avg = sum / (_nb_past_fixings + path.size());
     return payoff(avg);
 }
 
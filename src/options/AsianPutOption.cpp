@@ -11,6 +11,16 @@
  */
 AsianPutOption::AsianPutOption(std::vector<double> timeSteps, double strike) : AsianOption(std::move(timeSteps)), _strike(strike) {}
 
+/**
+ * Allocator-extended constructor for AsianPutOption.
+ *
+ * The fixing dates are copied into a schedule allocated from alloc when they do not fit inline.
+ * @param timeSteps the time steps of the option.
+ * @param strike the strike price of the option.
+ * @param alloc the allocator of the fixing schedule.
+ */
+AsianPutOption::AsianPutOption(const std::vector<double>& timeSteps, double strike, const allocator_type& alloc) : AsianOption(timeSteps.data(), timeSteps.data() + timeSteps.size(), alloc), _strike(strike) {}
+
 /**
  * Returns the payoff of an Asian put option given the spot price.
  *
@@ -23,6 +33,15 @@ double AsianPutOption::payoff(double asset_price) const {
     return std::max(_strike - asset_price, 0.0);
 }
 
+/**
+ * @brief Returns the strike of the option.
+ *
+ * @return The strike the average is compared to.
+ */
+double AsianPutOption::getStrike() const {
+    return _strike;
+}
+
 /**
  * Returns the type of the option.
  *
@@ -14,4 +14,17 @@ OptionType CallOption::getOptionType() const { return OptionType::Call; }
  */
 double CallOption::payoff(double asset_price) const {
     return asset_price >= _strike ? asset_price - _strike : 0.0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief The payoff of a call option for many spot prices, as a branch-free loop.
+ *
+ * @param asset_prices The prices of the underlying asset.
+ * @param payoffs Output payoffs, one per price.
+ * @param n The number of prices.
+ */
+void CallOption::payoffBatch(const double* asset_prices, double* payoffs, std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+        payoffs[i] = asset_prices[i] >= _strike ? asset_prices[i] - _strike : 0.0;
+    }
+}
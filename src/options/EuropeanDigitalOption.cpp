@@ -22,3 +22,10 @@ EuropeanDigitalOption::EuropeanDigitalOption(double expiry, double strike) : Opt
 double EuropeanDigitalOption::getStrike() const {
     return _strike;
 }
+
+/**
+ * @return the strike, where the payoff jumps.
+ */
+std::vector<double> EuropeanDigitalOption::getPayoffKinks() const {
+    return {_strike};
+}
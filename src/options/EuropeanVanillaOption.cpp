@@ -22,3 +22,10 @@ EuropeanVanillaOption::EuropeanVanillaOption(double expiry, double strike) : Opt
 double EuropeanVanillaOption::getStrike() const {
     return _strike;
 }
+
+/**
+ * @return the strike, where the payoff has its kink.
+ */
+std::vector<double> EuropeanVanillaOption::getPayoffKinks() const {
+    return {_strike};
+}
@@ -33,6 +33,33 @@ double Option::payoffPath(const std::vector<double>& path) const {
     return payoff(path.back());
 }
 
+/**
+ * @brief Calculates the payoff for many spot prices at once.
+ * @details The default calls payoff() for each price; a payoff that is a simple formula
+ * can override it with a loop the compiler vectorizes.
+ * @param asset_prices The spot prices.
+ * @param payoffs Output payoffs, one per spot price.
+ * @param n The number of spot prices.
+ */
+void Option::payoffBatch(const double* asset_prices, double* payoffs, std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+        payoffs[i] = payoff(asset_prices[i]);
+    }
+}
+
+/**
+ * @brief Returns the spot prices where the payoff is not smooth (kinks and jumps).
+ * @details Quadrature engines split their integration domain there. A payoff that
+ * overrides payoff() with a kink or a jump must override this too: nothing checks it, and
+ * an undeclared kink is integrated as if smooth by GaussHermitePricer, whose price is
+ * then only accurate to a few 1e-2 (2e-2 on an at-the-money call worth 10, 6e-2 on a
+ * digital worth 0.5, with the default nodes) instead of to rounding.
+ * @return An empty vector: no kink is known.
+ */
+std::vector<double> Option::getPayoffKinks() const {
+    return {};
+}
+
 /**
  * @brief Returns true if the option is an Asian option.
  *
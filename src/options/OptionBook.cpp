@@ -0,0 +1,93 @@
+#include "OptionBook.h"
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t kDefaultBlockBytes = 64 * 1024;
+
+}
+
+/**
+ * @brief Construct an empty book of options backed by a monotonic arena.
+ * @details Every option added to the book, and every allocation it makes through its
+ * allocator, is carved out of the arena: loading a book is a sequence of pointer bumps
+ * and releasing it frees a handful of large blocks at once. The list of options itself
+ * is kept on the upstream resource so that its growth does not leave dead copies in the
+ * arena.
+ * @param initial_bytes The size of the first arena block, 0 for the resource default.
+ * Sizing it for the whole book avoids any further upstream allocation.
+ * @param upstream The resource the arena and the option list draw from.
+ */
+OptionBook::OptionBook(std::size_t initial_bytes, std::pmr::memory_resource* upstream)
+    : _arena(initial_bytes > 0 ? initial_bytes : kDefaultBlockBytes, upstream),
+      _options(upstream) {}
+
+/**
+ * @brief Destroy the options then release the arena.
+ */
+OptionBook::~OptionBook() {
+    destroyAll();
+}
+
+/**
+ * @brief Run the destructors of the options, last added first.
+ */
+void OptionBook::destroyAll() {
+    for (std::size_t i = _options.size(); i > 0; --i) {
+        _options[i - 1]->~Option();
+    }
+    _options.clear();
+}
+
+/**
+ * @brief Reserve room for n options in the option list.
+ * @param n The expected number of options.
+ */
+void OptionBook::reserve(std::size_t n) {
+    _options.reserve(n);
+}
+
+/**
+ * @return The number of options in the book.
+ */
+std::size_t OptionBook::size() const {
+    return _options.size();
+}
+
+/**
+ * @param i The position of the option in the book, in insertion order.
+ * @return The option.
+ * @throws std::out_of_range if i is not smaller than size().
+ */
+Option* OptionBook::operator[](std::size_t i) const {
+    if (i >= _options.size()) {
+        throw std::out_of_range("OptionBook: index out of range");
+    }
+    return _options[i];
+}
+
+/**
+ * @return The options of the book, in insertion order.
+ */
+const std::pmr::vector<Option*>& OptionBook::options() const {
+    return _options;
+}
+
+/**
+ * @return The arena of the book, to allocate data living as long as its options.
+ */
+std::pmr::memory_resource* OptionBook::resource() {
+    return &_arena;
+}
+
+/**
+ * @brief Destroy every option and release the arena in one go.
+ * @details Pointers previously returned by add() are invalidated. The option list keeps
+ * its capacity, so reloading a book of the same size does not reallocate it.
+ */
+void OptionBook::clear() {
+    destroyAll();
+    _arena.release();
+}
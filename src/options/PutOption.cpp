@@ -12,4 +12,17 @@ OptionType PutOption::getOptionType() const { return OptionType::Put; }
  */
 double PutOption::payoff(double asset_price) const {
     return _strike >= asset_price ? _strike - asset_price : 0.0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief The payoff of a put option for many spot prices, as a branch-free loop.
+ *
+ * @param asset_prices The prices of the underlying asset.
+ * @param payoffs Output payoffs, one per price.
+ * @param n The number of prices.
+ */
+void PutOption::payoffBatch(const double* asset_prices, double* payoffs, std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+        payoffs[i] = _strike >= asset_prices[i] ? _strike - asset_prices[i] : 0.0;
+    }
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "AmericanImpliedVolatility.h"
+#include "Black76Pricer.h"
+#include "CRRPricer.h"
+
+namespace {
+
+constexpr double kMinVol = 1e-4;
+constexpr double kMaxVol = 5.0;
+// relative bump used for the lattice vega
+constexpr double kVegaBump = 1e-4;
+// below this many quotes per thread the spawn cost dominates
+constexpr std::size_t kMinQuotesPerThread = 8;
+
+}
+
+/**
+ * @brief Construct an American implied volatility solver.
+ * @details The solver owns a rolling lattice buffer sized for the depth, reused by every
+ * lattice evaluation of every solve, so that an inversion does no allocation.
+ * @param depth The depth of the CRR tree used to price the American options.
+ * @param tolerance The absolute price tolerance of the inversion.
+ * @param max_iterations The maximum number of Newton iterations.
+ * @throws std::invalid_argument if depth or max_iterations is not positive or tolerance is not positive.
+ */
+AmericanImpliedVolatility::AmericanImpliedVolatility(int depth, double tolerance, int max_iterations) : _depth(depth), _tolerance(tolerance), _max_iterations(max_iterations) {
+    if (_depth <= 0 || _max_iterations <= 0 || !(_tolerance > 0.0)) {
+        throw std::invalid_argument("AmericanImpliedVolatility: invalid parameters");
+    }
+    _values.resize(_depth + 1);
+    _ratios.resize(_depth + 1);
+}
+
+/**
+ * @return The depth of the CRR tree.
+ */
+int AmericanImpliedVolatility::getDepth() const {
+    return _depth;
+}
+
+/**
+ * @brief Price an option on the CRR tree of CRRPricer(option, depth, S0, r, volatility).
+ * @details Backward induction on a single rolling level held in the preallocated buffer:
+ * node i of level n is overwritten in place once its two children have been read.
+ */
+double AmericanImpliedVolatility::latticePrice(const AmericanOption* option, double S0, double r, double volatility) {
+    double U = 0.0;
+    double D = 0.0;
+    double R = 0.0;
+    CRRPricer::treeFactors(option->getExpiry(), _depth, r, volatility, U, D, R);
+    if (!(D < R && R < U)) {
+        throw std::invalid_argument("AmericanImpliedVolatility: need D < R < U");
+    }
+    const double q = (R - D) / (U - D);
+    const double pu = q / R;
+    const double pd = (1.0 - q) / R;
+    const double ratio = U / D;
+
+    double* values = _values.data();
+    double* ratios = _ratios.data();
+    ratios[0] = 1.0;
+    for (int i = 1; i <= _depth; ++i) {
+        ratios[i] = ratios[i - 1] * ratio;
+    }
+
+    double dn = std::pow(D, _depth);
+    for (int i = 0; i <= _depth; ++i) {
+        values[i] = option->payoff(S0 * dn * ratios[i]);
+    }
+    for (int n = _depth - 1; n >= 0; --n) {
+        dn /= D;
+        const double s_n = S0 * dn;
+        for (int i = 0; i <= n; ++i) {
+            const double cont = pu * values[i + 1] + pd * values[i];
+            const double intrinsic = option->payoff(s_n * ratios[i]);
+            values[i] = intrinsic >= cont ? intrinsic : cont;
+        }
+    }
+    return values[0];
+}
+
+/**
+ * @brief Volatility of the European option with the same strike and type quoted at price.
+ * @details Safeguarded Newton on the Black-Scholes price. The early exercise premium makes
+ * it an upper estimate of the American volatility for puts and the exact one for calls.
+ * Quotes outside the European price range fall back to a mid-range volatility.
+ */
+double AmericanImpliedVolatility::europeanGuess(const AmericanOption* option, double price, double S0, double r) const {
+    const double T = option->getExpiry();
+    const double K = option->getStrike();
+    const OptionType type = option->getOptionType();
+    const double disc = std::exp(-r * T);
+    const double forward = S0 / disc;
+    const double sqrt_T = std::sqrt(T);
+
+    double lo = kMinVol;
+    double hi = kMaxVol;
+    if (price <= Black76Pricer::price(type, false, forward, K, disc, lo * sqrt_T) || price >= Black76Pricer::price(type, false, forward, K, disc, hi * sqrt_T)) {
+        return 0.2;
+    }
+    double sigma = std::clamp(std::sqrt(2.0 * M_PI / T) * price / S0, lo, hi);
+    for (int iter = 0; iter < 50; ++iter) {
+        const double stdev = sigma * sqrt_T;
+        const double diff = Black76Pricer::price(type, false, forward, K, disc, stdev) - price;
+        if (std::fabs(diff) < 1e-10) {
+            break;
+        }
+        if (diff > 0.0) {
+            hi = sigma;
+        } else {
+            lo = sigma;
+        }
+        const double d1 = std::log(forward / K) / stdev + 0.5 * stdev;
+        const double vega = disc * forward * NormalDistribution::pdf(d1) * sqrt_T;
+        double next = vega > 0.0 ? sigma - diff / vega : 0.5 * (lo + hi);
+        if (!(next > lo && next < hi)) {
+            next = 0.5 * (lo + hi);
+        }
+        sigma = next;
+    }
+    return sigma;
+}
+
+/**
+ * @brief Invert an American option price for the volatility.
+ * @details Starts from the European-equivalent volatility and takes Newton steps with the
+ * vega of the lattice itself (relative bump of the same tree), so that the solution is
+ * exactly consistent with CRRPricer at this depth. The price is increasing in the
+ * volatility, so the residual signs maintain a bracket and any step leaving it is
+ * replaced by a bisection.
+ * @param option The American option quoted.
+ * @param price The quoted price.
+ * @param S0 The spot of the underlying.
+ * @param r The interest rate of the risk-free asset.
+ * @return The implied volatility.
+ * @throws std::invalid_argument if the option is null or the price is not attainable in
+ * [1e-4, 5] or the solver does not converge.
+ */
+double AmericanImpliedVolatility::solve(const AmericanOption* option, double price, double S0, double r) {
+    if (!option) {
+        throw std::invalid_argument("AmericanImpliedVolatility: option pointer must not be null");
+    }
+    if (S0 <= 0.0 || option->getExpiry() <= 0.0) {
+        throw std::invalid_argument("AmericanImpliedVolatility: invalid parameters");
+    }
+    if (price < option->payoff(S0) - _tolerance) {
+        throw std::invalid_argument("AmericanImpliedVolatility: price below intrinsic value");
+    }
+
+    double lo = kMinVol;
+    double hi = kMaxVol;
+    double sigma = std::clamp(europeanGuess(option, price, S0, r), 2.0 * kMinVol, 0.5 * kMaxVol);
+    for (int iter = 0; iter < _max_iterations; ++iter) {
+        const double diff = latticePrice(option, S0, r, sigma) - price;
+        if (std::fabs(diff) < _tolerance) {
+            return sigma;
+        }
+        if (diff > 0.0) {
+            hi = sigma;
+        } else {
+            lo = sigma;
+        }
+        if (hi - lo < 1e-12) {
+            break;
+        }
+        const double h = kVegaBump * sigma;
+        const double vega = (latticePrice(option, S0, r, sigma + h) - price - diff) / h;
+        double next = vega > 0.0 ? sigma - diff / vega : 0.5 * (lo + hi);
+        if (!(next > lo && next < hi)) {
+            next = 0.5 * (lo + hi);
+        }
+        sigma = next;
+    }
+    throw std::invalid_argument("AmericanImpliedVolatility: no volatility reproduces the price");
+}
+
+/**
+ * @brief Invert a batch of American quotes on the same underlying, in parallel.
+ * @details Builds a pool of solvers, one per worker thread, and runs the pooled overload.
+ * Callers inverting chains repeatedly should keep their own pool instead.
+ * @param options The American options quoted.
+ * @param prices The quoted prices, one per option.
+ * @param S0 The spot of the underlying.
+ * @param r The interest rate of the risk-free asset.
+ * @param depth The depth of the CRR tree.
+ * @param nb_threads The number of worker threads, 0 to use the hardware concurrency.
+ * @return The implied volatilities, NaN for quotes that cannot be inverted.
+ * @throws std::invalid_argument if options and prices differ in size or depth is not positive.
+ */
+std::vector<double> AmericanImpliedVolatility::solve(const std::vector<const AmericanOption*>& options, const std::vector<double>& prices, double S0, double r, int depth, unsigned nb_threads) {
+    PricerPool<AmericanImpliedVolatility> pool(nb_threads, depth);
+    return solve(pool, options, prices, S0, r);
+}
+
+/**
+ * @brief Invert a batch of American quotes on the same underlying with a pool of solvers.
+ * @details Quotes are split in contiguous ranges, one per worker thread, each worker
+ * using its own solver and hence its own lattice buffer for all its quotes.
+ * @param pool The solvers, one per worker thread.
+ * @param options The American options quoted.
+ * @param prices The quoted prices, one per option.
+ * @param S0 The spot of the underlying.
+ * @param r The interest rate of the risk-free asset.
+ * @return The implied volatilities, NaN for quotes that cannot be inverted.
+ * @throws std::invalid_argument if options and prices differ in size.
+ */
+std::vector<double> AmericanImpliedVolatility::solve(PricerPool<AmericanImpliedVolatility>& pool, const std::vector<const AmericanOption*>& options, const std::vector<double>& prices, double S0, double r) {
+    if (options.size() != prices.size()) {
+        throw std::invalid_argument("AmericanImpliedVolatility: options and prices must have the same size");
+    }
+    std::vector<double> vols(options.size(), std::numeric_limits<double>::quiet_NaN());
+    pool.forEach(options.size(), [&](AmericanImpliedVolatility& solver, std::size_t j) {
+        try {
+            vols[j] = solver.solve(options[j], prices[j], S0, r);
+        } catch (const std::invalid_argument&) {
+            // left as NaN
+        }
+    }, kMinQuotesPerThread);
+    return vols;
+}
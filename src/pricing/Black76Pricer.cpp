@@ -0,0 +1,67 @@
+#include <cmath>
+#include <stdexcept>
+#include "Black76Pricer.h"
+
+/**
+ * @brief Construct a Black-76 pricer for a vanilla option on a forward or a future.
+ * @param option The option to be priced.
+ * @param forward The forward (or futures) price for the expiry of the option.
+ * @param discount_factor The discount factor from the expiry of the option to today.
+ * @param volatility The volatility of the forward.
+ * @throws std::invalid_argument if a parameter is not positive or the option is null.
+ */
+Black76Pricer::Black76Pricer(EuropeanVanillaOption* option, double forward, double discount_factor, double volatility) : _option(option), _strike(option ? option->getStrike() : 0), _forward(forward), _discount_factor(discount_factor), _volatility(volatility), _is_digital(false) {
+    if (_forward <= 0.0 || _discount_factor <= 0.0 || _volatility <= 0.0 || _option == nullptr || _strike <= 0.0) {
+        throw std::invalid_argument("Black76Pricer: invalid parameters");
+    }
+}
+
+/**
+ * @brief Construct a Black-76 pricer for a cash-or-nothing digital option on a forward.
+ * @param option The option to be priced.
+ * @param forward The forward (or futures) price for the expiry of the option.
+ * @param discount_factor The discount factor from the expiry of the option to today.
+ * @param volatility The volatility of the forward.
+ * @throws std::invalid_argument if a parameter is not positive or the option is null.
+ */
+Black76Pricer::Black76Pricer(EuropeanDigitalOption* option, double forward, double discount_factor, double volatility) : _digital_option(option), _strike(option ? option->getStrike() : 0), _forward(forward), _discount_factor(discount_factor), _volatility(volatility), _is_digital(true) {
+    if (_forward <= 0.0 || _discount_factor <= 0.0 || _volatility <= 0.0 || _digital_option == nullptr || _strike <= 0.0) {
+        throw std::invalid_argument("Black76Pricer: invalid parameters");
+    }
+}
+
+double Black76Pricer::stdDev() const {
+    const double T = _is_digital ? _digital_option->getExpiry() : _option->getExpiry();
+    return _volatility * std::sqrt(T);
+}
+
+/**
+ * @brief Return the price of the option using the Black-76 model.
+ * @return The price of the option.
+ *
+ * An expired option is worth its discounted payoff on the forward.
+ */
+double Black76Pricer::price() const {
+    const OptionType type = _is_digital ? _digital_option->getOptionType() : _option->getOptionType();
+    return price(type, _is_digital, _forward, _strike, _discount_factor, stdDev());
+}
+
+/**
+ * @brief Return the sensitivity of the price to the forward.
+ * @return The forward delta of the option, discount factor included.
+ */
+double Black76Pricer::delta() const {
+    const OptionType type = _is_digital ? _digital_option->getOptionType() : _option->getOptionType();
+    return delta(type, _is_digital, _forward, _strike, _discount_factor, stdDev());
+}
+
+/**
+ * @brief Calculate the price of the option using the Black-76 model.
+ *
+ * @return The price of the option.
+ *
+ * This function is an alias for the price() function.
+ */
+double Black76Pricer::operator()() const {
+    return price();
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "BlackScholesBatch.h"
+#include "Black76Pricer.h"
+#include "NormalDistribution.h"
+
+/**
+ * @return The number of options in the batch.
+ */
+std::size_t BlackScholesBatchInput::size() const {
+    return spot.size();
+}
+
+/**
+ * @brief Reserve room for n options in every column.
+ * @param n The expected number of options.
+ */
+void BlackScholesBatchInput::reserve(std::size_t n) {
+    type.reserve(n);
+    is_digital.reserve(n);
+    spot.reserve(n);
+    strike.reserve(n);
+    expiry.reserve(n);
+    rate.reserve(n);
+    volatility.reserve(n);
+}
+
+/**
+ * @brief Append an option and its market to the batch.
+ * @param option_type Call or put.
+ * @param digital True for a cash-or-nothing digital paying 1, false for a vanilla.
+ * @param asset_price The price of the underlying asset.
+ * @param option_strike The strike of the option.
+ * @param option_expiry The time to expiry of the option.
+ * @param interest_rate The interest rate of the risk-free asset.
+ * @param option_volatility The volatility of the underlying asset.
+ * @throws std::invalid_argument if the parameters are rejected by BlackScholesPricer.
+ */
+void BlackScholesBatchInput::add(OptionType option_type, bool digital, double asset_price, double option_strike, double option_expiry, double interest_rate, double option_volatility) {
+    if (asset_price <= 0.0 || option_volatility <= 0.0 || option_strike <= 0.0 || option_expiry < 0.0) {
+        throw std::invalid_argument("BlackScholesBatchInput: invalid parameters");
+    }
+    type.push_back(option_type);
+    is_digital.push_back(digital ? 1 : 0);
+    spot.push_back(asset_price);
+    strike.push_back(option_strike);
+    expiry.push_back(option_expiry);
+    rate.push_back(interest_rate);
+    volatility.push_back(option_volatility);
+}
+
+/**
+ * @brief Resize every greek column to n entries.
+ * @param n The number of options.
+ */
+void BlackScholesGreeks::resize(std::size_t n) {
+    price.resize(n);
+    delta.resize(n);
+    gamma.resize(n);
+    vega.resize(n);
+    theta.resize(n);
+    rho.resize(n);
+    vanna.resize(n);
+    volga.resize(n);
+}
+
+/**
+ * @brief Price every option of the batch with the Black-Scholes model.
+ * @param input The batch of options.
+ * @param prices Output prices, resized to the batch size.
+ */
+void BlackScholesBatch::price(const BlackScholesBatchInput& input, std::vector<double>& prices) {
+    prices.resize(input.size());
+    price(input, prices.data(), 0, input.size());
+}
+
+/**
+ * @brief Price the options [begin, end) of the batch with the Black-Scholes model.
+ * @details Same conventions as BlackScholesPricer::price(), written over flat columns
+ * without virtual calls so that ranges can be handed to separate threads. Each option is
+ * mapped to its forward and discount factor and priced by the Black-76 core. The discount
+ * factor, sqrt(T) and the forward only depend on the expiry level, so they are kept from
+ * one option to the next: a chain sorted by expiry computes them once per expiry.
+ * @param input The batch of options.
+ * @param prices Output array indexed like the batch.
+ * @param begin The first option to price.
+ * @param end One past the last option to price.
+ */
+void BlackScholesBatch::price(const BlackScholesBatchInput& input, double* prices, std::size_t begin, std::size_t end) {
+    double cached_T = -1.0;
+    double cached_r = 0.0;
+    double cached_S = 0.0;
+    double disc = 1.0;
+    double sqrt_T = 0.0;
+    double forward = 0.0;
+    for (std::size_t j = begin; j < end; ++j) {
+        const double S = input.spot[j];
+        const double K = input.strike[j];
+        const double T = input.expiry[j];
+        const bool digital = input.is_digital[j] != 0;
+        if (T <= 0.0) {
+            const double w = input.type[j] == OptionType::Call ? 1.0 : -1.0;
+            if (digital) {
+                prices[j] = w * (S - K) >= 0.0 ? 1.0 : 0.0;
+            } else {
+                prices[j] = std::max(w * (S - K), 0.0);
+            }
+            continue;
+        }
+        const double r = input.rate[j];
+        if (T != cached_T || r != cached_r) {
+            disc = std::exp(-r * T);
+            sqrt_T = std::sqrt(T);
+            cached_T = T;
+            cached_r = r;
+            cached_S = 0.0;
+        }
+        if (S != cached_S) {
+            forward = S / disc;
+            cached_S = S;
+        }
+        prices[j] = Black76Pricer::price(input.type[j], digital, forward, K, disc, input.volatility[j] * sqrt_T);
+    }
+}
+
+/**
+ * @brief Compute the price and all first and second order greeks of every option of the batch.
+ * @param input The batch of options.
+ * @param greeks Output greeks, resized to the batch size.
+ */
+void BlackScholesBatch::greeks(const BlackScholesBatchInput& input, BlackScholesGreeks& greeks) {
+    greeks.resize(input.size());
+    BlackScholesBatch::greeks(input, greeks, 0, input.size());
+}
+
+/**
+ * @brief Compute the price and greeks of the options [begin, end) of the batch.
+ * @details Every greek is computed from the same d1, d2, discount factor and densities.
+ * Theta is the derivative with respect to calendar time (per year), rho with respect to
+ * the rate, vanna is d(delta)/d(sigma) and volga is d(vega)/d(sigma).
+ * Expiry-level quantities are cached as in price().
+ * Expired options get their payoff as price, the delta of BlackScholesPricer and zero
+ * for every other greek.
+ * @param input The batch of options.
+ * @param greeks Output greeks, already sized to the batch.
+ * @param begin The first option to compute.
+ * @param end One past the last option to compute.
+ */
+void BlackScholesBatch::greeks(const BlackScholesBatchInput& input, BlackScholesGreeks& greeks, std::size_t begin, std::size_t end) {
+    price(input, greeks.price.data(), begin, end);
+    double cached_T = -1.0;
+    double cached_r = 0.0;
+    double disc = 1.0;
+    double sqrt_T = 0.0;
+    for (std::size_t j = begin; j < end; ++j) {
+        const double S = input.spot[j];
+        const double K = input.strike[j];
+        const double T = input.expiry[j];
+        const double w = input.type[j] == OptionType::Call ? 1.0 : -1.0;
+        const bool digital = input.is_digital[j] != 0;
+        if (T <= 0.0) {
+            greeks.delta[j] = (digital || w * (S - K) <= 0.0) ? 0.0 : w;
+            greeks.gamma[j] = 0.0;
+            greeks.vega[j] = 0.0;
+            greeks.theta[j] = 0.0;
+            greeks.rho[j] = 0.0;
+            greeks.vanna[j] = 0.0;
+            greeks.volga[j] = 0.0;
+            continue;
+        }
+        const double r = input.rate[j];
+        if (T != cached_T || r != cached_r) {
+            disc = std::exp(-r * T);
+            sqrt_T = std::sqrt(T);
+            cached_T = T;
+            cached_r = r;
+        }
+        const double sigma = input.volatility[j];
+        const double sigma_sqrt_T = sigma * sqrt_T;
+        const double log_moneyness = std::log(S / K);
+        const double d1 = (log_moneyness + (r + 0.5 * sigma * sigma) * T) / sigma_sqrt_T;
+        const double d2 = d1 - sigma_sqrt_T;
+        const double value = greeks.price[j];
+
+        if (digital) {
+            const double dens = disc * NormalDistribution::pdf(d2);
+            const double dd2_dT = ((r - 0.5 * sigma * sigma) - log_moneyness / T) / (2.0 * sigma_sqrt_T);
+            greeks.delta[j] = w * dens / (S * sigma_sqrt_T);
+            greeks.gamma[j] = -w * dens * d1 / (S * S * sigma * sigma * T);
+            greeks.vega[j] = -w * dens * d1 / sigma;
+            greeks.theta[j] = r * value - w * dens * dd2_dT;
+            greeks.rho[j] = -T * value + w * dens * sqrt_T / sigma;
+            greeks.vanna[j] = w * dens * (d1 * d2 - 1.0) / (S * sigma * sigma_sqrt_T);
+            greeks.volga[j] = w * dens * (d1 + d2 - d1 * d1 * d2) / (sigma * sigma);
+            continue;
+        }
+
+        const double pdf_d1 = NormalDistribution::pdf(d1);
+        const double cdf_wd2 = NormalDistribution::cdf(w * d2);
+        const double vega = S * pdf_d1 * sqrt_T;
+        greeks.delta[j] = w * NormalDistribution::cdf(w * d1);
+        greeks.gamma[j] = pdf_d1 / (S * sigma_sqrt_T);
+        greeks.vega[j] = vega;
+        greeks.theta[j] = -S * pdf_d1 * sigma / (2.0 * sqrt_T) - w * r * K * disc * cdf_wd2;
+        greeks.rho[j] = w * K * T * disc * cdf_wd2;
+        greeks.vanna[j] = -pdf_d1 * d2 / sigma;
+        greeks.volga[j] = vega * d1 * d2 / sigma;
+    }
+}
@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <typeinfo>
+#include "BlackScholesMCBatch.h"
+#include "CallOption.h"
+#include "MT.h"
+#include "PutOption.h"
+
+namespace {
+
+// adding then subtracting 1.5 * 2^52 rounds to the nearest integer, which is left in the
+// low bits of the sum
+constexpr double kShifter = 6755399441055744.0;
+constexpr double kLog2e = 1.4426950408889634;
+constexpr double kLn2Hi = 0.6931471803691238;
+constexpr double kLn2Lo = 1.9082149292705877e-10;
+// beyond these the exponent field of 2^k would wrap around: arguments are clamped to them
+constexpr double kExpMin = -708.0;
+constexpr double kExpMax = 709.0;
+
+/*
+ * exp(x) for |x| < 708 within a few ulps, written with arithmetic and integer bit
+ * operations only so that a loop over lanes vectorizes, which a call to std::exp prevents:
+ * x = k ln 2 + r with |r| <= ln 2 / 2, exp(r) by its Taylor series to degree 13 and 2^k
+ * built in the exponent field. x is first clamped to [kExpMin, kExpMax], a min and a max
+ * that vectorize, so a path whose log-return leaves that range saturates at about
+ * 3e-308 or 8e307 instead of getting a garbage exponent.
+ */
+inline double expLane(double x) {
+    x = std::min(std::max(x, kExpMin), kExpMax);
+    const double shifted = x * kLog2e + kShifter;
+    const double k = shifted - kShifter;
+    const double r = (x - k * kLn2Hi) - k * kLn2Lo;
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+    std::uint64_t shifted_bits = 0;
+    std::uint64_t shifter_bits = 0;
+    std::memcpy(&shifted_bits, &shifted, sizeof(double));
+    std::memcpy(&shifter_bits, &kShifter, sizeof(double));
+    const std::uint64_t scale_bits = (shifted_bits - shifter_bits + 1023) << 52;
+    double scale = 0.0;
+    std::memcpy(&scale, &scale_bits, sizeof(double));
+    return p * scale;
+}
+
+}
+
+/**
+ * @brief Construct an empty batch.
+ */
+BlackScholesMCBatch::BlackScholesMCBatch() = default;
+
+/**
+ * @brief Append a contract and its market to the batch.
+ * @details Same inputs, checks and time grid as BlackScholesMCPricer: an Asian option is
+ * simulated on its fixings, any other option on its expiry. Calls and puts are paid off
+ * inline; other options go through payoffPath() on their simulated path.
+ * @param option The option to be priced, which must outlive the batch.
+ * @param initial_price The initial price of the underlying asset.
+ * @param interest_rate The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ * @return The index of the contract in the batch.
+ * @throws std::invalid_argument if the option is null or its time steps are empty or not increasing.
+ */
+std::size_t BlackScholesMCBatch::add(Option* option, double initial_price, double interest_rate, double volatility) {
+    if (!option) {
+        throw std::invalid_argument("BlackScholesMCBatch: option pointer must not be null");
+    }
+    const std::vector<double> time_steps = option->isAsianOption() ? option->getTimeSteps() : std::vector<double>{option->getExpiry()};
+    if (time_steps.empty()) {
+        throw std::invalid_argument("BlackScholesMCBatch: need at least one time step");
+    }
+    double last_t = 0.0;
+    for (double t : time_steps) {
+        if (t - last_t <= 0.0) {
+            throw std::invalid_argument("BlackScholesMCBatch: time steps must be increasing");
+        }
+        last_t = t;
+    }
+
+    Contract contract{option, initial_price, std::exp(-interest_rate * last_t), Payoff::Path, 1.0, 0.0, time_steps.size(),
+                      _drift_dt.size(), 0, 0.0, 0.0};
+    const std::type_info& type = typeid(*option);
+    if (type == typeid(CallOption) || type == typeid(PutOption)) {
+        const EuropeanVanillaOption* vanilla = static_cast<const EuropeanVanillaOption*>(option);
+        contract.payoff = Payoff::Vanilla;
+        contract.w = vanilla->getOptionType() == OptionType::Call ? 1.0 : -1.0;
+        contract.strike = vanilla->getStrike();
+    }
+
+    const double drift = interest_rate - 0.5 * volatility * volatility;
+    last_t = 0.0;
+    for (double t : time_steps) {
+        _drift_dt.push_back(drift * (t - last_t));
+        _vol_sqrt_dt.push_back(volatility * std::sqrt(t - last_t));
+        last_t = t;
+    }
+    _contracts.push_back(contract);
+    _grouped = false;
+    return _contracts.size() - 1;
+}
+
+/**
+ * @return The number of contracts in the batch.
+ */
+std::size_t BlackScholesMCBatch::size() const {
+    return _contracts.size();
+}
+
+/**
+ * @brief Reserve room for n contracts.
+ * @param n The expected number of contracts.
+ */
+void BlackScholesMCBatch::reserve(std::size_t n) {
+    _contracts.reserve(n);
+}
+
+/**
+ * @brief Remove every contract, keeping the buffers for the next batch.
+ */
+void BlackScholesMCBatch::clear() {
+    _contracts.clear();
+    _drift_dt.clear();
+    _vol_sqrt_dt.clear();
+    _groups.clear();
+    _grouped = false;
+}
+
+/**
+ * @brief Sort the contracts by number of time steps into groups of at most kLanes.
+ * @details Each group gets step-major tables of its lanes' increments, with neutral
+ * values (no drift, no volatility) in the unused lanes of the last group of a step count.
+ */
+void BlackScholesMCBatch::group() {
+    std::vector<std::size_t> order(_contracts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return _contracts[a].steps < _contracts[b].steps; });
+
+    _groups.clear();
+    _lane_drift.clear();
+    _lane_vol.clear();
+    _lane_growth2.clear();
+    std::size_t max_steps = 0;
+    for (std::size_t first = 0; first < order.size();) {
+        Group group{};
+        group.steps = _contracts[order[first]].steps;
+        group.table = _lane_drift.size();
+        while (group.lanes < kLanes && first < order.size() && _contracts[order[first]].steps == group.steps) {
+            group.contracts[group.lanes++] = order[first++];
+        }
+        _lane_drift.resize(group.table + group.steps * kLanes, 0.0);
+        _lane_vol.resize(group.table + group.steps * kLanes, 0.0);
+        _lane_growth2.resize(group.table + group.steps * kLanes, 1.0);
+        for (std::size_t l = 0; l < group.lanes; ++l) {
+            const Contract& contract = _contracts[group.contracts[l]];
+            for (std::size_t k = 0; k < group.steps; ++k) {
+                const std::size_t lane = group.table + k * kLanes + l;
+                _lane_drift[lane] = _drift_dt[contract.table + k];
+                _lane_vol[lane] = _vol_sqrt_dt[contract.table + k];
+                _lane_growth2[lane] = std::exp(2.0 * _drift_dt[contract.table + k]);
+            }
+        }
+        max_steps = std::max(max_steps, group.steps);
+        _groups.push_back(group);
+    }
+    _normals.resize(max_steps * kLanes);
+    _paths.resize(2 * max_steps * kLanes);
+    _grouped = true;
+}
+
+/**
+ * @brief Add nb_paths paths to every contract of the batch.
+ * @details Contracts with the same number of time steps are simulated kLanes at a time in
+ * lockstep, one contract per lane, each with its own drift and volatility table and its
+ * own normal draws. The lane loops are branch-free arithmetic (the exponential included)
+ * and vectorize, and the per-contract setup of BlackScholesMCPricer is paid once per batch.
+ * As in BlackScholesMCPricer, paths come in antithetic pairs and the estimators are
+ * updated with Welford's algorithm.
+ * @param nb_paths The number of paths to add to each contract.
+ */
+void BlackScholesMCBatch::generate(int nb_paths) {
+    if (nb_paths <= 0) {
+        return;
+    }
+    if (!_grouped) {
+        group();
+    }
+    for (const Group& group : _groups) {
+        simulate(group, nb_paths);
+    }
+}
+
+/**
+ * @brief Simulate nb_paths paths of the contracts of one group.
+ */
+void BlackScholesMCBatch::simulate(const Group& group, int nb_paths) {
+    const std::size_t steps = group.steps;
+    bool store_paths = false;
+    double initial[kLanes];
+    double w[kLanes];
+    double strike[kLanes];
+    for (std::size_t l = 0; l < kLanes; ++l) {
+        initial[l] = 1.0;
+        w[l] = 0.0;
+        strike[l] = 0.0;
+    }
+    for (std::size_t l = 0; l < group.lanes; ++l) {
+        const Contract& contract = _contracts[group.contracts[l]];
+        initial[l] = contract.initial_price;
+        w[l] = contract.w;
+        strike[l] = contract.strike;
+        store_paths = store_paths || contract.payoff == Payoff::Path;
+    }
+
+    const double* lane_drift = _lane_drift.data() + group.table;
+    const double* lane_vol = _lane_vol.data() + group.table;
+    const double* lane_growth2 = _lane_growth2.data() + group.table;
+    double* z = _normals.data();
+    double* paths_pos = _paths.data();
+    double* paths_neg = paths_pos + steps * kLanes;
+    double s_pos[kLanes];
+    double s_neg[kLanes];
+    double vanilla_pos[kLanes];
+    double vanilla_neg[kLanes];
+
+    int generated = 0;
+    while (generated < nb_paths) {
+        MT::fill_normal(z, steps * kLanes);
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            s_pos[l] = initial[l];
+            s_neg[l] = initial[l];
+        }
+        for (std::size_t k = 0; k < steps; ++k) { // both paths of every lane
+            const double* drift = lane_drift + k * kLanes;
+            const double* vol = lane_vol + k * kLanes;
+            const double* growth2 = lane_growth2 + k * kLanes;
+            const double* zk = z + k * kLanes;
+            for (std::size_t l = 0; l < kLanes; ++l) {
+                const double up = expLane(drift[l] + vol[l] * zk[l]);
+                s_pos[l] *= up;
+                s_neg[l] *= growth2[l] / up; // exp(drift - vol z)
+            }
+            if (store_paths) {
+                for (std::size_t l = 0; l < kLanes; ++l) {
+                    paths_pos[l * steps + k] = s_pos[l];
+                    paths_neg[l * steps + k] = s_neg[l];
+                }
+            }
+        }
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            vanilla_pos[l] = std::max(w[l] * (s_pos[l] - strike[l]), 0.0);
+            vanilla_neg[l] = std::max(w[l] * (s_neg[l] - strike[l]), 0.0);
+        }
+
+        const bool pair = generated + 1 < nb_paths; // add negative path if nb_paths is odd
+        for (std::size_t l = 0; l < group.lanes; ++l) {
+            Contract& contract = _contracts[group.contracts[l]];
+            if (contract.payoff == Payoff::Vanilla) {
+                record(contract, contract.discount * vanilla_pos[l]);
+                if (pair) {
+                    record(contract, contract.discount * vanilla_neg[l]);
+                }
+                continue;
+            }
+            _path.assign(paths_pos + l * steps, paths_pos + (l + 1) * steps);
+            record(contract, contract.discount * contract.option->payoffPath(_path));
+            if (pair) {
+                _path.assign(paths_neg + l * steps, paths_neg + (l + 1) * steps);
+                record(contract, contract.discount * contract.option->payoffPath(_path));
+            }
+        }
+        generated += pair ? 2 : 1;
+    }
+}
+
+/**
+ * @brief Add one discounted payoff to the estimator of a contract (Welford's algorithm).
+ */
+void BlackScholesMCBatch::record(Contract& contract, double payoff_discounted) {
+    contract.nb_paths++;
+    const double delta = payoff_discounted - contract.estimate;
+    contract.estimate += delta / static_cast<double>(contract.nb_paths);
+    contract.M2 += delta * (payoff_discounted - contract.estimate);
+}
+
+/**
+ * @throws std::out_of_range if j is not a contract of the batch.
+ */
+const BlackScholesMCBatch::Contract& BlackScholesMCBatch::contractAt(std::size_t j) const {
+    if (j >= _contracts.size()) {
+        throw std::out_of_range("BlackScholesMCBatch: contract index out of range");
+    }
+    return _contracts[j];
+}
+
+/**
+ * @param j The index of the contract.
+ * @return The number of paths simulated for contract j.
+ * @throws std::out_of_range if j is not a contract of the batch.
+ */
+int BlackScholesMCBatch::getNbPaths(std::size_t j) const {
+    return contractAt(j).nb_paths;
+}
+
+/**
+ * @param j The index of the contract.
+ * @return The estimated price of contract j.
+ * @throws std::out_of_range if j is not a contract of the batch.
+ * @throws std::logic_error if no path has been generated for contract j.
+ */
+double BlackScholesMCBatch::price(std::size_t j) const {
+    const Contract& c = contractAt(j);
+    if (c.nb_paths == 0) {
+        throw std::logic_error("BlackScholesMCBatch: call generate() before requesting price");
+    }
+    return c.estimate;
+}
+
+/**
+ * @param j The index of the contract.
+ * @return The lower and upper bounds of the 95% confidence interval of the price of contract j.
+ * @throws std::out_of_range if j is not a contract of the batch.
+ * @throws std::logic_error if fewer than two paths have been generated for contract j.
+ */
+std::vector<double> BlackScholesMCBatch::confidenceInterval(std::size_t j) const {
+    const Contract& c = contractAt(j);
+    if (c.nb_paths < 2) {
+        throw std::logic_error("BlackScholesMCBatch: need at least two paths for confidence interval");
+    }
+    const double variance = c.M2 / static_cast<double>(c.nb_paths - 1);
+    const double std_err = std::sqrt(variance / static_cast<double>(c.nb_paths));
+    const double z = 1.96;
+    return {c.estimate - z * std_err, c.estimate + z * std_err};
+}
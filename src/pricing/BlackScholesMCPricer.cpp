@@ -1,10 +1,45 @@
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include <vector>
+#include "AsianOption.h"
 #include "BlackScholesMCPricer.h"
 #include "MT.h"
 
+namespace {
 
+// 97.5% quantiles of Student's t with 1 to 30 degrees of freedom
+constexpr double kStudent975[30] = {12.706204736, 4.302652730, 3.182446305, 2.776445105, 2.570581836, 2.446911851,
+                                    2.364624252,  2.306004135, 2.262157163, 2.228138852, 2.200985160, 2.178812830,
+                                    2.160368656,  2.144786688, 2.131449546, 2.119905299, 2.109815578, 2.100922040,
+                                    2.093024054,  2.085963447, 2.079613845, 2.073873068, 2.068657610, 2.063898562,
+                                    2.059538553,  2.055529439, 2.051830516, 2.048407142, 2.045229642, 2.042272456};
+
+// half-width of a two-sided 95% interval in standard errors, with dof degrees of freedom:
+// tabulated up to 30, then the Cornish-Fisher expansion around the normal quantile
+// (Abramowitz and Stegun 26.7.5), within 3e-8 of the exact value
+double studentQuantile975(std::size_t dof) {
+    if (dof <= 30) {
+        return kStudent975[dof - 1];
+    }
+    const double z = 1.959963984540054;
+    const double z2 = z * z;
+    const double g1 = z * (z2 + 1.0) / 4.0;
+    const double g2 = z * ((5.0 * z2 + 16.0) * z2 + 3.0) / 96.0;
+    const double g3 = z * (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) / 384.0;
+    const double g4 = z * ((((79.0 * z2 + 776.0) * z2 + 1482.0) * z2 - 1920.0) * z2 - 945.0) / 92160.0;
+    const double x = 1.0 / static_cast<double>(dof);
+    return z + x * (g1 + x * (g2 + x * (g3 + x * g4)));
+}
+
+}
+
+/**
+ * @brief Construct an unconfigured BlackScholesMCPricer instance.
+ * @details The pricer must be given an option and a market by reconfigure() before use.
+ * This is meant for pricers kept in a pool and reused across many options.
+ */
+BlackScholesMCPricer::BlackScholesMCPricer() = default;
 
 /**
  * @brief Construct a BlackScholesMCPricer instance.
@@ -18,40 +53,83 @@
  * @param interest_rate The interest rate of the risk-free asset.
  * @param volatility The volatility of the underlying asset.
  */
-BlackScholesMCPricer::BlackScholesMCPricer(Option* option, double initial_price, double interest_rate, double volatility) : _option(option), _initial_price(initial_price), _interest_rate(interest_rate), _volatility(volatility) {
-    if (!_option) {
+BlackScholesMCPricer::BlackScholesMCPricer(Option* option, double initial_price, double interest_rate, double volatility) {
+    reconfigure(option, initial_price, interest_rate, volatility);
+}
+
+/**
+ * @brief Point the pricer to a new option and market and reset the simulation.
+ * @details The time grid, drift and volatility increments are only recomputed when the
+ * grid, the rate or the volatility change; a new spot or a new option on the same grid
+ * just resets the estimator. Buffers keep their capacity, so reusing a pricer on
+ * options with no more fixings than before does not allocate. On error the pricer is
+ * left unchanged.
+ * @param option The option to be priced.
+ * @param initial_price The initial price of the underlying asset.
+ * @param interest_rate The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ */
+void BlackScholesMCPricer::reconfigure(Option* option, double initial_price, double interest_rate, double volatility) {
+    if (!option) {
         throw std::invalid_argument("BlackScholesMCPricer: option pointer must not be null");
     }
 
-    _nb_paths = 0;
-    _estimate = 0.0;
-    _M2 = 0.0;
-
-    _time_steps = _option->getTimeSteps();
-
-    std::size_t steps = _time_steps.size();
+    // a non-Asian option is simulated on the single date {expiry}; an Asian one on its
+    // remaining fixings, read in place and measured from the valuation date as in
+    // AsianOption::getTimeSteps(), so that no vector is built
+    const bool asian = option->isAsianOption();
+    const double* fixings = nullptr;
+    double valuation_date = 0.0;
+    std::size_t steps = 1;
+    if (asian) {
+        const AsianOption* asian_option = static_cast<const AsianOption*>(option);
+        const std::size_t past = asian_option->getNbPastFixings();
+        fixings = asian_option->getFixings().data() + past;
+        valuation_date = asian_option->getValuationDate();
+        steps = asian_option->getFixings().size() - past;
+    }
     if (steps == 0) {
         throw std::invalid_argument("BlackScholesMCPricer: need at least one time step");
     }
-    _drift_dt.resize(steps);
-    _vol_sqrt_dt.resize(steps);
+    bool same_grid = steps == _time_steps.size();
     double last_t = 0.0;
-    const double drift = _interest_rate - 0.5 * _volatility * _volatility;
-    std::size_t idx = 0;
     double t = 0.0;
-    double dt = 0.0;
-    while (idx < steps) {
-        t = _time_steps[idx];
-        dt = t - last_t;
-        if (dt <= 0.0) {
+    for (std::size_t idx = 0; idx < steps; ++idx) {
+        t = asian ? fixings[idx] - valuation_date : option->getExpiry();
+        if (t - last_t <= 0.0) {
             throw std::invalid_argument("BlackScholesMCPricer: time steps must be increasing");
         }
-        _drift_dt[idx] = drift * dt;
-        _vol_sqrt_dt[idx] = _volatility * std::sqrt(dt);
+        same_grid = same_grid && t == _time_steps[idx];
         last_t = t;
-        idx++;
     }
-    _maturity = _time_steps[steps - 1];
+
+    if (!same_grid || interest_rate != _interest_rate || volatility != _volatility) {
+        _time_steps.resize(steps);
+        _drift_dt.resize(steps);
+        _vol_sqrt_dt.resize(steps);
+        _path_pos.resize(steps);
+        _path_neg.resize(steps);
+        last_t = 0.0;
+        const double drift = interest_rate - 0.5 * volatility * volatility;
+        std::size_t idx = 0;
+        double dt = 0.0;
+        while (idx < steps) {
+            t = asian ? fixings[idx] - valuation_date : option->getExpiry();
+            dt = t - last_t;
+            _time_steps[idx] = t;
+            _drift_dt[idx] = drift * dt;
+            _vol_sqrt_dt[idx] = volatility * std::sqrt(dt);
+            last_t = t;
+            idx++;
+        }
+        _maturity = _time_steps[steps - 1];
+    }
+
+    _option = option;
+    _initial_price = initial_price;
+    _interest_rate = interest_rate;
+    _volatility = volatility;
+    reset();
 }
 
 /**
@@ -65,6 +143,16 @@ int BlackScholesMCPricer::getNbPaths() const {
     return _nb_paths;
 }
 
+/**
+ * @brief Return the sum of squared deviations of the discounted payoffs (welford's M2).
+ * @details With getNbPaths() and price(), this is the whole state of a plain estimator,
+ * enough to merge estimates computed in separate processes. Moment-matched estimates
+ * are summarised by their blocks instead and cannot be merged this way.
+ * @return The sum of squared deviations from the estimate.
+ */
+double BlackScholesMCPricer::getM2() const {
+    return _M2;
+}
 
 /**
  * @brief Generate Monte Carlo paths for an option.
@@ -72,57 +160,227 @@ int BlackScholesMCPricer::getNbPaths() const {
  * The number of paths is set by the user, and the function generates both positive and negative paths if the number of paths is odd.
  * The paths are constructed by simulating the underlying asset price at each time step, and the payoff is calculated at the expiry time of the option.
  * The estimate of the option price is updated using the welford algorithm for variance.
+ * Normals are drawn a block of path pairs at a time; with moment matching (see
+ * setMomentMatching()), each block is rescaled before the paths are built. The
+ * discounted payoffs of each block are then added to the sketches, if any (see
+ * setSketches()), and its paths written to the path store, if any (see setPathStore()).
  * @param nb_paths The number of Monte Carlo paths to generate.
+ * @throws std::invalid_argument if the path store was opened for other time steps.
  */
 void BlackScholesMCPricer::generate(int nb_paths) {
+    if (!_option) {
+        throw std::logic_error("BlackScholesMCPricer: call reconfigure() before generate()");
+    }
     if (nb_paths <= 0) {
         return;
     }
 
     const std::size_t steps = _time_steps.size();
-    std::vector<double> path_pos(steps);
-    std::vector<double> path_neg(steps);
     const double df = std::exp(-_interest_rate * _maturity);
-    double s_pos = 0.0;
-    double s_neg = 0.0;
-    double z = 0.0;
-    double payoff_discounted = 0.0;
-    double delta = 0.0;
+    _normals.resize(_block_pairs * steps);
+    double payoff_pos = 0.0;
+    double payoff_neg = 0.0;
+    const bool sketching = _quantiles || _histogram;
+    if (_path_store && _path_store->getTimeSteps() != _time_steps) {
+        throw std::invalid_argument("BlackScholesMCPricer: path store time steps differ from the option's");
+    }
 
     int generated = 0;
     while (generated < nb_paths) {
-        s_pos = _initial_price;
-        s_neg = _initial_price;
-
-        for (std::size_t k = 0; k < steps; ++k) { // construct both path
-            z = MT::rand_norm();
-            s_pos *= std::exp(_drift_dt[k] + _vol_sqrt_dt[k] * z);
-            s_neg *= std::exp(_drift_dt[k] - _vol_sqrt_dt[k] * z);
-            path_pos[k] = s_pos;
-            path_neg[k] = s_neg;
+        const std::size_t pairs = std::min(_block_pairs, static_cast<std::size_t>(nb_paths - generated + 1) / 2);
+        MT::fill_normal(_normals.data(), pairs * steps);
+        if (_moment_matching) {
+            matchMoments(pairs);
         }
 
-        payoff_discounted = df * _option->payoffPath(path_pos);
-        // update mean
-        _nb_paths++;
-        delta = payoff_discounted - _estimate;
-        double n = (double)_nb_paths;
-        _estimate += delta / n;
-        _M2 += delta * (payoff_discounted - _estimate); // welford algorithm for variance
-        generated++;
-
-        if (generated < nb_paths) { //add negative path if nb_paths is odd
-            payoff_discounted = df * _option->payoffPath(path_neg);
-            _nb_paths++;
-            delta = payoff_discounted - _estimate;
-            n = (double)_nb_paths;
-            _estimate += delta / n;
-            _M2 += delta * (payoff_discounted - _estimate);
+        double block_sum = 0.0;
+        int block_paths = 0;
+        _block_payoffs.clear();
+        _block_paths.clear();
+        for (std::size_t p = 0; p < pairs; ++p) {
+            const bool pair = generated + 1 < nb_paths; // add negative path if nb_paths is odd
+            simulatePair(&_normals[p * steps], df, pair, payoff_pos, payoff_neg);
+            record(payoff_pos);
+            block_sum += payoff_pos;
             generated++;
+            block_paths++;
+            if (sketching) {
+                _block_payoffs.push_back(payoff_pos);
+            }
+            if (_path_store) {
+                _block_paths.insert(_block_paths.end(), _path_pos.begin(), _path_pos.end());
+            }
+            if (pair) {
+                record(payoff_neg);
+                block_sum += payoff_neg;
+                generated++;
+                block_paths++;
+                if (sketching) {
+                    _block_payoffs.push_back(payoff_neg);
+                }
+                if (_path_store) {
+                    _block_paths.insert(_block_paths.end(), _path_neg.begin(), _path_neg.end());
+                }
+            }
+        }
+        if (_path_store) {
+            _path_store->add(_block_paths.data(), _block_paths.size() / steps);
+        }
+        if (_quantiles) {
+            _quantiles->add(_block_payoffs.data(), _block_payoffs.size());
+        }
+        if (_histogram) {
+            _histogram->add(_block_payoffs.data(), _block_payoffs.size());
+        }
+        if (_moment_matching) {
+            _batch_paths.push_back(block_paths);
+            _batch_means.push_back(block_sum / block_paths);
         }
     }
 }
 
+/**
+ * @brief Rescale the normals of a block to zero mean and unit variance at every time step.
+ * @details The normals are stored path after path; the moments at step k are taken over
+ * the pairs of the block. A block of one pair is left as drawn.
+ * @param pairs The number of path pairs in the block.
+ */
+void BlackScholesMCPricer::matchMoments(std::size_t pairs) {
+    if (pairs < 2) {
+        return;
+    }
+    const std::size_t steps = _time_steps.size();
+    for (std::size_t k = 0; k < steps; ++k) {
+        double sum = 0.0;
+        for (std::size_t p = 0; p < pairs; ++p) {
+            sum += _normals[p * steps + k];
+        }
+        const double mean = sum / pairs;
+        double sq_sum = 0.0;
+        for (std::size_t p = 0; p < pairs; ++p) {
+            const double d = _normals[p * steps + k] - mean;
+            sq_sum += d * d;
+        }
+        const double scale = sq_sum > 0.0 ? 1.0 / std::sqrt(sq_sum / pairs) : 1.0;
+        for (std::size_t p = 0; p < pairs; ++p) {
+            _normals[p * steps + k] = (_normals[p * steps + k] - mean) * scale;
+        }
+    }
+}
+
+/**
+ * @brief Build the path of a set of normals and its antithetic, and pay them off.
+ * @param z The normals of the path, one per time step.
+ * @param df The discount factor to the maturity.
+ * @param with_negative Whether the antithetic path is paid off as well.
+ * @param payoff_pos Output discounted payoff of the path.
+ * @param payoff_neg Output discounted payoff of the antithetic path, if requested.
+ */
+void BlackScholesMCPricer::simulatePair(const double* z, double df, bool with_negative, double& payoff_pos, double& payoff_neg) {
+    const std::size_t steps = _time_steps.size();
+    double s_pos = _initial_price;
+    double s_neg = _initial_price;
+    for (std::size_t k = 0; k < steps; ++k) { // construct both path
+        s_pos *= std::exp(_drift_dt[k] + _vol_sqrt_dt[k] * z[k]);
+        s_neg *= std::exp(_drift_dt[k] - _vol_sqrt_dt[k] * z[k]);
+        _path_pos[k] = s_pos;
+        _path_neg[k] = s_neg;
+    }
+    payoff_pos = df * _option->payoffPath(_path_pos);
+    if (with_negative) {
+        payoff_neg = df * _option->payoffPath(_path_neg);
+    }
+}
+
+/**
+ * @brief Add a discounted payoff to the estimate (welford algorithm for variance).
+ */
+void BlackScholesMCPricer::record(double payoff_discounted) {
+    _nb_paths++;
+    const double delta = payoff_discounted - _estimate;
+    _estimate += delta / static_cast<double>(_nb_paths);
+    _M2 += delta * (payoff_discounted - _estimate);
+}
+
+/**
+ * @brief Rescale the normals of each block of paths to exact moments.
+ * @details With moment matching on, generate() rescales the normals of every block of
+ * block_pairs path pairs, time step by time step, to exactly zero mean and unit variance
+ * before building the paths and their antithetics. This removes the sampling error of
+ * the first two moments of the normals, at the cost of an O(1 / block_pairs) bias (the
+ * rescaled normals have thinner tails; about 2 / block_pairs on an at-the-money call
+ * worth 10) and of dependence between the paths of a block: confidenceInterval() then
+ * treats each block as one independent batch and uses the spread of the batch means, so
+ * at least two blocks are needed. The interval does not cover the bias, which does not
+ * shrink with the number of paths: it keeps its 95% level while the bias stays well
+ * below the standard error, which on an at-the-money call takes block_pairs of at least
+ * 3 sqrt(nb_paths). Blocks smaller than kMinBlockPairs are refused, since they lose the
+ * level from a few tens of thousands of paths. Changing the setting resets the estimator.
+ * @param enabled Whether to match moments.
+ * @param block_pairs The number of path pairs per block, at least kMinBlockPairs.
+ * @throws std::invalid_argument if block_pairs < kMinBlockPairs.
+ */
+void BlackScholesMCPricer::setMomentMatching(bool enabled, std::size_t block_pairs) {
+    if (block_pairs < kMinBlockPairs) {
+        throw std::invalid_argument("BlackScholesMCPricer: need at least 1024 path pairs per block");
+    }
+    _moment_matching = enabled;
+    _block_pairs = block_pairs;
+    reset();
+}
+
+/**
+ * @return Whether the normals are moment matched.
+ */
+bool BlackScholesMCPricer::getMomentMatching() const {
+    return _moment_matching;
+}
+
+/**
+ * @brief Stream the discounted payoffs into distribution sketches.
+ * @details generate() adds the discounted payoff of every path to the sketches, a block
+ * at a time, so that quantiles, tail means and histograms of the payoff are available
+ * in bounded memory. The sketches belong to the caller and outlive reconfigure(): they
+ * are never cleared here. Pricers running on several threads each get their own
+ * sketches, merged afterwards with TDigest::merge() and Histogram::merge(). Payoffs
+ * come in antithetic pairs: each path still has the right law, so the estimates are
+ * consistent, but their error is not that of independent draws. A TDigest costs about
+ * 50 ns per path, mostly sorting its buffer.
+ * @param quantiles The quantile sketch, or nullptr.
+ * @param histogram The histogram, or nullptr.
+ */
+void BlackScholesMCPricer::setSketches(TDigest* quantiles, Histogram* histogram) {
+    _quantiles = quantiles;
+    _histogram = histogram;
+}
+
+/**
+ * @brief Write every simulated path to a path store.
+ * @details generate() adds the paths of each block to the store, in the order their
+ * payoffs enter the estimate, so PathStore::price() on the finished file gives back
+ * price(). The store belongs to the caller, who finishes it, and must have been opened
+ * with the time steps the pricer simulates (getTimeSteps() of the option). The paths are
+ * copied on this thread and encoded on the store's. On a 12-fixing Asian call with a
+ * pricer on every core (see bench_path_store) the store costs about 4 to 6 ns of CPU
+ * per spot, 30 to 50% of the simulation: under 2 ns to encode, about 1.5 ns to write
+ * the 33 bits per spot to the page cache, and about 0.75 ns for the copies.
+ * @param store The path store, or nullptr.
+ */
+void BlackScholesMCPricer::setPathStore(PathStoreWriter* store) {
+    _path_store = store;
+}
+
+/**
+ * @brief Forget every path generated so far.
+ */
+void BlackScholesMCPricer::reset() {
+    _nb_paths = 0;
+    _estimate = 0.0;
+    _M2 = 0.0;
+    _batch_paths.clear();
+    _batch_means.clear();
+}
+
 /**
  * @brief Return the estimated price of the option using Monte Carlo simulation.
  * 
@@ -148,6 +406,37 @@ double BlackScholesMCPricer::operator()() {
     return price();
 }
 
+/**
+ * @brief Return the standard error of the estimated price of the option.
+ * @details With moment matching, the paths of a block are not independent: the standard
+ * error is taken from the spread of the block means, weighted by their number of paths,
+ * and at least two blocks are needed.
+ * @return The standard error.
+ * @throws std::logic_error if fewer than two paths, or with moment matching fewer than
+ * two blocks, were generated.
+ */
+double BlackScholesMCPricer::standardError() {
+    if (_nb_paths < 2) {
+        throw std::logic_error("BlackScholesMCPricer: need at least two paths for confidence interval");
+    }
+    if (_moment_matching) {
+        const std::size_t batches = _batch_means.size();
+        if (batches < 2) {
+            throw std::logic_error("BlackScholesMCPricer: need at least two blocks for confidence interval");
+        }
+        // variance of a ratio of weighted sums: sum w_b^2 (m_b - m)^2 / (sum w_b)^2, scaled by B / (B - 1)
+        double spread = 0.0;
+        for (std::size_t b = 0; b < batches; ++b) {
+            const double weighted = _batch_paths[b] * (_batch_means[b] - _estimate);
+            spread += weighted * weighted;
+        }
+        const double total = static_cast<double>(_nb_paths);
+        return std::sqrt(spread / (total * total) * batches / (batches - 1.0));
+    }
+    double variance = _M2 / static_cast<double>(_nb_paths - 1);
+    return std::sqrt(variance / static_cast<double>(_nb_paths));
+}
+
 /**
  * @brief Return the 95% confidence interval of the estimated price of the option.
  * @return A vector containing the lower and upper bounds of the 95% confidence interval.
@@ -155,13 +444,13 @@ double BlackScholesMCPricer::operator()() {
  * The confidence interval is calculated using the standard error of the estimated price
  * and the normal distribution.
  * If generate() has not been called with at least two paths, then a logic_error exception is thrown.
+ * With moment matching, the B block means are the independent samples, so the interval
+ * uses the quantile of Student's t with B - 1 degrees of freedom: 12.7 standard errors
+ * for two blocks, 2.26 for ten, 1.98 for a hundred. See setMomentMatching() for the
+ * block size it needs to stay at its level.
  */
 std::vector<double> BlackScholesMCPricer::confidenceInterval() {
-    if (_nb_paths < 2) {
-        throw std::logic_error("BlackScholesMCPricer: need at least two paths for confidence interval");
-    }
-    double variance = _M2 / static_cast<double>(_nb_paths - 1);
-    double std_err = std::sqrt(variance / static_cast<double>(_nb_paths));
-    const double z = 1.96;
+    const double std_err = standardError();
+    const double z = _moment_matching ? studentQuantile975(_batch_means.size() - 1) : 1.96;
     return {_estimate - z * std_err, _estimate + z * std_err};
 }
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "BumpRiskEngine.h"
+#include "CRRPricer.h"
+#include "MT.h"
+
+namespace {
+
+// number of antithetic pairs whose normals are drawn at once and shared by every bump
+constexpr std::size_t kBlockPairs = 256;
+
+struct BumpedMarket {
+    double spot;
+    double rate;
+    double volatility;
+};
+
+}
+
+/**
+ * @brief Construct a BumpRiskEngine instance.
+ * @details The engine prices an option under a base market and under a list of bumped
+ * markets (spot, volatility and rate shifts) in a single pass, so that the differences
+ * between bumped prices are not polluted by independent numerical noise.
+ * @param option The option to be priced.
+ * @param initial_price The initial price of the underlying asset.
+ * @param interest_rate The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ * @throws std::invalid_argument if the option is null or the market is invalid.
+ */
+BumpRiskEngine::BumpRiskEngine(Option* option, double initial_price, double interest_rate, double volatility) : _option(option), _initial_price(initial_price), _interest_rate(interest_rate), _volatility(volatility) {
+    if (!_option) {
+        throw std::invalid_argument("BumpRiskEngine: option pointer must not be null");
+    }
+    if (_initial_price <= 0.0 || _volatility <= 0.0) {
+        throw std::invalid_argument("BumpRiskEngine: invalid parameters");
+    }
+}
+
+/**
+ * @brief Add a bump to the ladder.
+ * @param bump The absolute shifts applied to the spot, the volatility and the rate.
+ * @throws std::invalid_argument if the bumped spot or volatility is not positive.
+ */
+void BumpRiskEngine::addBump(const Bump& bump) {
+    if (_initial_price + bump.spot_shift <= 0.0 || _volatility + bump.vol_shift <= 0.0) {
+        throw std::invalid_argument("BumpRiskEngine: bumped spot and volatility must be positive");
+    }
+    _bumps.push_back(bump);
+}
+
+/**
+ * @brief Add several bumps to the ladder, in order.
+ * @param bumps The bumps to add.
+ */
+void BumpRiskEngine::addBumps(const std::vector<Bump>& bumps) {
+    for (const Bump& bump : bumps) {
+        addBump(bump);
+    }
+}
+
+/**
+ * @return The bumps of the ladder, in the order their prices are returned.
+ */
+const std::vector<Bump>& BumpRiskEngine::getBumps() const {
+    return _bumps;
+}
+
+/**
+ * @brief Price every bump of the ladder by Monte Carlo with common random numbers.
+ * @details Normals are drawn once per block of antithetic pairs and reused by every bump,
+ * so a bumped price and the base price see exactly the same scenarios. Path construction
+ * and pairing follow BlackScholesMCPricer::generate().
+ * @param nb_paths The number of paths per bump.
+ * @return The bumped prices, in the order of getBumps().
+ * @throws std::invalid_argument if nb_paths is not positive or the time steps are not increasing.
+ */
+std::vector<double> BumpRiskEngine::priceMC(int nb_paths) const {
+    if (nb_paths <= 0) {
+        throw std::invalid_argument("BumpRiskEngine: number of paths must be positive");
+    }
+
+    const std::vector<double> time_steps = _option->getTimeSteps();
+    const std::size_t steps = time_steps.size();
+    if (steps == 0) {
+        throw std::invalid_argument("BumpRiskEngine: need at least one time step");
+    }
+    std::vector<double> dts(steps);
+    double last_t = 0.0;
+    for (std::size_t k = 0; k < steps; ++k) {
+        dts[k] = time_steps[k] - last_t;
+        if (dts[k] <= 0.0) {
+            throw std::invalid_argument("BumpRiskEngine: time steps must be increasing");
+        }
+        last_t = time_steps[k];
+    }
+    const double maturity = time_steps[steps - 1];
+
+    const std::size_t nb_bumps = _bumps.size();
+    std::vector<double> drift_dt(nb_bumps * steps);
+    std::vector<double> vol_sqrt_dt(nb_bumps * steps);
+    std::vector<double> spots(nb_bumps);
+    std::vector<double> dfs(nb_bumps);
+    for (std::size_t b = 0; b < nb_bumps; ++b) {
+        const double r = _interest_rate + _bumps[b].rate_shift;
+        const double sigma = _volatility + _bumps[b].vol_shift;
+        const double drift = r - 0.5 * sigma * sigma;
+        for (std::size_t k = 0; k < steps; ++k) {
+            drift_dt[b * steps + k] = drift * dts[k];
+            vol_sqrt_dt[b * steps + k] = sigma * std::sqrt(dts[k]);
+        }
+        spots[b] = _initial_price + _bumps[b].spot_shift;
+        dfs[b] = std::exp(-r * maturity);
+    }
+
+    const std::size_t nb_pairs = (static_cast<std::size_t>(nb_paths) + 1) / 2;
+    std::vector<double> normals(kBlockPairs * steps);
+    std::vector<double> sums(nb_bumps, 0.0);
+    std::vector<double> path_pos(steps);
+    std::vector<double> path_neg(steps);
+    double s_pos = 0.0;
+    double s_neg = 0.0;
+
+    for (std::size_t first = 0; first < nb_pairs; first += kBlockPairs) {
+        const std::size_t block = std::min(kBlockPairs, nb_pairs - first);
+        MT::fill_normal(normals.data(), block * steps);
+
+        for (std::size_t b = 0; b < nb_bumps; ++b) {
+            const double* drift = &drift_dt[b * steps];
+            const double* vol = &vol_sqrt_dt[b * steps];
+            double sum = 0.0;
+            for (std::size_t p = 0; p < block; ++p) {
+                const double* z = &normals[p * steps];
+                s_pos = spots[b];
+                s_neg = spots[b];
+                for (std::size_t k = 0; k < steps; ++k) {
+                    s_pos *= std::exp(drift[k] + vol[k] * z[k]);
+                    s_neg *= std::exp(drift[k] - vol[k] * z[k]);
+                    path_pos[k] = s_pos;
+                    path_neg[k] = s_neg;
+                }
+                sum += _option->payoffPath(path_pos);
+                if (2 * (first + p) + 1 < static_cast<std::size_t>(nb_paths)) { // odd count: last pair has no negative path
+                    sum += _option->payoffPath(path_neg);
+                }
+            }
+            sums[b] += sum;
+        }
+    }
+
+    std::vector<double> prices(nb_bumps);
+    for (std::size_t b = 0; b < nb_bumps; ++b) {
+        prices[b] = dfs[b] * sums[b] / static_cast<double>(nb_paths);
+    }
+    return prices;
+}
+
+/**
+ * @brief Price every bump of the ladder on a CRR tree.
+ * @details Bumps sharing the same volatility and rate only differ by S0, so they share the
+ * same tree factors and spot ratios U^i D^(n-i). Such bumps are grouped and rolled back
+ * together, one lane per spot, with the lanes of a node stored contiguously so the
+ * continuation values of a group are computed in SIMD-friendly inner loops.
+ * The tree follows the parametrisation of CRRPricer(option, depth, S0, r, volatility).
+ * @param depth The depth of the binomial tree.
+ * @return The bumped prices, in the order of getBumps().
+ * @throws std::invalid_argument if the option is Asian, the depth is not positive or a
+ * bumped tree violates D < R < U.
+ */
+std::vector<double> BumpRiskEngine::priceCRR(int depth) const {
+    if (_option->isAsianOption()) {
+        throw std::invalid_argument("BumpRiskEngine: Asian option not supported by CRR");
+    }
+    if (depth <= 0) {
+        throw std::invalid_argument("BumpRiskEngine: depth must be > 0");
+    }
+
+    const std::size_t nb_bumps = _bumps.size();
+    std::vector<BumpedMarket> markets(nb_bumps);
+    for (std::size_t b = 0; b < nb_bumps; ++b) {
+        markets[b] = {_initial_price + _bumps[b].spot_shift, _interest_rate + _bumps[b].rate_shift, _volatility + _bumps[b].vol_shift};
+    }
+
+    const bool american = _option->isAmericanOption();
+    const std::size_t N = static_cast<std::size_t>(depth);
+    std::vector<double> prices(nb_bumps);
+    std::vector<bool> done(nb_bumps, false);
+    std::vector<std::size_t> lanes;
+    std::vector<double> ratios(N + 1);
+    std::vector<double> values;
+
+    for (std::size_t b = 0; b < nb_bumps; ++b) {
+        if (done[b]) {
+            continue;
+        }
+        lanes.clear();
+        for (std::size_t c = b; c < nb_bumps; ++c) {
+            if (!done[c] && markets[c].rate == markets[b].rate && markets[c].volatility == markets[b].volatility) {
+                lanes.push_back(c);
+                done[c] = true;
+            }
+        }
+        const std::size_t L = lanes.size();
+
+        double U = 0.0;
+        double D = 0.0;
+        double R = 0.0;
+        CRRPricer::treeFactors(_option->getExpiry(), depth, markets[b].rate, markets[b].volatility, U, D, R);
+        if (!(D < R && R < U)) {
+            throw std::invalid_argument("BumpRiskEngine: need D < R < U");
+        }
+        const double q = (R - D) / (U - D);
+        const double pu = q / R;
+        const double pd = (1.0 - q) / R;
+
+        // spot lattice shared by all lanes: S(n, i) = S0 * D^n * (U/D)^i
+        for (std::size_t i = 0; i <= N; ++i) {
+            ratios[i] = std::pow(U / D, static_cast<double>(i));
+        }
+
+        values.assign((N + 1) * L, 0.0);
+        double dn = std::pow(D, static_cast<double>(N));
+        for (std::size_t i = 0; i <= N; ++i) {
+            for (std::size_t l = 0; l < L; ++l) {
+                values[i * L + l] = _option->payoff(markets[lanes[l]].spot * dn * ratios[i]);
+            }
+        }
+
+        for (std::size_t n = N; n-- > 0;) {
+            dn = std::pow(D, static_cast<double>(n));
+            for (std::size_t i = 0; i <= n; ++i) {
+                double* node = &values[i * L];
+                const double* up = &values[(i + 1) * L];
+                for (std::size_t l = 0; l < L; ++l) {
+                    node[l] = pu * up[l] + pd * node[l];
+                }
+                if (american) {
+                    for (std::size_t l = 0; l < L; ++l) {
+                        const double intrinsic = _option->payoff(markets[lanes[l]].spot * dn * ratios[i]);
+                        if (intrinsic >= node[l]) {
+                            node[l] = intrinsic;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (std::size_t l = 0; l < L; ++l) {
+            prices[lanes[l]] = values[l];
+        }
+    }
+    return prices;
+}
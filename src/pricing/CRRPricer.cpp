@@ -1,7 +1,60 @@
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include "CRRPricer.h"
 
+namespace {
+
+// payoffs and exercise flags of the last level of the tree
+template <class Flag>
+void terminalLevel(const Option& option, bool american, int depth, double S0, double U, double D, double* values, Flag* exercise) {
+    double s = 0.0;
+    for (int i = 0; i <= depth; ++i) {
+        s = S0 * std::pow(U, i) * std::pow(D, depth - i);
+        values[i] = option.payoff(s);
+        if (exercise) {
+            exercise[i] = american && values[i] >= 0.0;
+        }
+    }
+}
+
+// level n from level n + 1; next may be values itself, as nodes are updated in ascending order
+template <class Flag>
+void inductLevel(const Option& option, bool american, int n, double S0, double U, double D, double R, const double* next,
+                 double* values, Flag* exercise) {
+    const double q = (R - D) / (U - D);
+    double s = 0.0;
+    double cont = 0.0;
+    double intrinsic = 0.0;
+    for (int i = 0; i <= n; ++i) {
+        cont = (q * next[i + 1] + (1.0 - q) * next[i]) / R;
+        values[i] = cont;
+        if (exercise) {
+            exercise[i] = false;
+        }
+
+        if (american) {
+            s = S0 * std::pow(U, i) * std::pow(D, n - i);
+            intrinsic = option.payoff(s);
+            if (intrinsic >= cont) {
+                values[i] = intrinsic;
+                if (exercise) {
+                    exercise[i] = true;
+                }
+            }
+        }
+    }
+}
+
+}
+
+/**
+ * @brief Construct an unconfigured CRRPricer instance.
+ * @details The pricer must be given an option and a tree by reconfigure() before use.
+ * This is meant for pricers kept in a pool and reused across many options.
+ */
+CRRPricer::CRRPricer() = default;
+
 /**
  * @brief Construct a CRRPricer instance.
  * @details This pricer uses the Cox-Ross-Rubinstein model to estimate the price of an option.
@@ -14,77 +67,145 @@
  * @param D The rate of continuous dividend yield.
  * @param R The risk-free rate.
  */
-CRRPricer::CRRPricer(Option* option, int depth, double S0, double U, double D, double R) : _option(option), _depth(depth), _S0(S0) {
-    if (!_option) {
+CRRPricer::CRRPricer(Option* option, int depth, double S0, double U, double D, double R) {
+    reconfigure(option, depth, S0, U, D, R);
+}
+
+
+/**
+ * @brief Construct a CRRPricer instance with parameters.
+ * 
+ * @details This constructor takes an option, the depth of the binomial tree,
+ * the initial price of the underlying asset, the interest rate, and the volatility.
+ * It first checks that the option is not null and that the depth is greater than 0.
+ * Then it computes the time step of the binomial tree, and uses this to compute U, D, and R.
+ * Finally, it checks that D < R < U, and throws an exception if this is not true.
+ * 
+ * @param option The option to be priced.
+ * @param depth The depth of the binomial tree.
+ * @param S0 The initial price of the underlying asset.
+ * @param r The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ */
+CRRPricer::CRRPricer(Option* option, int depth, double S0, double r, double volatility) {
+    reconfigure(option, depth, S0, r, volatility);
+}
+
+/**
+ * @brief Point the pricer to a new option and tree, given as returns.
+ * @details Same inputs and checks as the constructor. The trees keep their allocation:
+ * they are only resized when the depth changes, and a depth already used before does not
+ * allocate. On error the pricer is left unchanged.
+ * @param option The option to be priced.
+ * @param depth The depth of the binomial tree.
+ * @param S0 The initial price of the underlying asset.
+ * @param U The up return of the underlying asset.
+ * @param D The down return of the underlying asset.
+ * @param R The risk-free return.
+ */
+void CRRPricer::reconfigure(Option* option, int depth, double S0, double U, double D, double R) {
+    if (!option) {
         throw std::invalid_argument("CRRPricer: option is null");
     }
-    if (_option->isAsianOption()) {
+    if (option->isAsianOption()) {
         throw std::invalid_argument("CRRPricer: Asian option not supported");
     }
-    if (_depth < 0) {
+    if (depth < 0) {
         throw std::invalid_argument("CRRPricer: depth must be >= 0");
     }
 
     // inputs are returns not rates so add 1
-    _U = 1.0 + U;
-    _D = 1.0 + D;
-    _R = 1.0 + R;
+    U = 1.0 + U;
+    D = 1.0 + D;
+    R = 1.0 + R;
 
-    if (_U <= 0.0 || _D <= 0.0 || _R <= 0.0) {
+    if (U <= 0.0 || D <= 0.0 || R <= 0.0) {
         throw std::invalid_argument("CRRPricer: returns must be > -100%");
     }
-    if (!(_D < _R && _R < _U)) {
+    if (!(D < R && R < U)) {
         throw std::invalid_argument("CRRPricer: need D < R < U"); //arbitrage checks
     }
 
-    _optionTree.setDepth(_depth);
-    _exerciseTree.setDepth(_depth);
+    setTree(option, depth, S0, U, D, R);
 }
 
-
 /**
- * @brief Construct a CRRPricer instance with parameters.
- * 
- * @details This constructor takes an option, the depth of the binomial tree,
- * the initial price of the underlying asset, the interest rate, and the volatility.
- * It first checks that the option is not null and that the depth is greater than 0.
- * Then it computes the time step of the binomial tree, and uses this to compute U, D, and R.
- * Finally, it checks that D < R < U, and throws an exception if this is not true.
- * 
+ * @brief Point the pricer to a new option and tree, given by a rate and a volatility.
+ * @details Same inputs and checks as the constructor, same reuse of the trees as the
+ * other overload. On error the pricer is left unchanged.
  * @param option The option to be priced.
  * @param depth The depth of the binomial tree.
  * @param S0 The initial price of the underlying asset.
  * @param r The interest rate of the risk-free asset.
  * @param volatility The volatility of the underlying asset.
  */
-CRRPricer::CRRPricer(Option* option, int depth, double S0, double r, double volatility) : _option(option), _depth(depth), _S0(S0) {
-    if (!_option) {
+void CRRPricer::reconfigure(Option* option, int depth, double S0, double r, double volatility) {
+    if (!option) {
         throw std::invalid_argument("CRRPricer: option is null");
     }
-    if (_option->isAsianOption()) {
+    if (option->isAsianOption()) {
         throw std::invalid_argument("CRRPricer: Asian option not supported");
     }
-    if (_depth <= 0) {
+    if (depth <= 0) {
         throw std::invalid_argument("CRRPricer: depth must be > 0");
     }
 
-    double T = _option->getExpiry();
-    double dt = T / _depth;
+    double U = 0.0;
+    double D = 0.0;
+    double R = 0.0;
+    treeFactors(option->getExpiry(), depth, r, volatility, U, D, R);
+
+    if (!(D < R && R < U)) {
+        throw std::invalid_argument("CRRPricer: need D < R < U");
+    }
+
+    setTree(option, depth, S0, U, D, R);
+}
+
+/**
+ * @brief Store validated tree parameters and size the trees for the depth.
+ */
+void CRRPricer::setTree(Option* option, int depth, double S0, double U, double D, double R) {
+    _option = option;
+    _S0 = S0;
+    _U = U;
+    _D = D;
+    _R = R;
+    if (_storage == CRRStorage::FullTree && depth != _allocated_depth) {
+        _optionTree.setDepth(depth);
+        _exerciseTree.setDepth(depth);
+        _allocated_depth = depth;
+    }
+    _depth = depth;
+    _computed = false;
+}
+
+/**
+ * @brief Compute the per-step factors of the binomial tree from a rate and a volatility.
+ *
+ * @details This is the parametrisation used by the (r, volatility) constructor, exposed so
+ * that engines building their own lattices stay consistent with CRRPricer.
+ *
+ * @param expiry The expiry of the option.
+ * @param depth The depth of the binomial tree.
+ * @param r The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ * @param U Output up factor.
+ * @param D Output down factor.
+ * @param R Output one-step capitalisation factor.
+ *
+ * @throws std::invalid_argument if the time step is not positive.
+ */
+void CRRPricer::treeFactors(double expiry, int depth, double r, double volatility, double& U, double& D, double& R) {
+    const double dt = depth > 0 ? expiry / depth : 0.0;
     if (dt <= 0.0) {
         throw std::invalid_argument("CRRPricer: time step must be positive");
     }
     const double drift = (r + 0.5 * volatility * volatility) * dt;
     const double step = volatility * std::sqrt(dt);
-    _U = std::exp(drift + step);
-    _D = std::exp(drift - step);
-    _R = std::exp(r * dt);
-
-    if (!(_D < _R && _R < _U)) {
-        throw std::invalid_argument("CRRPricer: need D < R < U");
-    }
-
-    _optionTree.setDepth(_depth);
-    _exerciseTree.setDepth(_depth);
+    U = std::exp(drift + step);
+    D = std::exp(drift - step);
+    R = std::exp(r * dt);
 }
 
 /**
@@ -97,53 +218,181 @@ CRRPricer::CRRPricer(Option* option, int depth, double S0, double r, double vola
  * it also checks if exercising the option at each node yields a higher value than not
  * exercising it, and updates the value and exercise decision accordingly.
  * Finally, it sets the _computed flag to true.
+ * In checkpointed storage (see setStorage()), only every k-th level is kept.
  * 
- * @throws std::logic_error if compute() has not been called before.
+ * @throws std::logic_error if the pricer has not been configured.
  */
 void CRRPricer::compute() {
-    double q = (_R - _D) / (_U - _D);
+    if (!_option) {
+        throw std::logic_error("CRRPricer: call reconfigure() before pricing");
+    }
+    if (_storage == CRRStorage::Checkpointed) {
+        computeCheckpointed();
+        _computed = true;
+        return;
+    }
     bool american = _option->isAmericanOption();
 
-    double s = 0.0;
-    double payoff = 0.0;
-    bool exercise_now = false;
-    double up = 0.0;
-    double down = 0.0;
-    double cont = 0.0;
-    double value = 0.0;
-    bool ex = false;
-    double intrinsic = 0.0;
+    terminalLevel(*_option, american, _depth, _S0, _U, _D, _optionTree.row(_depth).data(), _exerciseTree.row(_depth).data());
+    for (int n = _depth - 1; n >= 0; --n) {
+        inductLevel(*_option, american, n, _S0, _U, _D, _R, _optionTree.row(n + 1).data(), _optionTree.row(n).data(),
+                    _exerciseTree.row(n).data());
+    }
+    _computed = true;
+}
 
-    for (int i = 0; i <= _depth; ++i) {
-        s = _S0 * std::pow(_U, i) * std::pow(_D, _depth - i);
-        payoff = _option->payoff(s);
-        _optionTree.setNode(_depth, i, payoff);
-        exercise_now = american && payoff >= 0.0;
-        _exerciseTree.setNode(_depth, i, exercise_now);
+/**
+ * @brief Backward induction on a single rolling level, keeping every _interval-th level.
+ * @details The levels are computed with the same operations as in full-tree mode, so the
+ * checkpoints hold exactly the values the full tree would.
+ */
+void CRRPricer::computeCheckpointed() {
+    bool american = _option->isAmericanOption();
+    _interval = _requested_interval > 0 ? _requested_interval
+                                        : static_cast<int>(std::ceil(std::sqrt(static_cast<double>(_depth) + 1.0)));
+    const int last = _depth / _interval * _interval;
+    _checkpoints.resize(checkpointOffset(last) + static_cast<std::size_t>(last) + 1);
+    _rolling.resize(static_cast<std::size_t>(_depth) + 1);
+    for (Segment& segment : _segments) {
+        segment.index = -1;
     }
 
-    for (int n = _depth - 1; n >= 0; --n) {
-        for (int i = 0; i <= n; ++i) {
-            up = _optionTree.getNode(n + 1, i + 1);
-            down = _optionTree.getNode(n + 1, i);
-            cont = (q * up + (1.0 - q) * down) / _R;
-            value = cont;
-            ex = false;
-
-            if (american) {
-                s = _S0 * std::pow(_U, i) * std::pow(_D, n - i);
-                intrinsic = _option->payoff(s);
-                if (intrinsic >= cont) {
-                    value = intrinsic;
-                    ex = true;
-                }
-            }
+    double* values = _rolling.data();
+    bool* no_exercise = nullptr;
+    terminalLevel(*_option, american, _depth, _S0, _U, _D, values, no_exercise);
+    for (int n = _depth;; --n) {
+        if (n % _interval == 0) {
+            std::copy(values, values + n + 1, _checkpoints.begin() + checkpointOffset(n));
+        }
+        if (n == 0) {
+            break;
+        }
+        inductLevel(*_option, american, n - 1, _S0, _U, _D, _R, values, values, no_exercise);
+    }
+}
 
-            _optionTree.setNode(n, i, value);
-            _exerciseTree.setNode(n, i, ex);
+/**
+ * @brief Offset in _checkpoints of level n, a multiple of _interval.
+ * @details Checkpoint m holds level m k, of m k + 1 nodes, after the m previous ones.
+ */
+std::size_t CRRPricer::checkpointOffset(int n) const {
+    const std::size_t k = static_cast<std::size_t>(_interval);
+    const std::size_t m = static_cast<std::size_t>(n) / k;
+    return m == 0 ? 0 : k * m * (m - 1) / 2 + m;
+}
+
+/**
+ * @brief Get the cached segment holding level n, recomputing it if needed.
+ * @details Segment s holds levels s k to min(s k + k - 1, depth), rebuilt from the
+ * checkpoint at level (s + 1) k, or from the payoffs for the last segment. When the cache
+ * is full, the least recently used segment is recomputed in place.
+ */
+const CRRPricer::Segment& CRRPricer::segment(int n) {
+    const int index = n / _interval;
+    Segment* victim = &_segments.front();
+    for (Segment& segment : _segments) {
+        if (segment.index == index) {
+            segment.last_use = ++_use_counter;
+            return segment;
+        }
+        if (segment.last_use < victim->last_use) {
+            victim = &segment;
         }
     }
-    _computed = true;
+
+    const bool american = _option->isAmericanOption();
+    const int first = index * _interval;
+    const int last = std::min(first + _interval - 1, _depth);
+    const std::size_t stride = static_cast<std::size_t>(last) + 1;
+    victim->values.resize(stride * static_cast<std::size_t>(last - first + 1));
+    victim->exercise.resize(victim->values.size());
+    double* values = victim->values.data();
+    char* exercise = victim->exercise.data();
+
+    const double* next = nullptr;
+    int top = last;
+    if (last == _depth) {
+        const std::size_t row = static_cast<std::size_t>(last - first) * stride;
+        terminalLevel(*_option, american, _depth, _S0, _U, _D, values + row, exercise + row);
+        next = values + row;
+        --top;
+    } else {
+        next = _checkpoints.data() + checkpointOffset(last + 1);
+    }
+    for (int m = top; m >= first; --m) {
+        const std::size_t row = static_cast<std::size_t>(m - first) * stride;
+        inductLevel(*_option, american, m, _S0, _U, _D, _R, next, values + row, exercise + row);
+        next = values + row;
+    }
+    victim->index = index;
+    victim->last_use = ++_use_counter;
+    return *victim;
+}
+
+/**
+ * @throws std::out_of_range if (n, i) is not a node of the tree.
+ */
+void CRRPricer::checkNode(int n, int i) const {
+    if (n < 0 || n > _depth) throw std::out_of_range("CRRPricer: n out of range");
+    if (i < 0 || i > n) throw std::out_of_range("CRRPricer: i out of range");
+}
+
+/**
+ * @brief Choose how the tree is kept after compute().
+ * @details FullTree (the default) stores every node, (N + 1)(N + 2) / 2 values and as many
+ * flags. Checkpointed keeps every interval-th level only, about N^2 / (2 interval) values;
+ * get() and getExercise() then rebuild the interval levels around the node from the next
+ * checkpoint, at a cost of O(interval N), into a cache of cached_segments segments of at
+ * most interval (N + 1) nodes. With the default interval of ceil(sqrt(N + 1)), memory is
+ * O(N sqrt(N)) and a query on a cached segment is a plain lookup. Values and exercise
+ * decisions are identical in both modes. The tree must be computed again after a change.
+ * @param storage The storage mode.
+ * @param interval The number of levels between checkpoints, 0 for ceil(sqrt(depth + 1)).
+ * @param cached_segments The number of segments kept in the cache, at least 1.
+ * @throws std::invalid_argument if interval is negative or cached_segments is 0.
+ */
+void CRRPricer::setStorage(CRRStorage storage, int interval, std::size_t cached_segments) {
+    if (interval < 0) {
+        throw std::invalid_argument("CRRPricer: checkpoint interval must be >= 0");
+    }
+    if (cached_segments == 0) {
+        throw std::invalid_argument("CRRPricer: need at least one cached segment");
+    }
+    _storage = storage;
+    _requested_interval = interval;
+    _interval = 0;
+    _segments.assign(cached_segments, Segment{});
+    _use_counter = 0;
+    _computed = false;
+    if (storage == CRRStorage::Checkpointed) {
+        _optionTree.release();
+        _exerciseTree.release();
+        _allocated_depth = -1;
+    } else {
+        std::vector<double>().swap(_checkpoints);
+        std::vector<double>().swap(_rolling);
+        _segments.clear();
+        if (_option && _depth != _allocated_depth) {
+            _optionTree.setDepth(_depth);
+            _exerciseTree.setDepth(_depth);
+            _allocated_depth = _depth;
+        }
+    }
+}
+
+/**
+ * @return The storage mode of the tree.
+ */
+CRRStorage CRRPricer::getStorage() const {
+    return _storage;
+}
+
+/**
+ * @return The number of levels between checkpoints used by the last compute() in
+ * checkpointed mode, 0 otherwise.
+ */
+int CRRPricer::getCheckpointInterval() const {
+    return _storage == CRRStorage::Checkpointed && _computed ? _interval : 0;
 }
 
 /**
@@ -164,6 +413,14 @@ double CRRPricer::get(int n, int i) {
     if (!_computed) {
         throw std::logic_error("CRRPricer::get needs compute() first");
     }
+    if (_storage == CRRStorage::Checkpointed) {
+        checkNode(n, i);
+        if (n % _interval == 0) {
+            return _checkpoints[checkpointOffset(n) + static_cast<std::size_t>(i)];
+        }
+        const std::size_t stride = static_cast<std::size_t>(std::min(n / _interval * _interval + _interval - 1, _depth)) + 1;
+        return segment(n).values[static_cast<std::size_t>(n % _interval) * stride + static_cast<std::size_t>(i)];
+    }
     return _optionTree.getNode(n, i);
 }
 
@@ -180,9 +437,48 @@ bool CRRPricer::getExercise(int n, int i) {
     if (!_computed) {
         throw std::logic_error("CRRPricer::getExercise needs compute() first");
     }
+    if (_storage == CRRStorage::Checkpointed) {
+        checkNode(n, i);
+        const std::size_t stride = static_cast<std::size_t>(std::min(n / _interval * _interval + _interval - 1, _depth)) + 1;
+        return segment(n).exercise[static_cast<std::size_t>(n % _interval) * stride + static_cast<std::size_t>(i)] != 0;
+    }
     return _exerciseTree.getNode(n, i);
 }
 
+/**
+ * @brief Get the whole tree of option values, e.g. to export it with LatticeIO.
+ *
+ * @return The tree of option values, valid until the next reconfigure().
+ *
+ * @throws std::logic_error if compute() has not been called before, or in checkpointed storage.
+ */
+const BinaryTree<double>& CRRPricer::getOptionTree() const {
+    if (!_computed) {
+        throw std::logic_error("CRRPricer::getOptionTree needs compute() first");
+    }
+    if (_storage == CRRStorage::Checkpointed) {
+        throw std::logic_error("CRRPricer::getOptionTree has no full tree in checkpointed storage");
+    }
+    return _optionTree;
+}
+
+/**
+ * @brief Get the whole tree of exercise decisions.
+ *
+ * @return The tree of exercise decisions, valid until the next reconfigure().
+ *
+ * @throws std::logic_error if compute() has not been called before, or in checkpointed storage.
+ */
+const BinaryTree<bool>& CRRPricer::getExerciseTree() const {
+    if (!_computed) {
+        throw std::logic_error("CRRPricer::getExerciseTree needs compute() first");
+    }
+    if (_storage == CRRStorage::Checkpointed) {
+        throw std::logic_error("CRRPricer::getExerciseTree has no full tree in checkpointed storage");
+    }
+    return _exerciseTree;
+}
+
 /**
  * @brief Calculate the binomial coefficient N choose k.
  *
@@ -214,13 +510,16 @@ double CRRPricer::binom_coeff(int N, int k) {
  * Note that the closed-form formula is only valid for European options.
  */
 double CRRPricer::operator()(bool closed_form) {
+    if (!_option) {
+        throw std::logic_error("CRRPricer: call reconfigure() before pricing");
+    }
     if (_option->isAmericanOption() && closed_form) {
         throw std::logic_error("CRRPricer: closed form only for European options");
     }
 
     if (!closed_form) {
         if (!_computed) compute();
-        return _optionTree.getNode(0, 0);
+        return _storage == CRRStorage::Checkpointed ? _checkpoints[0] : _optionTree.getNode(0, 0);
     }
 
     double q = (_R - _D) / (_U - _D);
@@ -0,0 +1,85 @@
+#include <array>
+#include <stdexcept>
+#include <utility>
+#include "CRRPricer.h"
+#include "FixedDepthCRR.h"
+
+namespace {
+
+using Kernel = double (*)(const Option&, double, double, double, double);
+
+// kernels[d] prices a tree of depth d; depth 0 is the payoff itself
+double depthZero(const Option& option, double S0, double, double, double) {
+    return option.payoff(S0);
+}
+
+template <bool American, int... Depths>
+constexpr std::array<Kernel, sizeof...(Depths) + 1> makeTable(std::integer_sequence<int, Depths...>) {
+    return {&depthZero, &FixedDepthCRR::kernel<Depths + 1, American>...};
+}
+
+constexpr std::array<Kernel, FixedDepthCRR::kMaxDepth + 1> kEuropeanKernels = makeTable<false>(std::make_integer_sequence<int, FixedDepthCRR::kMaxDepth>());
+constexpr std::array<Kernel, FixedDepthCRR::kMaxDepth + 1> kAmericanKernels = makeTable<true>(std::make_integer_sequence<int, FixedDepthCRR::kMaxDepth>());
+
+}
+
+/**
+ * @param depth The depth of a CRR tree.
+ * @return True if a compile-time kernel exists for this depth.
+ */
+bool FixedDepthCRR::supports(int depth) {
+    return depth >= 0 && depth <= kMaxDepth;
+}
+
+/**
+ * @brief Price an option on a shallow CRR tree with the kernel compiled for its depth.
+ * @details The depth selects an entry of a table of kernel<Depth> instantiations, one per
+ * depth in [0, kMaxDepth] and per exercise style. The result matches CRRPricer on the same
+ * tree up to rounding, without any heap allocation.
+ * @param option The option to be priced.
+ * @param depth The depth of the tree, at most kMaxDepth.
+ * @param S0 The initial price of the underlying asset.
+ * @param U The gross up factor.
+ * @param D The gross down factor.
+ * @param R The gross one-step capitalisation factor.
+ * @return The price of the option.
+ * @throws std::invalid_argument if the option is null or Asian, the depth is not supported
+ * or D < R < U does not hold.
+ */
+double FixedDepthCRR::price(const Option* option, int depth, double S0, double U, double D, double R) {
+    if (!option) {
+        throw std::invalid_argument("FixedDepthCRR: option is null");
+    }
+    if (option->isAsianOption()) {
+        throw std::invalid_argument("FixedDepthCRR: Asian option not supported");
+    }
+    if (!supports(depth)) {
+        throw std::invalid_argument("FixedDepthCRR: depth must be in [0, 64]");
+    }
+    if (!(D > 0.0 && D < R && R < U)) {
+        throw std::invalid_argument("FixedDepthCRR: need 0 < D < R < U");
+    }
+    const Kernel kernel = option->isAmericanOption() ? kAmericanKernels[depth] : kEuropeanKernels[depth];
+    return kernel(*option, S0, U, D, R);
+}
+
+/**
+ * @brief Price an option on the shallow CRR tree of CRRPricer(option, depth, S0, r, volatility).
+ * @param option The option to be priced.
+ * @param depth The depth of the tree, in [1, kMaxDepth].
+ * @param S0 The initial price of the underlying asset.
+ * @param r The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ * @return The price of the option.
+ * @throws std::invalid_argument as the other overload, or if the time step is not positive.
+ */
+double FixedDepthCRR::price(const Option* option, int depth, double S0, double r, double volatility) {
+    if (!option) {
+        throw std::invalid_argument("FixedDepthCRR: option is null");
+    }
+    double U = 0.0;
+    double D = 0.0;
+    double R = 0.0;
+    CRRPricer::treeFactors(option->getExpiry(), depth, r, volatility, U, D, R);
+    return price(option, depth, S0, U, D, R);
+}
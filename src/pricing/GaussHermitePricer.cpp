@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include "GaussHermitePricer.h"
+#include "NormalDistribution.h"
+#include "TablePack.h"
+
+namespace {
+
+// the normal density is below 1e-18 beyond this many standard deviations
+constexpr double kTailSd = 9.0;
+constexpr double kNewtonTolerance = 1e-15;
+constexpr int kNewtonIterations = 100;
+
+/*
+ * Nodes and weights of the n-point Gauss-Hermite rule for the weight exp(-x^2), by Newton
+ * iteration on the orthonormal Hermite recurrence (Numerical Recipes, gauher).
+ */
+void hermiteRule(int n, std::vector<double>& x, std::vector<double>& w) {
+    const double pim4 = 0.7511255444649425; // pi^(-1/4)
+    x.assign(n, 0.0);
+    w.assign(n, 0.0);
+    double z = 0.0;
+    for (int i = 0; i < (n + 1) / 2; ++i) {
+        if (i == 0) {
+            z = std::sqrt(2.0 * n + 1.0) - 1.85575 * std::pow(2.0 * n + 1.0, -1.0 / 6.0);
+        } else if (i == 1) {
+            z -= 1.14 * std::pow(static_cast<double>(n), 0.426) / z;
+        } else if (i == 2) {
+            z = 1.86 * z - 0.86 * x[0];
+        } else if (i == 3) {
+            z = 1.91 * z - 0.91 * x[1];
+        } else {
+            z = 2.0 * z - x[i - 2];
+        }
+        double pp = 0.0;
+        for (int it = 0; it < kNewtonIterations; ++it) {
+            double p1 = pim4;
+            double p2 = 0.0;
+            for (int j = 0; j < n; ++j) {
+                const double p3 = p2;
+                p2 = p1;
+                p1 = z * std::sqrt(2.0 / (j + 1)) * p2 - std::sqrt(static_cast<double>(j) / (j + 1)) * p3;
+            }
+            pp = std::sqrt(2.0 * n) * p2;
+            const double previous = z;
+            z = previous - p1 / pp;
+            if (std::fabs(z - previous) <= kNewtonTolerance * std::max(1.0, std::fabs(z))) {
+                break;
+            }
+        }
+        x[i] = z;
+        x[n - 1 - i] = -z;
+        w[i] = 2.0 / (pp * pp);
+        w[n - 1 - i] = w[i];
+    }
+}
+
+/*
+ * Nodes and weights of the n-point Gauss-Legendre rule on [-1, 1], by Newton iteration on
+ * the Legendre recurrence (Numerical Recipes, gauleg).
+ */
+void legendreRule(int n, std::vector<double>& x, std::vector<double>& w) {
+    x.assign(n, 0.0);
+    w.assign(n, 0.0);
+    for (int i = 0; i < (n + 1) / 2; ++i) {
+        double z = std::cos(M_PI * (i + 0.75) / (n + 0.5));
+        double pp = 0.0;
+        for (int it = 0; it < kNewtonIterations; ++it) {
+            double p1 = 1.0;
+            double p2 = 0.0;
+            for (int j = 0; j < n; ++j) {
+                const double p3 = p2;
+                p2 = p1;
+                p1 = ((2.0 * j + 1.0) * z * p2 - j * p3) / (j + 1);
+            }
+            pp = n * (z * p1 - p2) / (z * z - 1.0);
+            const double previous = z;
+            z = previous - p1 / pp;
+            if (std::fabs(z - previous) <= kNewtonTolerance) {
+                break;
+            }
+        }
+        x[i] = -z;
+        x[n - 1 - i] = z;
+        w[i] = 2.0 / ((1.0 - z * z) * pp * pp);
+        w[n - 1 - i] = w[i];
+    }
+}
+
+}
+
+/**
+ * @brief Construct a quadrature pricer.
+ * @details The Gauss-Hermite and Gauss-Legendre rules are taken from the default table
+ * pack when it has them for this number of nodes, and computed otherwise; either way
+ * they are set up once here and reused by every price() call, as are the node buffers.
+ * @param nodes The number of nodes of each rule, at least 2.
+ * @throws std::invalid_argument if nodes < 2.
+ */
+GaussHermitePricer::GaussHermitePricer(int nodes) : _nodes(nodes) {
+    if (nodes < 2) {
+        throw std::invalid_argument("GaussHermitePricer: need at least two nodes");
+    }
+    const TablePack& pack = TablePack::defaultPack();
+    const std::string n = std::to_string(nodes);
+    const TableView tables[4] = {pack.find("gauss_hermite/" + n + "/nodes"), pack.find("gauss_hermite/" + n + "/weights"),
+                                 pack.find("gauss_legendre/" + n + "/nodes"), pack.find("gauss_legendre/" + n + "/weights")};
+    const bool packed = std::all_of(std::begin(tables), std::end(tables),
+                                    [nodes](const TableView& t) { return t.size == static_cast<std::size_t>(nodes); });
+    if (packed) {
+        _hermite_nodes.assign(tables[0].begin(), tables[0].end());
+        _hermite_weights.assign(tables[1].begin(), tables[1].end());
+        _legendre_nodes.assign(tables[2].begin(), tables[2].end());
+        _legendre_weights.assign(tables[3].begin(), tables[3].end());
+    } else {
+        computeRules(nodes, _hermite_nodes, _hermite_weights, _legendre_nodes, _legendre_weights);
+    }
+}
+
+/**
+ * @brief Compute the quadrature rules used by the pricer, as stored in the table pack.
+ * @details The Gauss-Hermite rule is in probabilists' form, E[f(Z)] = sum w_i f(x_i) for
+ * Z standard normal; the Gauss-Legendre rule is on [-1, 1].
+ * @param nodes The number of nodes of each rule, at least 2.
+ * @param hermite_nodes Receives the Gauss-Hermite nodes.
+ * @param hermite_weights Receives the Gauss-Hermite weights.
+ * @param legendre_nodes Receives the Gauss-Legendre nodes.
+ * @param legendre_weights Receives the Gauss-Legendre weights.
+ * @throws std::invalid_argument if nodes < 2.
+ */
+void GaussHermitePricer::computeRules(int nodes, std::vector<double>& hermite_nodes, std::vector<double>& hermite_weights,
+                                      std::vector<double>& legendre_nodes, std::vector<double>& legendre_weights) {
+    if (nodes < 2) {
+        throw std::invalid_argument("GaussHermitePricer: need at least two nodes");
+    }
+    hermiteRule(nodes, hermite_nodes, hermite_weights);
+    legendreRule(nodes, legendre_nodes, legendre_weights);
+    for (int i = 0; i < nodes; ++i) {
+        hermite_nodes[i] *= M_SQRT2;
+        hermite_weights[i] /= std::sqrt(M_PI);
+    }
+}
+
+/**
+ * @return The number of nodes of each quadrature rule.
+ */
+int GaussHermitePricer::getNodes() const {
+    return _nodes;
+}
+
+/**
+ * @brief Price a single-fixing option under Black-Scholes by quadrature.
+ * @details The price is exp(-rT) E[payoff(S_T)] with S_T = S0 exp((r - sigma^2 / 2) T +
+ * sigma sqrt(T) Z), integrated over Z. A smooth payoff (no getPayoffKinks()) is integrated
+ * by Gauss-Hermite over the whole line. A Gauss-Hermite rule cannot be split, so a payoff
+ * with kinks or jumps is integrated instead piece by piece between its kinks, by
+ * Gauss-Legendre against the normal density, over [-9, 9 + sigma sqrt(T)] standard
+ * deviations (the upper end covers the growth of a call-like payoff). Either way the nodes
+ * of all the pieces go through a single payoffBatch() call. Vanilla and digital options
+ * match the closed form to about 1e-15 at the money and within 1e-13 for maturities of
+ * 0.1 to 3 years, strikes of 60% to 150% and volatilities of 10% to 50%, with the default
+ * number of nodes. A payoff whose kinks are not declared is priced as smooth, far less
+ * accurately (see Option::getPayoffKinks()).
+ * @param option The option to be priced.
+ * @param S0 The initial price of the underlying asset.
+ * @param r The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ * @return The price of the option.
+ * @throws std::invalid_argument if the option is null, Asian or American, or S0 or the
+ * volatility is not positive.
+ */
+double GaussHermitePricer::price(const Option* option, double S0, double r, double volatility) {
+    if (!option) {
+        throw std::invalid_argument("GaussHermitePricer: option is null");
+    }
+    if (option->isAsianOption() || option->isAmericanOption()) {
+        throw std::invalid_argument("GaussHermitePricer: only single-fixing European options");
+    }
+    if (!(S0 > 0.0) || !(volatility > 0.0)) {
+        throw std::invalid_argument("GaussHermitePricer: S0 and volatility must be positive");
+    }
+    const double T = option->getExpiry();
+    if (T == 0.0) {
+        return option->payoff(S0);
+    }
+
+    const double drift = (r - 0.5 * volatility * volatility) * T;
+    const double sd = volatility * std::sqrt(T);
+    const double lo = -kTailSd;
+    const double hi = kTailSd + sd;
+
+    // kinks in Z, inside the integration range
+    _breaks.clear();
+    for (double kink : option->getPayoffKinks()) {
+        if (kink > 0.0) {
+            const double z = (std::log(kink / S0) - drift) / sd;
+            if (z > lo && z < hi) {
+                _breaks.push_back(z);
+            }
+        }
+    }
+
+    _spots.clear();
+    _weights.clear();
+    if (_breaks.empty()) {
+        for (int i = 0; i < _nodes; ++i) {
+            _spots.push_back(S0 * std::exp(drift + sd * _hermite_nodes[i]));
+            _weights.push_back(_hermite_weights[i]);
+        }
+    } else {
+        std::sort(_breaks.begin(), _breaks.end());
+        _breaks.insert(_breaks.begin(), lo);
+        _breaks.push_back(hi);
+        for (std::size_t piece = 0; piece + 1 < _breaks.size(); ++piece) {
+            const double half = 0.5 * (_breaks[piece + 1] - _breaks[piece]);
+            const double mid = 0.5 * (_breaks[piece + 1] + _breaks[piece]);
+            if (half <= 0.0) {
+                continue;
+            }
+            for (int i = 0; i < _nodes; ++i) {
+                const double z = mid + half * _legendre_nodes[i];
+                _spots.push_back(S0 * std::exp(drift + sd * z));
+                _weights.push_back(half * _legendre_weights[i] * NormalDistribution::pdf(z));
+            }
+        }
+    }
+    return std::exp(-r * T) * integrate(*option);
+}
+
+/**
+ * @brief Sum of the weights times the payoffs at the spots of the current nodes.
+ */
+double GaussHermitePricer::integrate(const Option& option) {
+    _payoffs.resize(_spots.size());
+    option.payoffBatch(_spots.data(), _payoffs.data(), _spots.size());
+    double sum = 0.0;
+    for (std::size_t i = 0; i < _spots.size(); ++i) {
+        sum += _weights[i] * _payoffs[i];
+    }
+    return sum;
+}
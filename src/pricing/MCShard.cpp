@@ -0,0 +1,653 @@
+#include "MCShard.h"
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <sstream>
+#include <stdexcept>
+#include "BlackScholesMCPricer.h"
+#include "MT.h"
+
+namespace {
+
+// messages are a 4-byte type and a 4-byte length followed by the payload, in native byte order
+enum class Message : std::uint32_t { Hello = 1, Range = 2, Result = 3, Done = 4, Reject = 5 };
+
+constexpr std::uint32_t kProtocolVersion = 2;
+constexpr std::uint32_t kMaxPayload = 64u << 20;
+constexpr int kMaxAttempts = 3;
+constexpr int kPollMilliseconds = 100;
+constexpr double kZ = 1.96;
+// the payoff is fingerprinted on flat paths at S0 exp(k / kProbeSteps), |k| <= kProbeLevels,
+// and on a rising and a falling path between S0 / 2 and 2 S0
+constexpr int kProbeLevels = 16;
+constexpr double kProbeSteps = 8.0;
+
+using Clock = std::chrono::steady_clock;
+
+template <class T>
+void put(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool get(const std::string& in, std::size_t& pos, T& value) {
+    if (in.size() - pos < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+bool getBytes(const std::string& in, std::size_t& pos, std::string& value) {
+    std::uint64_t size = 0;
+    if (!get(in, pos, size) || in.size() - pos < size) {
+        return false;
+    }
+    value.assign(in, pos, size);
+    pos += size;
+    return true;
+}
+
+bool sendAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+bool recvAll(int fd, char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t received = ::recv(fd, data, size, 0);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+bool sendMessage(int fd, Message type, const std::string& payload) {
+    std::string frame;
+    put(frame, static_cast<std::uint32_t>(type));
+    put(frame, static_cast<std::uint32_t>(payload.size()));
+    frame += payload;
+    return sendAll(fd, frame.data(), frame.size());
+}
+
+// false on end of stream, error, timeout or an oversized frame
+bool recvMessage(int fd, Message& type, std::string& payload) {
+    std::uint32_t header[2] = {};
+    if (!recvAll(fd, reinterpret_cast<char*>(header), sizeof(header)) || header[1] > kMaxPayload) {
+        return false;
+    }
+    type = static_cast<Message>(header[0]);
+    payload.resize(header[1]);
+    return header[1] == 0 || recvAll(fd, &payload[0], header[1]);
+}
+
+void setTimeouts(int fd, double seconds) {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(seconds);
+    tv.tv_usec = static_cast<suseconds_t>((seconds - std::floor(seconds)) * 1e6);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+// everything both sides must agree on, option included as far as it can be observed:
+// its schedule and type, and its payoff on a set of probe paths, which tells apart
+// strikes and payoff shapes
+std::string fingerprint(const Option* option, const MCShardJob& job) {
+    std::string out;
+    put(out, kProtocolVersion);
+    put(out, job.job_id);
+    put(out, job.initial_price);
+    put(out, job.interest_rate);
+    put(out, job.volatility);
+    put(out, job.seed);
+    put(out, job.chunk_paths);
+    put(out, job.digest_compression);
+    put(out, job.histogram_lower);
+    put(out, job.histogram_upper);
+    put(out, job.histogram_bins);
+    put(out, option->getExpiry());
+    put(out, static_cast<std::uint32_t>(option->getOptionType()));
+    put(out, static_cast<std::uint32_t>(option->isAsianOption()));
+    for (double t : option->isAsianOption() ? option->getTimeSteps() : std::vector<double>{}) {
+        put(out, t);
+    }
+    const std::size_t steps = option->getTimeSteps().size();
+    std::vector<double> path(steps);
+    for (int k = -kProbeLevels; k <= kProbeLevels; ++k) {
+        path.assign(steps, job.initial_price * std::exp(k / kProbeSteps));
+        put(out, option->payoffPath(path));
+    }
+    for (double direction : {1.0, -1.0}) {
+        for (std::size_t j = 0; j < steps; ++j) {
+            const double u = steps > 1 ? static_cast<double>(j) / static_cast<double>(steps - 1) : 1.0;
+            path[j] = job.initial_price * std::exp(direction * std::log(2.0) * (2.0 * u - 1.0));
+        }
+        put(out, option->payoffPath(path));
+    }
+    return out;
+}
+
+void checkJob(const Option* option, const MCShardJob& job, const char* who) {
+    if (!option) {
+        throw std::invalid_argument(std::string(who) + ": option pointer must not be null");
+    }
+    if (job.chunk_paths < 2 || job.chunk_paths > static_cast<std::uint64_t>(INT_MAX)) {
+        throw std::invalid_argument(std::string(who) + ": chunk size must be in [2, INT_MAX]");
+    }
+    if (job.digest_compression != 0.0 && !(job.digest_compression >= 10.0)) {
+        throw std::invalid_argument(std::string(who) + ": digest compression must be 0 or at least 10");
+    }
+    if (job.histogram_bins < 0 || (job.histogram_bins > 0 && !(job.histogram_lower < job.histogram_upper))) {
+        throw std::invalid_argument(std::string(who) + ": invalid histogram bins");
+    }
+}
+
+// the Result payload of a chunk: a fresh pricer on its own substream, and fresh sketches
+std::string simulateChunk(Option* option, const MCShardJob& job, BlackScholesMCPricer& pricer, std::uint64_t chunk, std::uint64_t nb_paths) {
+    MT::setSubstream(job.seed, chunk);
+    pricer.reconfigure(option, job.initial_price, job.interest_rate, job.volatility);
+    std::unique_ptr<TDigest> digest;
+    std::unique_ptr<Histogram> histogram;
+    if (job.digest_compression > 0.0) {
+        digest = std::make_unique<TDigest>(job.digest_compression);
+    }
+    if (job.histogram_bins > 0) {
+        histogram = std::make_unique<Histogram>(job.histogram_lower, job.histogram_upper, job.histogram_bins);
+    }
+    pricer.setSketches(digest.get(), histogram.get());
+    pricer.generate(static_cast<int>(nb_paths));
+    pricer.setSketches(nullptr, nullptr);
+
+    std::string out;
+    put(out, chunk);
+    put(out, static_cast<std::uint64_t>(pricer.getNbPaths()));
+    put(out, pricer.price());
+    put(out, pricer.getM2());
+    std::ostringstream sketch;
+    if (digest) {
+        digest->save(sketch);
+    }
+    put(out, static_cast<std::uint64_t>(sketch.str().size()));
+    out += sketch.str();
+    sketch.str("");
+    if (histogram) {
+        histogram->save(sketch);
+    }
+    put(out, static_cast<std::uint64_t>(sketch.str().size()));
+    out += sketch.str();
+    return out;
+}
+
+}
+
+/**
+ * @brief Construct a coordinator for a job.
+ * @param option The option to be priced, the same as the workers'.
+ * @param job The job, the same as the workers'.
+ * @throws std::invalid_argument if the option is null or the job is invalid.
+ */
+MCShardCoordinator::MCShardCoordinator(Option* option, const MCShardJob& job) : _option(option), _job(job) {
+    checkJob(option, job, "MCShardCoordinator");
+}
+
+MCShardCoordinator::~MCShardCoordinator() {
+    if (_listen_fd >= 0) {
+        ::close(_listen_fd);
+    }
+}
+
+/**
+ * @brief Open the TCP port the workers connect to.
+ * @param address The IPv4 address to listen on: the loopback by default, "0.0.0.0" for
+ * workers on other hosts.
+ * @param port The port, 0 for any free one.
+ * @return The port listened on.
+ * @throws std::invalid_argument if the address is not an IPv4 address.
+ * @throws std::runtime_error if the port cannot be opened.
+ */
+unsigned short MCShardCoordinator::listen(const std::string& address, unsigned short port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        throw std::invalid_argument("MCShardCoordinator: not an IPv4 address: " + address);
+    }
+    if (_listen_fd >= 0) {
+        ::close(_listen_fd);
+    }
+    _listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    const int yes = 1;
+    if (_listen_fd < 0 || ::setsockopt(_listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) != 0 ||
+        ::bind(_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(_listen_fd, SOMAXCONN) != 0) {
+        const std::string reason = std::strerror(errno);
+        if (_listen_fd >= 0) {
+            ::close(_listen_fd);
+            _listen_fd = -1;
+        }
+        throw std::runtime_error("MCShardCoordinator: cannot listen: " + reason);
+    }
+    socklen_t size = sizeof(addr);
+    ::getsockname(_listen_fd, reinterpret_cast<sockaddr*>(&addr), &size);
+    return ntohs(addr.sin_port);
+}
+
+/**
+ * @brief Set how long a worker may take over a chunk, or a message, before it is deemed dead.
+ * @param seconds The timeout, positive; 60 seconds by default.
+ * @throws std::invalid_argument if seconds is not positive.
+ */
+void MCShardCoordinator::setWorkerTimeout(double seconds) {
+    if (!(seconds > 0.0)) {
+        throw std::invalid_argument("MCShardCoordinator: worker timeout must be positive");
+    }
+    _worker_timeout = seconds;
+}
+
+/**
+ * @brief Set how long run() may take in all before it gives up.
+ * @param seconds The deadline, 0 (the default) for none: run() then waits for workers
+ * for as long as it takes, forever if none ever connects.
+ * @throws std::invalid_argument if seconds is negative.
+ */
+void MCShardCoordinator::setRunTimeout(double seconds) {
+    if (!(seconds >= 0.0)) {
+        throw std::invalid_argument("MCShardCoordinator: run timeout must not be negative");
+    }
+    _run_timeout = seconds;
+}
+
+/**
+ * @brief Split nb_paths into chunks and forget any previous result.
+ */
+void MCShardCoordinator::plan(std::uint64_t nb_paths) {
+    if (nb_paths == 0) {
+        throw std::invalid_argument("MCShardCoordinator: number of paths must be positive");
+    }
+    const std::uint64_t nb_chunks = (nb_paths + _job.chunk_paths - 1) / _job.chunk_paths;
+    _chunks.assign(nb_chunks, Chunk());
+    for (std::uint64_t c = 0; c < nb_chunks; ++c) {
+        _chunks[c].nb_paths = std::min(_job.chunk_paths, nb_paths - c * _job.chunk_paths);
+    }
+    _nb_paths = 0;
+    _reissued = 0;
+    _workers = 0;
+}
+
+/**
+ * @brief Price nb_paths paths on the workers connected to the port.
+ * @details Workers may connect at any time during the run; each is handed one chunk at a
+ * time. A worker that disconnects, fails to send a well-formed result, or holds a chunk
+ * longer than the worker timeout is dropped and its chunk handed to the next idle worker.
+ * Once every chunk is in, the workers are told to stop (workers still waiting to be
+ * accepted are left to the next run), and the chunk results are merged
+ * in chunk order: the estimate, its confidence interval and the sketches are the same
+ * bit for bit whichever workers ran which chunks, and the same as runLocal()'s. Without
+ * a run timeout (see setRunTimeout()) this blocks until every chunk is in, however long
+ * no worker connects.
+ * @param nb_paths The number of paths.
+ * @throws std::logic_error if listen() was not called.
+ * @throws std::invalid_argument if nb_paths is 0.
+ * @throws std::runtime_error if a chunk was lost by kMaxAttempts (3) workers, or the
+ * run timeout expired; the connected workers are then dropped and no result is kept.
+ */
+void MCShardCoordinator::run(std::uint64_t nb_paths) {
+    if (_listen_fd < 0) {
+        throw std::logic_error("MCShardCoordinator: call listen() before run()");
+    }
+    plan(nb_paths);
+
+    struct Connection {
+        int fd;
+        bool greeted;
+        std::int64_t chunk;
+        Clock::time_point since;
+    };
+    std::vector<Connection> connections;
+    std::deque<std::uint64_t> pending;
+    for (std::uint64_t c = 0; c < _chunks.size(); ++c) {
+        pending.push_back(c);
+    }
+    std::uint64_t remaining = _chunks.size();
+    const std::string expected = fingerprint(_option, _job);
+    const Clock::time_point start = Clock::now();
+
+    const auto drop = [&](std::size_t i) {
+        Connection& connection = connections[i];
+        ::close(connection.fd);
+        if (connection.chunk >= 0 && !_chunks[static_cast<std::size_t>(connection.chunk)].done) {
+            pending.push_front(static_cast<std::uint64_t>(connection.chunk));
+            ++_reissued;
+        }
+        connections.erase(connections.begin() + static_cast<std::ptrdiff_t>(i));
+    };
+    const auto closeAll = [&]() {
+        for (const Connection& connection : connections) {
+            ::close(connection.fd);
+        }
+        connections.clear();
+    };
+
+    std::vector<pollfd> fds;
+    Message type{};
+    std::string payload;
+    while (remaining > 0) {
+        fds.assign(1, pollfd{_listen_fd, POLLIN, 0});
+        for (const Connection& connection : connections) {
+            fds.push_back(pollfd{connection.fd, POLLIN, 0});
+        }
+        ::poll(fds.data(), fds.size(), kPollMilliseconds);
+
+        // existing connections first: fds[i + 1] is connections[i] until one is dropped
+        for (std::size_t f = fds.size() - 1; f >= 1; --f) {
+            const std::size_t i = f - 1;
+            if (!(fds[f].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            Connection& connection = connections[i];
+            if (!recvMessage(connection.fd, type, payload)) {
+                drop(i);
+                continue;
+            }
+            if (!connection.greeted) {
+                if (type != Message::Hello || payload != expected) {
+                    sendMessage(connection.fd, Message::Reject, std::string());
+                    drop(i);
+                    continue;
+                }
+                connection.greeted = true;
+                ++_workers;
+                continue;
+            }
+            std::size_t pos = 0;
+            std::uint64_t chunk = 0;
+            Chunk result;
+            if (type != Message::Result || !get(payload, pos, chunk) || static_cast<std::int64_t>(chunk) != connection.chunk ||
+                !get(payload, pos, result.nb_paths) || !get(payload, pos, result.mean) || !get(payload, pos, result.M2) ||
+                !getBytes(payload, pos, result.digest) || !getBytes(payload, pos, result.histogram) ||
+                result.nb_paths != _chunks[chunk].nb_paths) {
+                drop(i);
+                continue;
+            }
+            result.done = true;
+            result.attempts = _chunks[chunk].attempts;
+            _chunks[chunk] = std::move(result);
+            connection.chunk = -1;
+            --remaining;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            const int fd = ::accept(_listen_fd, nullptr, nullptr);
+            if (fd >= 0) {
+                setTimeouts(fd, _worker_timeout);
+                connections.push_back(Connection{fd, false, -1, Clock::now()});
+            }
+        }
+
+        const Clock::time_point now = Clock::now();
+        if (_run_timeout > 0.0 && std::chrono::duration<double>(now - start).count() > _run_timeout) {
+            closeAll();
+            throw std::runtime_error("MCShardCoordinator: run timed out with " + std::to_string(remaining) + " of " +
+                                     std::to_string(_chunks.size()) + " chunks left");
+        }
+        for (std::size_t i = connections.size(); i-- > 0;) {
+            Connection& connection = connections[i];
+            if (connection.chunk >= 0) {
+                if (std::chrono::duration<double>(now - connection.since).count() > _worker_timeout) {
+                    drop(i);
+                }
+                continue;
+            }
+            if (!connection.greeted || pending.empty()) {
+                continue;
+            }
+            const std::uint64_t chunk = pending.front();
+            if (_chunks[chunk].attempts >= kMaxAttempts) {
+                closeAll();
+                throw std::runtime_error("MCShardCoordinator: chunk " + std::to_string(chunk) + " lost by too many workers");
+            }
+            std::string range;
+            put(range, chunk);
+            put(range, _chunks[chunk].nb_paths);
+            pending.pop_front();
+            ++_chunks[chunk].attempts;
+            connection.chunk = static_cast<std::int64_t>(chunk);
+            connection.since = now;
+            if (!sendMessage(connection.fd, Message::Range, range)) {
+                drop(i);
+            }
+        }
+    }
+
+    for (const Connection& connection : connections) {
+        if (connection.greeted) {
+            sendMessage(connection.fd, Message::Done, std::string());
+        }
+    }
+    closeAll();
+    merge();
+}
+
+/**
+ * @brief Price nb_paths paths in this process, chunk after chunk, as a worker would.
+ * @details Gives the same result as run() over any set of workers. Leaves MT on the
+ * substream of the last chunk.
+ * @param nb_paths The number of paths.
+ * @throws std::invalid_argument if nb_paths is 0.
+ */
+void MCShardCoordinator::runLocal(std::uint64_t nb_paths) {
+    plan(nb_paths);
+    BlackScholesMCPricer pricer;
+    for (std::uint64_t c = 0; c < _chunks.size(); ++c) {
+        const std::string payload = simulateChunk(_option, _job, pricer, c, _chunks[c].nb_paths);
+        std::size_t pos = sizeof(std::uint64_t);
+        Chunk& chunk = _chunks[c];
+        get(payload, pos, chunk.nb_paths);
+        get(payload, pos, chunk.mean);
+        get(payload, pos, chunk.M2);
+        getBytes(payload, pos, chunk.digest);
+        getBytes(payload, pos, chunk.histogram);
+        chunk.done = true;
+    }
+    merge();
+}
+
+/**
+ * @brief Combine the chunk results in chunk order (Chan et al. for the mean and M2).
+ */
+void MCShardCoordinator::merge() {
+    _nb_paths = 0;
+    _mean = 0.0;
+    _M2 = 0.0;
+    _quantiles.reset();
+    _histogram.reset();
+    if (_job.digest_compression > 0.0) {
+        _quantiles = std::make_unique<TDigest>(_job.digest_compression);
+    }
+    if (_job.histogram_bins > 0) {
+        _histogram = std::make_unique<Histogram>(_job.histogram_lower, _job.histogram_upper, _job.histogram_bins);
+    }
+    for (const Chunk& chunk : _chunks) {
+        const double n_a = static_cast<double>(_nb_paths);
+        const double n_b = static_cast<double>(chunk.nb_paths);
+        const double delta = chunk.mean - _mean;
+        _nb_paths += chunk.nb_paths;
+        const double n = static_cast<double>(_nb_paths);
+        _mean += delta * n_b / n;
+        _M2 += chunk.M2 + delta * delta * n_a * n_b / n;
+        if (_quantiles) {
+            std::istringstream in(chunk.digest);
+            _quantiles->merge(TDigest::load(in));
+        }
+        if (_histogram) {
+            std::istringstream in(chunk.histogram);
+            _histogram->merge(Histogram::load(in));
+        }
+    }
+}
+
+/**
+ * @return The number of paths of the last run.
+ */
+std::uint64_t MCShardCoordinator::getNbPaths() const {
+    return _nb_paths;
+}
+
+/**
+ * @return The price estimated by the last run.
+ * @throws std::logic_error if nothing was run.
+ */
+double MCShardCoordinator::price() const {
+    if (_nb_paths == 0) {
+        throw std::logic_error("MCShardCoordinator: call run() before requesting price");
+    }
+    return _mean;
+}
+
+/**
+ * @return The 95% confidence interval of the price estimated by the last run.
+ * @throws std::logic_error if the last run had fewer than two paths.
+ */
+std::vector<double> MCShardCoordinator::confidenceInterval() const {
+    if (_nb_paths < 2) {
+        throw std::logic_error("MCShardCoordinator: need at least two paths for confidence interval");
+    }
+    const double n = static_cast<double>(_nb_paths);
+    const double std_err = std::sqrt(_M2 / (n - 1.0) / n);
+    return {_mean - kZ * std_err, _mean + kZ * std_err};
+}
+
+/**
+ * @return The quantile sketch of the discounted payoffs of the last run.
+ * @throws std::logic_error if the job has no quantile sketch or nothing was run.
+ */
+TDigest& MCShardCoordinator::getQuantiles() {
+    if (!_quantiles) {
+        throw std::logic_error("MCShardCoordinator: no quantile sketch");
+    }
+    return *_quantiles;
+}
+
+/**
+ * @return The histogram of the discounted payoffs of the last run.
+ * @throws std::logic_error if the job has no histogram or nothing was run.
+ */
+Histogram& MCShardCoordinator::getHistogram() {
+    if (!_histogram) {
+        throw std::logic_error("MCShardCoordinator: no histogram");
+    }
+    return *_histogram;
+}
+
+/**
+ * @return The number of chunks handed out again after their worker was lost, in the last run.
+ */
+int MCShardCoordinator::getReissued() const {
+    return _reissued;
+}
+
+/**
+ * @return The number of workers accepted during the last run.
+ */
+int MCShardCoordinator::getWorkers() const {
+    return _workers;
+}
+
+/**
+ * @brief Construct a worker for a job.
+ * @param option The option to be priced, the same as the coordinator's.
+ * @param job The job, the same as the coordinator's.
+ * @throws std::invalid_argument if the option is null or the job is invalid.
+ */
+MCShardWorker::MCShardWorker(Option* option, const MCShardJob& job) : _option(option), _job(job) {
+    checkJob(option, job, "MCShardWorker");
+}
+
+/**
+ * @brief Set a function called with the index of every chunk before it is simulated.
+ */
+void MCShardWorker::setChunkCallback(std::function<void(std::uint64_t)> on_chunk) {
+    _on_chunk = std::move(on_chunk);
+}
+
+/**
+ * @brief Connect to a coordinator and simulate the chunks it hands out until it is done.
+ * @details Draws go through MT, which is left on the substream of the last chunk.
+ * @param host The host name or address of the coordinator.
+ * @param port The port of the coordinator.
+ * @return The number of chunks simulated.
+ * @throws std::runtime_error if the connection fails or is lost, or the coordinator
+ * rejects the job.
+ */
+std::uint64_t MCShardWorker::run(const std::string& host, unsigned short port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        throw std::runtime_error("MCShardWorker: cannot resolve " + host);
+    }
+    int fd = -1;
+    for (addrinfo* a = addresses; a && fd < 0; a = a->ai_next) {
+        fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(addresses);
+    if (fd < 0) {
+        throw std::runtime_error("MCShardWorker: cannot connect to " + host + ":" + std::to_string(port));
+    }
+
+    std::uint64_t done = 0;
+    BlackScholesMCPricer pricer;
+    Message type{};
+    std::string payload;
+    bool ok = sendMessage(fd, Message::Hello, fingerprint(_option, _job));
+    while (ok && recvMessage(fd, type, payload)) {
+        if (type == Message::Done) {
+            ::close(fd);
+            return done;
+        }
+        if (type == Message::Reject) {
+            ::close(fd);
+            throw std::runtime_error("MCShardWorker: the coordinator rejected the job");
+        }
+        std::size_t pos = 0;
+        std::uint64_t chunk = 0;
+        std::uint64_t nb_paths = 0;
+        if (type != Message::Range || !get(payload, pos, chunk) || !get(payload, pos, nb_paths) ||
+            nb_paths == 0 || nb_paths > _job.chunk_paths) {
+            break;
+        }
+        if (_on_chunk) {
+            _on_chunk(chunk);
+        }
+        ok = sendMessage(fd, Message::Result, simulateChunk(_option, _job, pricer, chunk, nb_paths));
+        ++done;
+    }
+    ::close(fd);
+    throw std::runtime_error("MCShardWorker: connection to the coordinator lost");
+}
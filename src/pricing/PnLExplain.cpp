@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "PnLExplain.h"
+
+namespace {
+
+// below this many positions per thread the spawn cost dominates the kernel
+constexpr std::size_t kMinPositionsPerThread = 512;
+
+}
+
+/**
+ * @brief Construct a PnLExplain instance.
+ * @details The explain attributes the P&L of each position between two valuation dates to
+ * the Taylor terms of its Black-Scholes price (delta, gamma, vega, theta, rho, vanna,
+ * volga) and compares their sum to the full revaluation at the second date.
+ * @param elapsed The year fraction between the two valuation dates.
+ * @param nb_threads The number of worker threads, 0 to use the hardware concurrency.
+ * @throws std::invalid_argument if elapsed is negative.
+ */
+PnLExplain::PnLExplain(double elapsed, unsigned nb_threads) : _elapsed(elapsed), _nb_threads(nb_threads) {
+    if (_elapsed < 0.0) {
+        throw std::invalid_argument("PnLExplain: elapsed time must be nonnegative");
+    }
+    if (_nb_threads == 0) {
+        _nb_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void PnLExplain::addPosition(OptionType type, bool digital, double strike, double expiry, double quantity, const MarketData& start, const MarketData& end) {
+    if (expiry < _elapsed) {
+        throw std::invalid_argument("PnLExplain: option expires before the end date");
+    }
+    _start.add(type, digital, start.spot, strike, expiry, start.rate, start.volatility);
+    _end.add(type, digital, end.spot, strike, expiry - _elapsed, end.rate, end.volatility);
+    _quantity.push_back(quantity);
+    _computed = false;
+}
+
+/**
+ * @brief Add a vanilla position to the explain.
+ * @param option The option held.
+ * @param quantity The signed number of options held.
+ * @param start The market at the first valuation date.
+ * @param end The market at the second valuation date.
+ * @throws std::invalid_argument if the option is null, the markets are invalid or the
+ * option expires before the second date.
+ */
+void PnLExplain::addPosition(EuropeanVanillaOption* option, double quantity, const MarketData& start, const MarketData& end) {
+    if (!option) {
+        throw std::invalid_argument("PnLExplain: option pointer must not be null");
+    }
+    addPosition(option->getOptionType(), false, option->getStrike(), option->getExpiry(), quantity, start, end);
+}
+
+/**
+ * @brief Add a digital position to the explain.
+ * @param option The option held.
+ * @param quantity The signed number of options held.
+ * @param start The market at the first valuation date.
+ * @param end The market at the second valuation date.
+ * @throws std::invalid_argument if the option is null, the markets are invalid or the
+ * option expires before the second date.
+ */
+void PnLExplain::addPosition(EuropeanDigitalOption* option, double quantity, const MarketData& start, const MarketData& end) {
+    if (!option) {
+        throw std::invalid_argument("PnLExplain: option pointer must not be null");
+    }
+    addPosition(option->getOptionType(), true, option->getStrike(), option->getExpiry(), quantity, start, end);
+}
+
+/**
+ * @return The number of positions.
+ */
+std::size_t PnLExplain::size() const {
+    return _quantity.size();
+}
+
+/**
+ * @brief Compute the greeks, the full revaluation and the explain of positions [begin, end).
+ * @details Greeks at the first date and prices at the second date are produced by the
+ * batch kernels on the same range, then combined while the range is still hot in cache.
+ */
+void PnLExplain::explainRange(std::size_t begin, std::size_t end) {
+    BlackScholesBatch::greeks(_start, _greeks, begin, end);
+    BlackScholesBatch::price(_end, _end_prices.data(), begin, end);
+
+    for (std::size_t j = begin; j < end; ++j) {
+        const double q = _quantity[j];
+        const double dS = _end.spot[j] - _start.spot[j];
+        const double dvol = _end.volatility[j] - _start.volatility[j];
+        const double dr = _end.rate[j] - _start.rate[j];
+
+        PnLExplainLine& line = _lines[j];
+        line.delta = q * _greeks.delta[j] * dS;
+        line.gamma = q * 0.5 * _greeks.gamma[j] * dS * dS;
+        line.vega = q * _greeks.vega[j] * dvol;
+        line.theta = q * _greeks.theta[j] * _elapsed;
+        line.rho = q * _greeks.rho[j] * dr;
+        line.vanna = q * _greeks.vanna[j] * dS * dvol;
+        line.volga = q * 0.5 * _greeks.volga[j] * dvol * dvol;
+        line.explained = line.delta + line.gamma + line.vega + line.theta + line.rho + line.vanna + line.volga;
+        line.actual = q * (_end_prices[j] - _greeks.price[j]);
+        line.unexplained = line.actual - line.explained;
+    }
+}
+
+/**
+ * @brief Compute the explain of every position and the aggregated columns.
+ * @details Positions are split in contiguous ranges, one per worker thread. The totals are
+ * summed in position order after the workers have joined, so they do not depend on the
+ * number of threads.
+ */
+void PnLExplain::compute() {
+    const std::size_t n = size();
+    _greeks.resize(n);
+    _end_prices.resize(n);
+    _lines.assign(n, PnLExplainLine());
+
+    const std::size_t workers = std::max<std::size_t>(1, std::min<std::size_t>(_nb_threads, n / kMinPositionsPerThread));
+    if (workers == 1) {
+        explainRange(0, n);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        const std::size_t chunk = (n + workers - 1) / workers;
+        for (std::size_t w = 0; w < workers; ++w) {
+            const std::size_t begin = w * chunk;
+            const std::size_t end = std::min(n, begin + chunk);
+            threads.emplace_back([this, begin, end]() { explainRange(begin, end); });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    _total = PnLExplainLine();
+    for (const PnLExplainLine& line : _lines) {
+        _total.delta += line.delta;
+        _total.gamma += line.gamma;
+        _total.vega += line.vega;
+        _total.theta += line.theta;
+        _total.rho += line.rho;
+        _total.vanna += line.vanna;
+        _total.volga += line.volga;
+        _total.explained += line.explained;
+        _total.actual += line.actual;
+        _total.unexplained += line.unexplained;
+    }
+    _computed = true;
+}
+
+/**
+ * @brief Return the explain of one position.
+ * @param i The index of the position, in insertion order.
+ * @throws std::logic_error if compute() has not been called.
+ * @throws std::out_of_range if i is out of range.
+ */
+const PnLExplainLine& PnLExplain::position(std::size_t i) const {
+    return positions().at(i);
+}
+
+/**
+ * @brief Return the explain of every position, in insertion order.
+ * @throws std::logic_error if compute() has not been called.
+ */
+const std::vector<PnLExplainLine>& PnLExplain::positions() const {
+    if (!_computed) {
+        throw std::logic_error("PnLExplain: call compute() before reading the explain");
+    }
+    return _lines;
+}
+
+/**
+ * @brief Return the explain aggregated over every position.
+ * @throws std::logic_error if compute() has not been called.
+ */
+const PnLExplainLine& PnLExplain::total() const {
+    if (!_computed) {
+        throw std::logic_error("PnLExplain: call compute() before reading the explain");
+    }
+    return _total;
+}
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "PortfolioMCScheduler.h"
+
+namespace {
+
+constexpr double kZ = 1.96;
+// floor on the measured cost, so that a batch timed at zero does not look free
+constexpr double kMinSecondsPerPath = 1e-9;
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}
+
+/**
+ * @brief Construct an empty scheduler, with 2048 pilot paths and batches of 8192 paths.
+ */
+PortfolioMCScheduler::PortfolioMCScheduler() = default;
+
+/**
+ * @brief Add a trade to the portfolio.
+ * @details The trade gets its own BlackScholesMCPricer; the option must outlive the
+ * scheduler. The portfolio value is the sum of quantity times price over the trades.
+ * Adding a trade after run() is allowed: the next run() pilots it first.
+ * @param option The option to be priced.
+ * @param initial_price The initial price of the underlying asset.
+ * @param interest_rate The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ * @param quantity The signed number of options held (notional weight).
+ * @return The index of the trade.
+ */
+std::size_t PortfolioMCScheduler::add(Option* option, double initial_price, double interest_rate, double volatility, double quantity) {
+    _trades.push_back(Trade{BlackScholesMCPricer(option, initial_price, interest_rate, volatility), quantity, 0.0});
+    return _trades.size() - 1;
+}
+
+/**
+ * @return The number of trades.
+ */
+std::size_t PortfolioMCScheduler::size() const {
+    return _trades.size();
+}
+
+/**
+ * @brief Set the size of the pilot run and of the batches allocated afterwards.
+ * @param pilot_paths The paths each trade is first priced with, at least 2.
+ * @param batch_paths The paths of every later batch, at least 1.
+ * @throws std::invalid_argument if a size is too small.
+ */
+void PortfolioMCScheduler::setBatchPaths(int pilot_paths, int batch_paths) {
+    if (pilot_paths < 2 || batch_paths < 1) {
+        throw std::invalid_argument("PortfolioMCScheduler: need at least two pilot paths and one path per batch");
+    }
+    _pilot_paths = pilot_paths;
+    _batch_paths = batch_paths;
+}
+
+/**
+ * @brief Simulate until the portfolio confidence interval is narrow enough or time is up.
+ * @details Every trade without paths is first given a pilot run, which measures both its
+ * variance and its cost per path (wall clock). Then, batch after batch, the next batch
+ * goes to the trade whose batch removes the most portfolio variance per second: adding
+ * b paths to trade j, of variance of the mean v_j after n_j paths, removes
+ * quantity_j^2 v_j b / (n_j + b) at a cost of b times its measured seconds per path. Both
+ * the variance and the cost estimates are refreshed after every batch. Small or
+ * low-variance trades thus stay near their pilot, while the trades dominating the
+ * portfolio error get the paths. The pilots always run, even past the deadline.
+ * @param target_half_width The half-width of the 95% portfolio confidence interval to
+ * reach; 0 to run until the deadline.
+ * @param max_seconds The time budget of this call, in seconds; infinite by default.
+ * @return true if the target was met, false if the deadline stopped the run first.
+ * @throws std::invalid_argument if the target is negative, max_seconds is negative, or
+ * neither bounds the run.
+ * @throws std::logic_error if the portfolio is empty.
+ */
+bool PortfolioMCScheduler::run(double target_half_width, double max_seconds) {
+    if (!(target_half_width >= 0.0) || !(max_seconds >= 0.0)) {
+        throw std::invalid_argument("PortfolioMCScheduler: target and time budget must be non-negative");
+    }
+    if (target_half_width == 0.0 && std::isinf(max_seconds)) {
+        throw std::invalid_argument("PortfolioMCScheduler: need a target or a time budget");
+    }
+    if (_trades.empty()) {
+        throw std::logic_error("PortfolioMCScheduler: no trade to price");
+    }
+    const Clock::time_point start = Clock::now();
+    for (Trade& trade : _trades) {
+        if (trade.pricer.getNbPaths() == 0) {
+            simulate(trade, _pilot_paths);
+        }
+    }
+
+    bool reached = false;
+    while (true) {
+        double total = 0.0;
+        std::size_t best = 0;
+        double best_rate = -1.0;
+        for (std::size_t j = 0; j < _trades.size(); ++j) {
+            const Trade& trade = _trades[j];
+            const double weighted = trade.quantity * trade.quantity * variance(j);
+            total += weighted;
+            const double n = trade.pricer.getNbPaths();
+            const double removed = weighted * _batch_paths / (n + _batch_paths);
+            const double cost = _batch_paths * getSecondsPerPath(j);
+            if (removed / cost > best_rate) {
+                best_rate = removed / cost;
+                best = j;
+            }
+        }
+        if (kZ * std::sqrt(total) <= target_half_width) {
+            reached = true;
+            break;
+        }
+        if (secondsSince(start) >= max_seconds) {
+            break;
+        }
+        simulate(_trades[best], _batch_paths);
+        ++_batches;
+    }
+    _elapsed += secondsSince(start);
+    return reached;
+}
+
+/**
+ * @brief Run nb_paths more paths on a trade and charge their time to it.
+ */
+void PortfolioMCScheduler::simulate(Trade& trade, int nb_paths) {
+    const Clock::time_point start = Clock::now();
+    trade.pricer.generate(nb_paths);
+    trade.seconds += secondsSince(start);
+}
+
+/**
+ * @brief The variance of the price estimate of trade j, the square of its standard error.
+ */
+double PortfolioMCScheduler::variance(std::size_t j) {
+    const double std_err = _trades[j].pricer.standardError();
+    return std_err * std_err;
+}
+
+/**
+ * @return The estimated portfolio value, the sum of quantity times price.
+ * @throws std::logic_error if a trade has not been simulated.
+ */
+double PortfolioMCScheduler::price() {
+    double value = 0.0;
+    for (std::size_t j = 0; j < _trades.size(); ++j) {
+        value += _trades[j].quantity * price(j);
+    }
+    return value;
+}
+
+/**
+ * @return The standard error of the portfolio value; the trades are simulated
+ * independently, so their variances add.
+ * @throws std::logic_error if a trade has fewer than two paths.
+ */
+double PortfolioMCScheduler::standardError() {
+    double total = 0.0;
+    for (std::size_t j = 0; j < _trades.size(); ++j) {
+        total += _trades[j].quantity * _trades[j].quantity * variance(j);
+    }
+    return std::sqrt(total);
+}
+
+/**
+ * @return The 95% confidence interval of the portfolio value.
+ * @throws std::logic_error if a trade has fewer than two paths.
+ */
+std::vector<double> PortfolioMCScheduler::confidenceInterval() {
+    const double value = price();
+    const double half_width = kZ * standardError();
+    return {value - half_width, value + half_width};
+}
+
+/**
+ * @param j The index of the trade.
+ * @return The estimated price of one unit of trade j.
+ * @throws std::out_of_range if j is not a trade index.
+ * @throws std::logic_error if the trade has not been simulated.
+ */
+double PortfolioMCScheduler::price(std::size_t j) {
+    checkIndex(j);
+    return _trades[j].pricer.price();
+}
+
+/**
+ * @param j The index of the trade.
+ * @return The number of paths simulated for trade j.
+ * @throws std::out_of_range if j is not a trade index.
+ */
+int PortfolioMCScheduler::getNbPaths(std::size_t j) const {
+    checkIndex(j);
+    return _trades[j].pricer.getNbPaths();
+}
+
+/**
+ * @param j The index of the trade.
+ * @return The measured wall-clock cost of one path of trade j, in seconds.
+ * @throws std::out_of_range if j is not a trade index.
+ */
+double PortfolioMCScheduler::getSecondsPerPath(std::size_t j) const {
+    checkIndex(j);
+    const Trade& trade = _trades[j];
+    const int paths = trade.pricer.getNbPaths();
+    if (paths == 0) {
+        return kMinSecondsPerPath;
+    }
+    return std::max(kMinSecondsPerPath, trade.seconds / paths);
+}
+
+/**
+ * @return The number of batches allocated after the pilots, over all runs.
+ */
+int PortfolioMCScheduler::getBatches() const {
+    return _batches;
+}
+
+/**
+ * @return The wall-clock time spent in run(), over all runs, in seconds.
+ */
+double PortfolioMCScheduler::getElapsed() const {
+    return _elapsed;
+}
+
+void PortfolioMCScheduler::checkIndex(std::size_t j) const {
+    if (j >= _trades.size()) {
+        throw std::out_of_range("PortfolioMCScheduler: trade index out of range");
+    }
+}
@@ -0,0 +1,67 @@
+#include "TurnbullWakemanPricer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "Black76Pricer.h"
+
+TurnbullWakemanPricer::TurnbullWakemanPricer(AsianCallOption* option, double asset_price, double interest_rate, double volatility) : _option(option), _strike(option ? option->getStrike() : 0), _asset_price(asset_price), _interest_rate(interest_rate), _volatility(volatility) {
+    if (_asset_price <= 0.0 || _volatility <= 0.0 || _option == nullptr || _strike <= 0.0) {
+        throw std::invalid_argument("TurnbullWakemanPricer: invalid parameters");
+    }
+}
+
+TurnbullWakemanPricer::TurnbullWakemanPricer(AsianPutOption* option, double asset_price, double interest_rate, double volatility) : _option(option), _strike(option ? option->getStrike() : 0), _asset_price(asset_price), _interest_rate(interest_rate), _volatility(volatility) {
+    if (_asset_price <= 0.0 || _volatility <= 0.0 || _option == nullptr || _strike <= 0.0) {
+        throw std::invalid_argument("TurnbullWakemanPricer: invalid parameters");
+    }
+}
+
+/**
+ * @brief Approximate the price of a discretely averaged Asian option.
+ * @details The average of the m remaining fixings is replaced by a lognormal variable
+ * with the same first two moments (Turnbull-Wakeman, in Levy's discrete form), and the
+ * option is priced by Black-76 on it. The asset price is the spot on the valuation date,
+ * and the past fixings of a seasoned option are a constant: with n fixings in all and a
+ * past sum P, the payoff is m / n times that of an option on the remaining average struck
+ * at K* = (n K - P) / m. When K* <= 0 the call is a forward on the average and the put is
+ * worthless. The moments are computed in O(m), so the cost falls as fixings roll off; with
+ * one fixing left the price is exactly Black-Scholes.
+ * @return The approximate price of the option.
+ */
+double TurnbullWakemanPricer::price() const {
+    const std::vector<double> steps = _option->getTimeSteps();
+    const std::size_t m = steps.size();
+    const double n = static_cast<double>(_option->getNbPastFixings() + m);
+    const double scale = m / n;
+    const double strike = (n * _strike - _option->getPastFixingSum()) / m;
+    const double T = steps.back();
+    const double discount = std::exp(-_interest_rate * T);
+    const double var = _volatility * _volatility;
+
+    // E[A] and E[A^2] for A the mean of S(t_i) / S0: sum_i sum_j exp(r (t_i + t_j) + var min(t_i, t_j))
+    double first = 0.0;
+    double second = 0.0;
+    double later = 0.0; // sum over j > i of exp(r t_j)
+    for (std::size_t i = m; i-- > 0;) {
+        const double growth = std::exp(_interest_rate * steps[i]);
+        first += growth;
+        second += std::exp((_interest_rate + var) * steps[i]) * (growth + 2.0 * later);
+        later += growth;
+    }
+    const double forward = _asset_price * first / m;
+    const double type_sign = _option->getOptionType() == OptionType::Call ? 1.0 : -1.0;
+    if (strike <= 0.0) {
+        return type_sign > 0.0 ? scale * discount * (forward - strike) : 0.0;
+    }
+    // lognormal with the same moments: exp(std_dev^2) = E[A^2] / E[A]^2
+    const double std_dev = std::sqrt(std::max(std::log(second / (first * first)), 0.0));
+    return scale * Black76Pricer::price(_option->getOptionType(), false, forward, strike, discount, std_dev);
+}
+
+/**
+ * @brief Approximate the price of the option; same as price().
+ */
+double TurnbullWakemanPricer::operator()() const {
+    return price();
+}
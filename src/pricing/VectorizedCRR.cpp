@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <typeinfo>
+#include "AmericanCallOption.h"
+#include "AmericanPutOption.h"
+#include "CRRPricer.h"
+#include "CallOption.h"
+#include "PutOption.h"
+#include "VectorizedCRR.h"
+
+namespace {
+
+// nodes per tile: a tile and its skew stay in L1
+constexpr int kTileNodes = 1024;
+// levels advanced per pass over the row
+constexpr int kBlockLevels = 64;
+
+// option values smaller than this in magnitude are flushed to zero once per block: far
+// out-of-the-money nodes would otherwise decay into subnormals, which cost ten times a
+// normal operation, and a value above it cannot reach the subnormal range within
+// kBlockLevels levels. Payoffs may be negative, so only the magnitude is compared.
+constexpr double kFlushBelow = 1e-250;
+
+enum class Exercise { European, VanillaAmerican, GenericAmerican };
+
+// With GCC and Clang on x86-64, the induction is also compiled for AVX2 and FMA and picked
+// at run time when the CPU has them, unless the whole build already targets them. The
+// kernels below are forced inline so that each entry point compiles them for its own
+// target.
+#if defined(__GNUC__) && defined(__x86_64__) && !(defined(__AVX2__) && defined(__FMA__))
+#define VECTORIZEDCRR_DISPATCH
+#endif
+#if defined(__GNUC__)
+#define VECTORIZEDCRR_KERNEL inline __attribute__((always_inline))
+#else
+#define VECTORIZEDCRR_KERNEL inline
+#endif
+
+#ifdef __FMA__
+constexpr bool kBuildHasFma = true;
+#else
+constexpr bool kBuildHasFma = false;
+#endif
+
+// a fused multiply-add is only worth it when it is a single instruction
+template <bool Fused>
+VECTORIZEDCRR_KERNEL double mulAdd(double a, double b, double c) {
+    if constexpr (Fused) {
+        return std::fma(a, b, c);
+    } else {
+        return a * b + c;
+    }
+}
+
+inline double flush(double v) {
+    return std::fabs(v) < kFlushBelow ? 0.0 : v;
+}
+
+struct Step {
+    double pu;
+    double pd;
+    double w;       // +1 for a call, -1 for a put
+    double strike;
+    const double* ratios;
+    const double* spots;
+    const Option* option;
+    double* intrinsic;
+};
+
+// level n from level n + 1 over nodes [a, b), in place and ascending in i
+template <Exercise E, bool Fused>
+VECTORIZEDCRR_KERNEL void stepRange(double* v, int a, int b, int n, const Step& step) {
+    const double pu = step.pu;
+    const double pd = step.pd;
+    if constexpr (E == Exercise::European) {
+        for (int i = a; i < b; ++i) {
+            v[i] = mulAdd<Fused>(pu, v[i + 1], pd * v[i]);
+        }
+    } else if constexpr (E == Exercise::VanillaAmerican) {
+        const double ws = step.w * step.spots[n];
+        const double wk = step.w * step.strike;
+        const double* ratios = step.ratios;
+        for (int i = a; i < b; ++i) {
+            const double cont = mulAdd<Fused>(pu, v[i + 1], pd * v[i]);
+            const double intrinsic = std::max(mulAdd<Fused>(ws, ratios[i], -wk), 0.0);
+            v[i] = std::max(cont, intrinsic);
+        }
+    } else {
+        const double s = step.spots[n];
+        double* intrinsic = step.intrinsic;
+        for (int i = a; i < b; ++i) {
+            intrinsic[i - a] = step.option->payoff(s * step.ratios[i]);
+        }
+        for (int i = a; i < b; ++i) {
+            const double cont = mulAdd<Fused>(pu, v[i + 1], pd * v[i]);
+            v[i] = std::max(cont, intrinsic[i - a]);
+        }
+    }
+}
+
+/*
+ * Backward induction from level depth to level 0 with temporal blocking: up to
+ * kBlockLevels levels are advanced tile by tile before moving to the next tile. At step k
+ * of a block, the tile based at [lo, hi) updates nodes [lo - k, hi - k): those read only
+ * nodes the tile (or the previous one) has brought to step k - 1, and leave at step k - 1
+ * the node the next tile still needs.
+ */
+template <Exercise E, bool Fused>
+VECTORIZEDCRR_KERNEL void induct(double* v, int depth, const Step& step) {
+    for (int top = depth; top > 0; top -= kBlockLevels) {
+        const int steps = std::min(kBlockLevels, top);
+        for (int lo = 0; lo <= top; lo += kTileNodes) {
+            const int hi = std::min(lo + kTileNodes, top + 1);
+            for (int k = 1; k <= steps; ++k) {
+                const int n = top - k;
+                const int a = std::max(0, lo - k);
+                const int b = std::min(hi - k, n + 1);
+                if (a < b) {
+                    stepRange<E, Fused>(v, a, b, n, step);
+                }
+            }
+        }
+        for (int i = 0; i <= top - steps; ++i) {
+            v[i] = flush(v[i]);
+        }
+    }
+}
+
+// up-move counts of level n kept by a truncated induction
+struct Window {
+    int lo;
+    int hi;
+};
+
+Window window(int n, double q, double truncation) {
+    const double mean = n * q;
+    const double half = truncation * std::sqrt(n * q * (1.0 - q));
+    return {std::max(0, static_cast<int>(std::floor(mean - half))), std::min(n, static_cast<int>(std::ceil(mean + half)))};
+}
+
+/*
+ * Value of node (n, j) outside the window: the option is then almost surely in or out of
+ * the money at expiry, so it is worth its payoff on the forward, discounted over the
+ * remaining steps (zero out of the money), and at least its intrinsic value if American.
+ */
+double boundaryValue(const Option& option, bool american, int n, int j, int depth, double R, const Step& step) {
+    const double spot = step.spots[n] * step.ratios[j];
+    const double growth = std::pow(R, depth - n);
+    const double value = option.payoff(spot * growth) / growth;
+    return american ? std::max(value, option.payoff(spot)) : value;
+}
+
+/*
+ * Backward induction restricted at each level n to the up-move counts within truncation
+ * standard deviations of n q. Children of the window that fall outside the window of the
+ * level below are given their boundary value before the level is computed.
+ */
+template <Exercise E, bool Fused>
+VECTORIZEDCRR_KERNEL void inductTruncated(double* v, int depth, double q, double R, double truncation, const Step& step) {
+    const bool american = E != Exercise::European;
+    Window below = window(depth, q, truncation);
+    for (int n = depth - 1; n >= 0; --n) {
+        const Window w = window(n, q, truncation);
+        for (int j = w.lo; j < below.lo; ++j) {
+            v[j] = boundaryValue(*step.option, american, n + 1, j, depth, R, step);
+        }
+        for (int j = below.hi + 1; j <= w.hi + 1; ++j) {
+            v[j] = boundaryValue(*step.option, american, n + 1, j, depth, R, step);
+        }
+        for (int a = w.lo; a <= w.hi; a += kTileNodes) {
+            stepRange<E, Fused>(v, a, std::min(a + kTileNodes, w.hi + 1), n, step);
+        }
+        below = w;
+    }
+}
+
+template <Exercise E, bool Fused>
+VECTORIZEDCRR_KERNEL void inductAny(double* v, int depth, double q, double R, double truncation, const Step& step) {
+    if (truncation > 0.0) {
+        inductTruncated<E, Fused>(v, depth, q, R, truncation, step);
+    } else {
+        induct<E, Fused>(v, depth, step);
+    }
+}
+
+template <Exercise E>
+void backwardBaseline(double* v, int depth, double q, double R, double truncation, const Step& step) {
+    inductAny<E, kBuildHasFma>(v, depth, q, R, truncation, step);
+}
+
+#ifdef VECTORIZEDCRR_DISPATCH
+template <Exercise E>
+__attribute__((target("avx2,fma"))) void backwardAvx2(double* v, int depth, double q, double R, double truncation, const Step& step) {
+    inductAny<E, true>(v, depth, q, R, truncation, step);
+}
+
+bool hasAvx2Fma() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+#endif
+
+template <Exercise E>
+void backward(double* v, int depth, double q, double R, double truncation, const Step& step) {
+#ifdef VECTORIZEDCRR_DISPATCH
+    if (hasAvx2Fma()) {
+        backwardAvx2<E>(v, depth, q, R, truncation, step);
+        return;
+    }
+#endif
+    backwardBaseline<E>(v, depth, q, R, truncation, step);
+}
+
+}
+
+/**
+ * @brief Construct a vectorized CRR pricer.
+ * @details Buffers grow to the largest depth priced and are then reused, so pricing at a
+ * depth already seen does not allocate.
+ * @param truncation The width of the truncated lattice in standard deviations, 0 for the
+ * full lattice. See setTruncation().
+ * @throws std::invalid_argument if truncation is negative.
+ */
+VectorizedCRR::VectorizedCRR(double truncation) : _truncation(0.0) {
+    setTruncation(truncation);
+}
+
+/**
+ * @brief Restrict the lattice to a band around the mean of the up-move count.
+ * @details With truncation k > 0, level n only computes the nodes whose number of up moves
+ * is within k standard deviations sqrt(n q (1 - q)) of its risk-neutral mean n q; nodes
+ * just outside take their asymptotic value (discounted payoff on the forward, floored by
+ * the intrinsic value for American options). The work drops from O(N^2) to O(k N^1.5)
+ * and the price moves by an amount of the order of the normal tail beyond k: about 1e-8
+ * for k = 6, below rounding for k = 8. 0 prices on the full lattice.
+ * @param truncation The width of the band in standard deviations.
+ * @throws std::invalid_argument if truncation is negative.
+ */
+void VectorizedCRR::setTruncation(double truncation) {
+    if (!(truncation >= 0.0)) {
+        throw std::invalid_argument("VectorizedCRR: truncation must be >= 0");
+    }
+    _truncation = truncation;
+}
+
+/**
+ * @return The width of the truncated lattice in standard deviations, 0 for the full lattice.
+ */
+double VectorizedCRR::getTruncation() const {
+    return _truncation;
+}
+
+/**
+ * @brief Price an option on a deep CRR tree with gross factors U, D, R.
+ * @details Same tree and exercise rule as CRRPricer, but the induction runs on a single
+ * contiguous level buffer, overwritten in place, and node spots are S0 * D^n times a
+ * precomputed row of (U/D)^i, so the inner loops are straight-line code the compiler turns
+ * into SIMD: a fused multiply-add for the continuation value and a branch-free max against
+ * the intrinsic value. Vanilla calls and puts compute the intrinsic value inline; other
+ * American payoffs fill an intrinsic row per tile through payoff() before the vector max.
+ * Levels are processed in blocks of kBlockLevels over tiles of kTileNodes nodes, so a deep
+ * tree streams through the cache once per block rather than once per level. Values below
+ * 1e-250 in magnitude are flushed to zero between blocks, which changes the price by less
+ * than that. On x86-64 with GCC or Clang, the induction also has an AVX2/FMA build used
+ * when the CPU supports it, so the default build gets 4-wide fused multiply-adds; its
+ * prices differ from the SSE2 build only by the rounding of the fused operations.
+ * @param option The option to be priced.
+ * @param depth The depth of the tree.
+ * @param S0 The initial price of the underlying asset.
+ * @param U The gross up factor.
+ * @param D The gross down factor.
+ * @param R The gross one-step capitalisation factor.
+ * @return The price of the option.
+ * @throws std::invalid_argument if the option is null or Asian, depth is negative or
+ * 0 < D < R < U does not hold.
+ */
+double VectorizedCRR::price(const Option* option, int depth, double S0, double U, double D, double R) {
+    if (!option) {
+        throw std::invalid_argument("VectorizedCRR: option is null");
+    }
+    if (option->isAsianOption()) {
+        throw std::invalid_argument("VectorizedCRR: Asian option not supported");
+    }
+    if (depth < 0) {
+        throw std::invalid_argument("VectorizedCRR: depth must be >= 0");
+    }
+    if (!(D > 0.0 && D < R && R < U)) {
+        throw std::invalid_argument("VectorizedCRR: need 0 < D < R < U");
+    }
+
+    const std::size_t size = static_cast<std::size_t>(depth) + 1;
+    if (_values.size() < size) {
+        _values.resize(size);
+        _ratios.resize(size);
+        _spots.resize(size);
+        _intrinsic.resize(std::min<std::size_t>(size, kTileNodes));
+    }
+    double* values = _values.data();
+    double* ratios = _ratios.data();
+    double* spots = _spots.data();
+    const double ratio = U / D;
+    ratios[0] = 1.0;
+    spots[0] = S0;
+    for (int i = 1; i <= depth; ++i) {
+        ratios[i] = ratios[i - 1] * ratio;
+        spots[i] = spots[i - 1] * D;
+    }
+    const double q = (R - D) / (U - D);
+    const Window terminal = _truncation > 0.0 ? window(depth, q, _truncation) : Window{0, depth};
+    for (int i = terminal.lo; i <= terminal.hi; ++i) {
+        values[i] = flush(option->payoff(spots[depth] * ratios[i]));
+    }
+
+    Step step{q / R, (1.0 - q) / R, 1.0, 0.0, ratios, spots, option, _intrinsic.data()};
+    Exercise exercise = Exercise::European;
+    if (option->isAmericanOption()) {
+        const std::type_info& type = typeid(*option);
+        if (type == typeid(AmericanCallOption) || type == typeid(AmericanPutOption)) {
+            const AmericanOption* american = static_cast<const AmericanOption*>(option);
+            step.w = american->getOptionType() == OptionType::Call ? 1.0 : -1.0;
+            step.strike = american->getStrike();
+            exercise = Exercise::VanillaAmerican;
+        } else {
+            exercise = Exercise::GenericAmerican;
+        }
+    }
+    switch (exercise) {
+        case Exercise::European:
+            backward<Exercise::European>(values, depth, q, R, _truncation, step);
+            break;
+        case Exercise::VanillaAmerican:
+            backward<Exercise::VanillaAmerican>(values, depth, q, R, _truncation, step);
+            break;
+        case Exercise::GenericAmerican:
+            backward<Exercise::GenericAmerican>(values, depth, q, R, _truncation, step);
+            break;
+    }
+    return values[0];
+}
+
+/**
+ * @brief Price an option on the CRR tree of CRRPricer(option, depth, S0, r, volatility).
+ * @param option The option to be priced.
+ * @param depth The depth of the tree, at least 1.
+ * @param S0 The initial price of the underlying asset.
+ * @param r The interest rate of the risk-free asset.
+ * @param volatility The volatility of the underlying asset.
+ * @return The price of the option.
+ * @throws std::invalid_argument as the other overload, or if the time step is not positive.
+ */
+double VectorizedCRR::price(const Option* option, int depth, double S0, double r, double volatility) {
+    if (!option) {
+        throw std::invalid_argument("VectorizedCRR: option is null");
+    }
+    double U = 0.0;
+    double D = 0.0;
+    double R = 0.0;
+    CRRPricer::treeFactors(option->getExpiry(), depth, r, volatility, U, D, R);
+    return price(option, depth, S0, U, D, R);
+}
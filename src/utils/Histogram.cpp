@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "Histogram.h"
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x54534948; // "HIST"
+constexpr std::uint32_t kVersion = 1;
+
+}
+
+/**
+ * @brief Construct an empty histogram of equal bins.
+ * @param lower The lower edge of the first bin.
+ * @param upper The upper edge of the last bin.
+ * @param bins The number of bins, at least 1.
+ * @throws std::invalid_argument if lower >= upper, either is not finite, or bins < 1.
+ */
+Histogram::Histogram(double lower, double upper, int bins) : _lower(lower), _upper(upper), _inverse_width(0.0) {
+    if (!(lower < upper) || !std::isfinite(lower) || !std::isfinite(upper) || bins < 1) {
+        throw std::invalid_argument("Histogram: need finite lower < upper and at least one bin");
+    }
+    _inverse_width = bins / (upper - lower);
+    _counts.assign(static_cast<std::size_t>(bins), 0);
+}
+
+/**
+ * @brief Count a value; below lower is an underflow, from upper on (or NaN) an overflow.
+ */
+void Histogram::add(double value) {
+    if (value < _lower) {
+        ++_underflow;
+        return;
+    }
+    if (!(value < _upper)) {
+        ++_overflow;
+        return;
+    }
+    std::size_t bin = static_cast<std::size_t>((value - _lower) * _inverse_width);
+    if (bin >= _counts.size()) { // rounding just below upper
+        bin = _counts.size() - 1;
+    }
+    ++_counts[bin];
+}
+
+/**
+ * @brief Count n values.
+ */
+void Histogram::add(const double* values, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        add(values[i]);
+    }
+}
+
+/**
+ * @brief Add the counts of a histogram with the same bins.
+ * @throws std::invalid_argument if the bins differ.
+ */
+void Histogram::merge(const Histogram& other) {
+    if (other._lower != _lower || other._upper != _upper || other._counts.size() != _counts.size()) {
+        throw std::invalid_argument("Histogram: cannot merge histograms with different bins");
+    }
+    for (std::size_t i = 0; i < _counts.size(); ++i) {
+        _counts[i] += other._counts[i];
+    }
+    _underflow += other._underflow;
+    _overflow += other._overflow;
+}
+
+/**
+ * @brief Reset every count to zero.
+ */
+void Histogram::clear() {
+    std::fill(_counts.begin(), _counts.end(), 0);
+    _underflow = 0;
+    _overflow = 0;
+}
+
+/**
+ * @return The number of bins.
+ */
+int Histogram::getBins() const {
+    return static_cast<int>(_counts.size());
+}
+
+/**
+ * @return The lower edge of the first bin.
+ */
+double Histogram::getLower() const {
+    return _lower;
+}
+
+/**
+ * @return The upper edge of the last bin.
+ */
+double Histogram::getUpper() const {
+    return _upper;
+}
+
+/**
+ * @param i The index of the edge, in [0, getBins()].
+ * @return The lower edge of bin i (the upper edge of the last bin for i == getBins()).
+ * @throws std::out_of_range if i is out of range.
+ */
+double Histogram::getEdge(int i) const {
+    if (i < 0 || i > getBins()) {
+        throw std::out_of_range("Histogram: edge index out of range");
+    }
+    return i == getBins() ? _upper : _lower + i / _inverse_width;
+}
+
+/**
+ * @param i The index of the bin, in [0, getBins()).
+ * @return The number of values counted in bin i.
+ * @throws std::out_of_range if i is out of range.
+ */
+std::uint64_t Histogram::getCount(int i) const {
+    if (i < 0 || i >= getBins()) {
+        throw std::out_of_range("Histogram: bin index out of range");
+    }
+    return _counts[static_cast<std::size_t>(i)];
+}
+
+/**
+ * @return The number of values below the lower edge.
+ */
+std::uint64_t Histogram::getUnderflow() const {
+    return _underflow;
+}
+
+/**
+ * @return The number of values from the upper edge on, NaNs included.
+ */
+std::uint64_t Histogram::getOverflow() const {
+    return _overflow;
+}
+
+/**
+ * @return The number of values counted, underflows and overflows included.
+ */
+std::uint64_t Histogram::getTotal() const {
+    std::uint64_t total = _underflow + _overflow;
+    for (std::uint64_t count : _counts) {
+        total += count;
+    }
+    return total;
+}
+
+/**
+ * @brief Write the histogram in a native binary format, for checkpoints.
+ * @throws std::runtime_error if the stream fails.
+ */
+void Histogram::save(std::ostream& os) const {
+    const std::uint32_t header[2] = {kMagic, kVersion};
+    const std::uint64_t counts[3] = {_counts.size(), _underflow, _overflow};
+    const double edges[2] = {_lower, _upper};
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+    os.write(reinterpret_cast<const char*>(edges), sizeof(edges));
+    os.write(reinterpret_cast<const char*>(_counts.data()), static_cast<std::streamsize>(_counts.size() * sizeof(std::uint64_t)));
+    if (!os) {
+        throw std::runtime_error("Histogram: write failed");
+    }
+}
+
+/**
+ * @brief Read a histogram written by save().
+ * @throws std::invalid_argument if the stream does not hold a histogram, or is truncated.
+ */
+Histogram Histogram::load(std::istream& is) {
+    std::uint32_t header[2] = {};
+    std::uint64_t counts[3] = {};
+    double edges[2] = {};
+    if (!is.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != kMagic || header[1] != kVersion) {
+        throw std::invalid_argument("Histogram: not a histogram");
+    }
+    if (!is.read(reinterpret_cast<char*>(counts), sizeof(counts)) || !is.read(reinterpret_cast<char*>(edges), sizeof(edges)) ||
+        counts[0] == 0 || counts[0] > static_cast<std::uint64_t>(INT32_MAX)) {
+        throw std::invalid_argument("Histogram: truncated histogram");
+    }
+    Histogram histogram(edges[0], edges[1], static_cast<int>(counts[0]));
+    if (!is.read(reinterpret_cast<char*>(histogram._counts.data()), static_cast<std::streamsize>(counts[0] * sizeof(std::uint64_t)))) {
+        throw std::invalid_argument("Histogram: truncated histogram");
+    }
+    histogram._underflow = counts[1];
+    histogram._overflow = counts[2];
+    return histogram;
+}
@@ -1,18 +1,125 @@
 #include "MT.h"
+#include "PCG64.h"
+#include "Xoshiro256pp.h"
+#include "Ziggurat.h"
+
+namespace {
+
+// single draws from the streams engine are served from a buffer filled in bulk
+constexpr std::size_t kStreamBuffer = 64;
+
+struct Engines {
+    RNGEngine engine{RNGEngine::MT19937};
+    Xoshiro256pp xoshiro;
+    PCG64 pcg;
+    Xoshiro256ppStreams streams;
+    std::uniform_real_distribution<double> mt_uniform{0.0, 1.0};
+    std::normal_distribution<double> mt_normal{0.0, 1.0};
+    double uniforms[kStreamBuffer];
+    double normals[kStreamBuffer];
+    std::size_t next_uniform{kStreamBuffer};
+    std::size_t next_normal{kStreamBuffer};
+};
+
+// every thread draws from its own engine, so concurrent pricers do not race on it
+Engines& engines() {
+    thread_local Engines state;
+    return state;
+}
+
+}
 
 std::mt19937& MT::generator() {
-    static std::mt19937 gen(std::random_device{}());
+    thread_local std::mt19937 gen(std::random_device{}());
     return gen;
 }
 
+/**
+ * @brief Select the engine behind every MT draw and seed it from std::random_device.
+ * @param engine The engine.
+ */
+void MT::setEngine(RNGEngine engine) {
+    std::random_device device;
+    const std::uint64_t seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+    setEngine(engine, seed);
+}
+
+/**
+ * @brief Select the engine behind every MT draw and seed it.
+ * @details The same engine and seed give the same sequence of draws, fills included.
+ * @param engine The engine.
+ * @param seed The seed.
+ */
+void MT::setEngine(RNGEngine engine, std::uint64_t seed) {
+    Engines& state = engines();
+    state.engine = engine;
+    state.next_uniform = kStreamBuffer;
+    state.next_normal = kStreamBuffer;
+    state.mt_normal.reset();
+    switch (engine) {
+        case RNGEngine::MT19937: {
+            std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+            generator().seed(seq);
+            break;
+        }
+        case RNGEngine::Xoshiro256pp:
+            state.xoshiro.seed(seed);
+            break;
+        case RNGEngine::PCG64:
+            state.pcg.seed(seed);
+            break;
+        case RNGEngine::Xoshiro256ppStreams:
+            state.streams.seed(seed);
+            break;
+    }
+}
+
+/**
+ * @brief Select substream index of a seeded xoshiro256++ as the engine behind every MT draw.
+ * @details Substream i starts i jumps of 2^128 after the generator seeded with seed, so
+ * the substreams of a seed never overlap: independent runs drawing from distinct
+ * substreams (other processes or hosts, say) get disjoint draws, and a substream is the
+ * same wherever it is drawn. Selecting substream i costs i jumps, about a microsecond each.
+ * @param seed The seed of the generator.
+ * @param index The index of the substream.
+ */
+void MT::setSubstream(std::uint64_t seed, std::uint64_t index) {
+    setEngine(RNGEngine::Xoshiro256pp, seed);
+    Xoshiro256pp& xoshiro = engines().xoshiro;
+    for (std::uint64_t i = 0; i < index; ++i) {
+        xoshiro.jump();
+    }
+}
+
+/**
+ * @return The engine behind every MT draw.
+ */
+RNGEngine MT::getEngine() {
+    return engines().engine;
+}
+
 /**
  * @brief Returns a random floating-point number in the range [0.0, 1.0).
  * 
  * @return A random floating-point number.
  */
 double MT::rand_unif() {
-    static std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(generator());
+    Engines& state = engines();
+    switch (state.engine) {
+        case RNGEngine::Xoshiro256pp:
+            return Ziggurat::uniform(state.xoshiro());
+        case RNGEngine::PCG64:
+            return Ziggurat::uniform(state.pcg());
+        case RNGEngine::Xoshiro256ppStreams:
+            if (state.next_uniform == kStreamBuffer) {
+                state.streams.fill_uniform(state.uniforms, kStreamBuffer);
+                state.next_uniform = 0;
+            }
+            return state.uniforms[state.next_uniform++];
+        case RNGEngine::MT19937:
+            break;
+    }
+    return state.mt_uniform(generator());
 }
 
 /**
@@ -21,6 +128,73 @@ double MT::rand_unif() {
  * @return A random floating-point number from a normal distribution.
  */
 double MT::rand_norm() {
-    static std::normal_distribution<double> dist(0.0, 1.0);
-    return dist(generator());
+    Engines& state = engines();
+    switch (state.engine) {
+        case RNGEngine::Xoshiro256pp:
+            return Ziggurat::normal(state.xoshiro);
+        case RNGEngine::PCG64:
+            return Ziggurat::normal(state.pcg);
+        case RNGEngine::Xoshiro256ppStreams:
+            if (state.next_normal == kStreamBuffer) {
+                state.streams.fill_normal(state.normals, kStreamBuffer);
+                state.next_normal = 0;
+            }
+            return state.normals[state.next_normal++];
+        case RNGEngine::MT19937:
+            break;
+    }
+    return state.mt_normal(generator());
+}
+
+/**
+ * @brief Fill a buffer with uniform draws in [0.0, 1.0) from the selected engine.
+ * @details With MT19937 this is n calls to rand_unif(); the other engines fill in bulk.
+ * @param out The buffer.
+ * @param n The number of values.
+ */
+void MT::fill_uniform(double* out, std::size_t n) {
+    Engines& state = engines();
+    switch (state.engine) {
+        case RNGEngine::Xoshiro256pp:
+            state.xoshiro.fill_uniform(out, n);
+            return;
+        case RNGEngine::PCG64:
+            state.pcg.fill_uniform(out, n);
+            return;
+        case RNGEngine::Xoshiro256ppStreams:
+            state.streams.fill_uniform(out, n);
+            return;
+        case RNGEngine::MT19937:
+            break;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = rand_unif();
+    }
+}
+
+/**
+ * @brief Fill a buffer with standard normal draws from the selected engine.
+ * @details With MT19937 this is n calls to rand_norm(); the other engines fill in bulk
+ * with the ziggurat method.
+ * @param out The buffer.
+ * @param n The number of values.
+ */
+void MT::fill_normal(double* out, std::size_t n) {
+    Engines& state = engines();
+    switch (state.engine) {
+        case RNGEngine::Xoshiro256pp:
+            state.xoshiro.fill_normal(out, n);
+            return;
+        case RNGEngine::PCG64:
+            state.pcg.fill_normal(out, n);
+            return;
+        case RNGEngine::Xoshiro256ppStreams:
+            state.streams.fill_normal(out, n);
+            return;
+        case RNGEngine::MT19937:
+            break;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = rand_norm();
+    }
 }
@@ -0,0 +1,45 @@
+#include "PCG64.h"
+#include "Ziggurat.h"
+
+/**
+ * @brief Construct a generator.
+ * @param seed The initial state.
+ * @param stream The stream; only its low 63 bits are used.
+ */
+PCG64::PCG64(std::uint64_t seed, std::uint64_t stream) {
+    this->seed(seed, stream);
+}
+
+/**
+ * @brief Reset the generator, as pcg64_srandom_r() of the reference implementation.
+ * @param seed The initial state.
+ * @param stream The stream; only its low 63 bits are used.
+ */
+void PCG64::seed(std::uint64_t seed, std::uint64_t stream) {
+    reset(stream);
+    (*this)();
+    addToState(seed);
+    (*this)();
+}
+
+/**
+ * @brief Fill a buffer with uniform doubles in [0, 1), 52 random bits each.
+ * @param out The buffer.
+ * @param n The number of values.
+ */
+void PCG64::fill_uniform(double* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = Ziggurat::uniform((*this)());
+    }
+}
+
+/**
+ * @brief Fill a buffer with standard normal draws (ziggurat method).
+ * @param out The buffer.
+ * @param n The number of values.
+ */
+void PCG64::fill_normal(double* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = Ziggurat::normal(*this);
+    }
+}
@@ -0,0 +1,640 @@
+#include "PathStore.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'P', 'P', 'A', 'T', 'H', 'S', 'T'};
+constexpr std::uint32_t kRaw = 0;
+constexpr std::uint32_t kPredicted = 1;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t steps;
+    std::uint64_t chunk_paths;
+    std::uint64_t nb_paths;
+    std::uint64_t nb_chunks;
+    std::uint64_t index_offset;
+    unsigned char reserved[16];
+};
+
+struct IndexEntry {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+    std::uint32_t nb_paths;
+    std::uint32_t encoding;
+    std::uint64_t checksum;
+};
+
+static_assert(sizeof(Header) == 64 && sizeof(IndexEntry) == 32, "PathStore: unexpected header or index entry size");
+
+// FNV-1a over 64-bit words, in four lanes taking every fourth word and then hashed
+// together: one chain of multiplies would cost a multiply latency per word
+std::uint64_t checksum(const std::uint64_t* words, std::size_t n) {
+    constexpr std::uint64_t kPrime = 0x100000001b3ULL;
+    std::uint64_t lanes[4] = {0xcbf29ce484222325ULL, 0xcbf29ce484222325ULL, 0xcbf29ce484222325ULL, 0xcbf29ce484222325ULL};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (std::size_t l = 0; l < 4; ++l) {
+            lanes[l] = (lanes[l] ^ words[i + l]) * kPrime;
+        }
+    }
+    for (; i < n; ++i) {
+        lanes[i & 3] = (lanes[i & 3] ^ words[i]) * kPrime;
+    }
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (std::uint64_t lane : lanes) {
+        hash = (hash ^ lane) * kPrime;
+    }
+    return hash;
+}
+
+std::uint64_t bitsOf(double x) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+double doubleOf(std::uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// residuals: the low n bytes of x, stored least significant first
+std::size_t residualBytes(std::uint64_t x) {
+    return x ? 8 - (static_cast<std::size_t>(__builtin_clzll(x)) >> 3) : 0;
+}
+
+// writes 8 bytes, of which the next residual overwrites those beyond the kept ones
+void putResidual(unsigned char* out, std::uint64_t x) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    x = __builtin_bswap64(x);
+#endif
+    std::memcpy(out, &x, sizeof(x));
+}
+
+std::uint64_t getResidual(const unsigned char* in, std::size_t n) {
+    std::uint64_t x = 0;
+    std::memcpy(&x, in, n);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    x = __builtin_bswap64(x);
+#endif
+    return x;
+}
+
+// path codes: the number of residual bytes kept for every spot of the path, and whether
+// the path is predicted as the antithetic of the previous one
+constexpr unsigned kWidthMask = 0xF;
+constexpr unsigned kAntithetic = 0x10;
+// an antithetic prediction leaving at most this many bytes per spot is taken as is
+constexpr std::size_t kCloseWidth = 2;
+
+// the XORs of path p with its prediction: the previous spot of the path (the first spot
+// of the previous path for k = 0), or, for the antithetic path of a pair, the product of
+// the pair at the date divided by the spot of its partner. Returns their bitwise OR.
+std::uint64_t predictionXor(const double* spots, std::size_t steps, std::size_t p, bool antithetic, const double* pair_products,
+                            std::uint64_t* xors) {
+    const double* path = spots + p * steps;
+    std::uint64_t any = 0;
+    if (antithetic) {
+        const double* partner = path - steps;
+        for (std::size_t k = 0; k < steps; ++k) {
+            xors[k] = bitsOf(path[k]) ^ bitsOf(pair_products[k] / partner[k]);
+            any |= xors[k];
+        }
+        return any;
+    }
+    xors[0] = bitsOf(path[0]) ^ (p > 0 ? bitsOf(path[-static_cast<std::ptrdiff_t>(steps)]) : 0);
+    any = xors[0];
+    for (std::size_t k = 1; k < steps; ++k) {
+        xors[k] = bitsOf(path[k]) ^ bitsOf(path[k - 1]);
+        any |= xors[k];
+    }
+    return any;
+}
+
+std::size_t align8(std::size_t n) {
+    return (n + 7) & ~std::size_t(7);
+}
+
+}
+
+/**
+ * @brief Create a path store file and write its header.
+ * @param path The file to write, replaced if it exists.
+ * @param time_steps The dates of the spots of every path, as in Option::getTimeSteps().
+ * @param chunk_paths The number of paths per chunk, the unit of compression and of
+ * random access.
+ * @throws std::invalid_argument if the time steps are empty or not increasing, or
+ * chunk_paths is 0.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+PathStoreWriter::PathStoreWriter(const std::string& path, const std::vector<double>& time_steps, std::size_t chunk_paths)
+    : _path(path), _time_steps(time_steps), _chunk_paths(chunk_paths) {
+    if (time_steps.empty() || chunk_paths == 0) {
+        throw std::invalid_argument("PathStoreWriter: need at least one time step and one path per chunk");
+    }
+    for (std::size_t k = 1; k < time_steps.size(); ++k) {
+        if (!(time_steps[k] > time_steps[k - 1])) {
+            throw std::invalid_argument("PathStoreWriter: time steps must be increasing");
+        }
+    }
+    _chunk.resize(chunk_paths * time_steps.size());
+    _pending.resize(_chunk.size());
+    _work.resize(_chunk.size());
+    _out.open(path, std::ios::binary | std::ios::trunc);
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.steps = static_cast<std::uint32_t>(time_steps.size());
+    header.chunk_paths = chunk_paths;
+    _out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _out.write(reinterpret_cast<const char*>(time_steps.data()), static_cast<std::streamsize>(time_steps.size() * sizeof(double)));
+    if (!_out) {
+        throw std::runtime_error("PathStoreWriter: cannot write " + path);
+    }
+    _offset = sizeof(Header) + time_steps.size() * sizeof(double);
+    _worker = std::thread(&PathStoreWriter::run, this);
+}
+
+/**
+ * @brief Finish the file if finish() was not called; errors are lost, call finish() to see them.
+ */
+PathStoreWriter::~PathStoreWriter() {
+    if (!_finished) {
+        try {
+            finish();
+        } catch (const std::exception&) {
+        }
+    }
+}
+
+/**
+ * @brief Append paths.
+ * @details Paths are buffered until a chunk is full, which is then handed to the
+ * writing thread; this waits only if the previous chunk is not yet taken.
+ * @param paths The spots of the paths, getTimeSteps().size() per path, path after path.
+ * @param nb_paths The number of paths.
+ * @throws std::logic_error if finish() was called.
+ * @throws std::runtime_error if the file cannot be written, possibly reported by a later
+ * call than the one whose paths failed.
+ */
+void PathStoreWriter::add(const double* paths, std::size_t nb_paths) {
+    if (_finished) {
+        throw std::logic_error("PathStoreWriter: add() after finish()");
+    }
+    const std::size_t steps = _time_steps.size();
+    while (nb_paths > 0) {
+        const std::size_t n = std::min(nb_paths, _chunk_paths - _chunk_size);
+        std::memcpy(&_chunk[_chunk_size * steps], paths, n * steps * sizeof(double));
+        _chunk_size += n;
+        paths += n * steps;
+        nb_paths -= n;
+        _nb_paths += n;
+        if (_chunk_size == _chunk_paths) {
+            handOff(false);
+        }
+    }
+}
+
+/**
+ * @brief Give the buffered chunk to the writing thread once it has taken the previous one.
+ * @param last Whether no chunk follows, which lets the thread stop once it is written.
+ * @throws std::runtime_error if writing an earlier chunk failed and last is false.
+ */
+void PathStoreWriter::handOff(bool last) {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this] { return _pending_size == 0; });
+        if (_error && !last) {
+            std::rethrow_exception(_error);
+        }
+        if (_chunk_size > 0) {
+            _pending.swap(_chunk);
+            _pending_size = _chunk_size;
+            _chunk_size = 0;
+        }
+        _stop = last;
+    }
+    _cv.notify_all();
+}
+
+/**
+ * @brief Body of the writing thread: take the chunks handed off and write them, until
+ * finish(). The first error is kept for the caller; later chunks are then dropped.
+ */
+void PathStoreWriter::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _cv.wait(lock, [this] { return _pending_size > 0 || _stop; });
+        if (_pending_size == 0) {
+            return;
+        }
+        const std::size_t nb_paths = _pending_size;
+        const bool failed = static_cast<bool>(_error);
+        _work.swap(_pending);
+        _pending_size = 0;
+        lock.unlock();
+        _cv.notify_all();
+
+        std::uint64_t bytes = 0;
+        std::exception_ptr error;
+        if (!failed) {
+            try {
+                bytes = writeChunk(_work.data(), nb_paths);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        lock.lock();
+        _offset += bytes;
+        if (error) {
+            _error = error;
+        }
+    }
+}
+
+/**
+ * @brief Encode and write a chunk; called by the writing thread.
+ * @details Every spot is XORed with a prediction and the XOR stored without its leading
+ * zero bytes, as in FPC (Burtscher and Ratanaworabhan, 2009), except that the number of
+ * bytes kept is the same for all the spots of a path: a code byte per path gives it,
+ * with the prediction the path uses, so the spots of a path are packed at a fixed stride
+ * with no per-spot branch or code. The prediction is the previous spot of the path,
+ * which shares little more than the sign and exponent with a lognormal step, or, for the
+ * antithetic path of a pair, the product of a pair at that date divided by the spot of
+ * its partner: that product only depends on the date, to within a few units in the last
+ * place, so it is taken once per chunk, from its first pair, and the prediction costs a
+ * division. A path that does not follow an antithetic path is tried as antithetic first.
+ * The chunk holds the pair products, then the path codes, then the residual bytes, and
+ * is decodable on its own.
+ * @param spots The paths of the chunk.
+ * @param nb_paths The number of paths.
+ * @return The number of bytes written.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+std::uint64_t PathStoreWriter::writeChunk(const double* spots, std::size_t nb_paths) {
+    const std::size_t steps = _time_steps.size();
+    const std::size_t values = nb_paths * steps;
+    const std::size_t code_bytes = align8(nb_paths);
+    const std::size_t header_bytes = steps * sizeof(double) + code_bytes;
+    // at most 8 residual bytes per spot, and the 8 bytes the last putResidual() may write beyond them
+    _encoded.resize(header_bytes / sizeof(std::uint64_t) + values + 1);
+    unsigned char* codes = reinterpret_cast<unsigned char*>(_encoded.data()) + steps * sizeof(double);
+    unsigned char* out = codes + code_bytes;
+    std::memset(codes, 0, code_bytes);
+
+    // the first pair of the chunk is paths 0 and 1, or 1 and 2 when the chunk starts with
+    // the antithetic path of a pair begun in the previous chunk: the base that predicts
+    // the next antithetic path better wins
+    _products.assign(steps, 0.0);
+    if (nb_paths >= 2) {
+        std::size_t base = 0;
+        if (nb_paths >= 5) {
+            const auto miss = [&](std::size_t b) {
+                return residualBytes(bitsOf(spots[(b + 3) * steps]) ^ bitsOf(spots[b * steps] * spots[(b + 1) * steps] / spots[(b + 2) * steps]));
+            };
+            base = miss(1) < miss(0) ? 1 : 0;
+        }
+        for (std::size_t k = 0; k < steps; ++k) {
+            _products[k] = spots[base * steps + k] * spots[(base + 1) * steps + k];
+        }
+    }
+    std::memcpy(_encoded.data(), _products.data(), steps * sizeof(double));
+
+    // a path after an antithetic one starts a new pair and is not tried as antithetic, and
+    // the previous-spot prediction is only tried when the antithetic one misses
+    _xor.resize(2 * steps);
+    std::uint64_t* antithetic_xor = _xor.data();
+    std::uint64_t* previous_xor = antithetic_xor + steps;
+    bool after_antithetic = true;
+    for (std::size_t p = 0; p < nb_paths; ++p) {
+        std::size_t n = 9;
+        bool antithetic = false;
+        if (!after_antithetic) {
+            n = residualBytes(predictionXor(spots, steps, p, true, _products.data(), antithetic_xor));
+            antithetic = true;
+        }
+        if (n > kCloseWidth) {
+            const std::size_t n_previous = residualBytes(predictionXor(spots, steps, p, false, _products.data(), previous_xor));
+            if (n_previous <= n) {
+                n = n_previous;
+                antithetic = false;
+            }
+        }
+        after_antithetic = antithetic;
+        const std::uint64_t* xors = antithetic ? antithetic_xor : previous_xor;
+        codes[p] = static_cast<unsigned char>(n | (antithetic ? kAntithetic : 0));
+        for (std::size_t k = 0; k < steps; ++k) {
+            putResidual(out + k * n, xors[k]);
+        }
+        out += steps * n;
+    }
+    const std::size_t residual_bytes = static_cast<std::size_t>(out - (codes + code_bytes));
+    std::memset(out, 0, align8(residual_bytes) - residual_bytes);
+
+    IndexEntry entry{};
+    const std::uint64_t* words = _encoded.data();
+    std::size_t nb_words = (header_bytes + align8(residual_bytes)) / sizeof(std::uint64_t);
+    entry.encoding = kPredicted;
+    if (nb_words >= values) {
+        words = reinterpret_cast<const std::uint64_t*>(spots);
+        nb_words = values;
+        entry.encoding = kRaw;
+    }
+    entry.offset = _offset;
+    entry.bytes = nb_words * sizeof(std::uint64_t);
+    entry.nb_paths = static_cast<std::uint32_t>(nb_paths);
+    entry.checksum = checksum(words, nb_words);
+    _out.write(reinterpret_cast<const char*>(words), static_cast<std::streamsize>(entry.bytes));
+    if (!_out) {
+        throw std::runtime_error("PathStoreWriter: cannot write " + _path);
+    }
+    const unsigned char* raw = reinterpret_cast<const unsigned char*>(&entry);
+    _index.insert(_index.end(), raw, raw + sizeof(entry));
+    return entry.bytes;
+}
+
+/**
+ * @brief Write the last chunk, the index and the final header, and close the file.
+ * @details Waits for the writing thread to write every chunk. Calling it again does nothing.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void PathStoreWriter::finish() {
+    if (_finished) {
+        return;
+    }
+    _finished = true;
+    handOff(true);
+    _worker.join();
+    if (_error) {
+        std::rethrow_exception(_error);
+    }
+    const std::uint64_t index_offset = _offset;
+    _out.write(reinterpret_cast<const char*>(_index.data()), static_cast<std::streamsize>(_index.size()));
+    _offset += _index.size();
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.steps = static_cast<std::uint32_t>(_time_steps.size());
+    header.chunk_paths = _chunk_paths;
+    header.nb_paths = _nb_paths;
+    header.nb_chunks = _index.size() / sizeof(IndexEntry);
+    header.index_offset = index_offset;
+    _out.seekp(0);
+    _out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _out.close();
+    if (!_out) {
+        throw std::runtime_error("PathStoreWriter: cannot write " + _path);
+    }
+}
+
+/**
+ * @return The dates of the spots of every path.
+ */
+const std::vector<double>& PathStoreWriter::getTimeSteps() const {
+    return _time_steps;
+}
+
+/**
+ * @return The number of paths added so far.
+ */
+std::uint64_t PathStoreWriter::getNbPaths() const {
+    return _nb_paths;
+}
+
+/**
+ * @return The size of the file so far; the paths not yet written are not counted.
+ */
+std::uint64_t PathStoreWriter::getBytesWritten() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _offset;
+}
+
+/**
+ * @brief Map a path store and check its header and chunk index.
+ * @details The chunks are checked against their checksums as they are decoded.
+ * @param path The file written by a PathStoreWriter.
+ * @throws std::runtime_error if the file cannot be opened or mapped.
+ * @throws std::invalid_argument if the file is not a finished path store of this version.
+ */
+PathStore::PathStore(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("PathStore: cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        throw std::invalid_argument("PathStore: not a path store: " + path);
+    }
+    void* base = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("PathStore: cannot map " + path);
+    }
+    _base = static_cast<const unsigned char*>(base);
+    _size = static_cast<std::size_t>(info.st_size);
+
+    Header header;
+    std::memcpy(&header, _base, sizeof(header));
+    const std::uint64_t data_offset = sizeof(Header) + std::uint64_t(header.steps) * sizeof(double);
+    const char* error = nullptr;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        error = "not a path store";
+    } else if (header.version != PathStoreWriter::kVersion) {
+        error = "unsupported path store version";
+    } else if (header.index_offset == 0) {
+        error = "unfinished path store";
+    } else if (header.steps == 0 || header.chunk_paths == 0 || header.index_offset < data_offset || header.index_offset > _size ||
+               header.nb_chunks > (_size - header.index_offset) / sizeof(IndexEntry)) {
+        error = "truncated path store";
+    }
+    std::uint64_t nb_paths = 0;
+    for (std::uint64_t c = 0; !error && c < header.nb_chunks; ++c) {
+        IndexEntry entry;
+        std::memcpy(&entry, _base + header.index_offset + c * sizeof(IndexEntry), sizeof(entry));
+        if (entry.offset < data_offset || entry.offset % sizeof(std::uint64_t) != 0 || entry.bytes % sizeof(std::uint64_t) != 0 ||
+            entry.bytes > header.index_offset - entry.offset || entry.nb_paths == 0 || entry.nb_paths > header.chunk_paths ||
+            (entry.encoding == kRaw && entry.bytes != std::uint64_t(entry.nb_paths) * header.steps * sizeof(double)) ||
+            entry.encoding > kPredicted || (c + 1 < header.nb_chunks && entry.nb_paths != header.chunk_paths)) {
+            error = "corrupt path store index";
+        }
+        nb_paths += entry.nb_paths;
+    }
+    if (!error && nb_paths != header.nb_paths) {
+        error = "corrupt path store index";
+    }
+    if (error) {
+        unmap();
+        throw std::invalid_argument(std::string("PathStore: ") + error + ": " + path);
+    }
+    const double* steps = reinterpret_cast<const double*>(_base + sizeof(Header));
+    _time_steps.assign(steps, steps + header.steps);
+    _nb_paths = header.nb_paths;
+    _chunk_paths = header.chunk_paths;
+    _nb_chunks = header.nb_chunks;
+    _index = _base + header.index_offset;
+}
+
+PathStore::~PathStore() {
+    unmap();
+}
+
+void PathStore::unmap() {
+    if (_base) {
+        ::munmap(const_cast<unsigned char*>(_base), _size);
+    }
+    _base = nullptr;
+    _size = 0;
+}
+
+/**
+ * @return The number of paths stored.
+ */
+std::uint64_t PathStore::getNbPaths() const {
+    return _nb_paths;
+}
+
+/**
+ * @return The number of spots of each path.
+ */
+std::size_t PathStore::getNbSteps() const {
+    return _time_steps.size();
+}
+
+/**
+ * @return The number of chunks.
+ */
+std::uint64_t PathStore::getNbChunks() const {
+    return _nb_chunks;
+}
+
+/**
+ * @return The dates of the spots of every path.
+ */
+const std::vector<double>& PathStore::getTimeSteps() const {
+    return _time_steps;
+}
+
+/**
+ * @brief The spots of chunk c, path after path, decoded unless it is the cached chunk.
+ * @throws std::invalid_argument if the chunk does not match its checksum.
+ */
+const double* PathStore::chunk(std::size_t c) {
+    IndexEntry entry;
+    std::memcpy(&entry, _index + c * sizeof(IndexEntry), sizeof(entry));
+    const std::uint64_t* words = reinterpret_cast<const std::uint64_t*>(_base + entry.offset);
+    const std::size_t nb_words = entry.bytes / sizeof(std::uint64_t);
+    if (c == _decoded_chunk) {
+        return entry.encoding == kRaw ? reinterpret_cast<const double*>(words) : _decoded.data();
+    }
+    if (checksum(words, nb_words) != entry.checksum) {
+        throw std::invalid_argument("PathStore: chunk checksum mismatch");
+    }
+    if (entry.encoding == kRaw) {
+        _decoded_chunk = c;
+        return reinterpret_cast<const double*>(words);
+    }
+    const std::size_t steps = _time_steps.size();
+    const std::size_t code_bytes = align8(entry.nb_paths);
+    _decoded_chunk = static_cast<std::size_t>(-1);
+    if (steps * sizeof(double) + code_bytes > entry.bytes) {
+        throw std::invalid_argument("PathStore: corrupt chunk");
+    }
+    _decoded.resize(entry.nb_paths * steps);
+    _products.resize(steps);
+    const unsigned char* codes = reinterpret_cast<const unsigned char*>(words) + steps * sizeof(double);
+    const unsigned char* in = codes + code_bytes;
+    const unsigned char* end = reinterpret_cast<const unsigned char*>(words) + entry.bytes;
+    std::memcpy(_products.data(), words, steps * sizeof(double));
+    for (std::size_t p = 0; p < entry.nb_paths; ++p) {
+        const std::size_t n = codes[p] & kWidthMask;
+        const bool antithetic = (codes[p] & kAntithetic) != 0;
+        if (n > 8 || (codes[p] & ~(kWidthMask | kAntithetic)) != 0 || (antithetic && p == 0) ||
+            steps * n > static_cast<std::size_t>(end - in)) {
+            throw std::invalid_argument("PathStore: corrupt chunk");
+        }
+        double* path = &_decoded[p * steps];
+        if (antithetic) {
+            const double* partner = path - steps;
+            for (std::size_t k = 0; k < steps; ++k) {
+                path[k] = doubleOf(getResidual(in + k * n, n) ^ bitsOf(_products[k] / partner[k]));
+            }
+        } else {
+            std::uint64_t previous = p > 0 ? bitsOf(path[-static_cast<std::ptrdiff_t>(steps)]) : 0;
+            for (std::size_t k = 0; k < steps; ++k) {
+                previous ^= getResidual(in + k * n, n);
+                path[k] = doubleOf(previous);
+            }
+        }
+        in += steps * n;
+    }
+    _decoded_chunk = c;
+    return _decoded.data();
+}
+
+/**
+ * @brief Read one path.
+ * @param i The index of the path, in the order the paths were written.
+ * @param spots Receives the spots of the path.
+ * @throws std::out_of_range if i is not a path of the store.
+ * @throws std::invalid_argument if its chunk does not match its checksum.
+ */
+void PathStore::path(std::uint64_t i, std::vector<double>& spots) {
+    if (i >= _nb_paths) {
+        throw std::out_of_range("PathStore: path index out of range");
+    }
+    const std::size_t steps = _time_steps.size();
+    const double* first = chunk(static_cast<std::size_t>(i / _chunk_paths)) + (i % _chunk_paths) * steps;
+    spots.assign(first, first + steps);
+}
+
+/**
+ * @brief Price an option on the stored paths.
+ * @details The discounted payoffs, exp(-r T) payoffPath(path) with T the last time step,
+ * are averaged in path order with the same running mean as BlackScholesMCPricer, so
+ * pricing the option of the simulation that wrote the paths at its rate gives back its
+ * price exactly.
+ * @param option The option; an Asian option must fix on the time steps of the store,
+ * another option must expire on the last one.
+ * @param interest_rate The interest rate of the risk-free asset.
+ * @return The average discounted payoff.
+ * @throws std::invalid_argument if the option does not match the time steps of the store
+ * or a chunk does not match its checksum.
+ * @throws std::logic_error if the store has no path.
+ */
+double PathStore::price(const Option& option, double interest_rate) {
+    if (option.isAsianOption() ? option.getTimeSteps() != _time_steps : option.getExpiry() != _time_steps.back()) {
+        throw std::invalid_argument("PathStore: option does not match the time steps of the store");
+    }
+    if (_nb_paths == 0) {
+        throw std::logic_error("PathStore: no path to price on");
+    }
+    const std::size_t steps = _time_steps.size();
+    const double df = std::exp(-interest_rate * _time_steps.back());
+    std::vector<double> spots(steps);
+    double estimate = 0.0;
+    std::uint64_t n = 0;
+    for (std::size_t c = 0; c < _nb_chunks; ++c) {
+        const double* paths = chunk(c);
+        const std::uint64_t nb_paths = std::min<std::uint64_t>(_chunk_paths, _nb_paths - c * _chunk_paths);
+        for (std::uint64_t p = 0; p < nb_paths; ++p) {
+            std::copy(paths + p * steps, paths + (p + 1) * steps, spots.begin());
+            const double payoff = df * option.payoffPath(spots);
+            ++n;
+            estimate += (payoff - estimate) / static_cast<double>(n);
+        }
+    }
+    return estimate;
+}
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include "PortfolioGenerator.h"
+#include "AmericanCallOption.h"
+#include "AmericanPutOption.h"
+#include "AsianCallOption.h"
+#include "AsianPutOption.h"
+#include "CallOption.h"
+#include "EuropeanDigitalCallOption.h"
+#include "EuropeanDigitalPutOption.h"
+#include "PutOption.h"
+#include "Xoshiro256pp.h"
+
+namespace {
+
+// uniform on (0, 1), from the top 53 bits
+double uniform(Xoshiro256pp& gen) {
+    return (static_cast<double>(gen() >> 11) + 0.5) * 0x1.0p-53;
+}
+
+double uniform(Xoshiro256pp& gen, double lo, double hi) {
+    return lo + (hi - lo) * uniform(gen);
+}
+
+double logUniform(Xoshiro256pp& gen, double lo, double hi) {
+    return lo * std::exp(std::log(hi / lo) * uniform(gen));
+}
+
+// Box-Muller, one normal per call
+double normal(Xoshiro256pp& gen) {
+    const double u1 = uniform(gen);
+    const double u2 = uniform(gen);
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+}
+
+std::size_t pick(Xoshiro256pp& gen, const std::vector<double>& weights) {
+    const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double u = uniform(gen) * total;
+    for (std::size_t i = 0; i + 1 < weights.size(); ++i) {
+        if (u < weights[i]) {
+            return i;
+        }
+        u -= weights[i];
+    }
+    return weights.size() - 1;
+}
+
+void checkWeights(const std::vector<double>& weights, std::size_t size, const char* what) {
+    if (weights.size() != size || size == 0) {
+        throw std::invalid_argument(std::string("PortfolioGenerator: need one weight per value for ") + what);
+    }
+    if (std::any_of(weights.begin(), weights.end(), [](double w) { return !(w >= 0.0); }) ||
+        !(std::accumulate(weights.begin(), weights.end(), 0.0) > 0.0)) {
+        throw std::invalid_argument(std::string("PortfolioGenerator: weights must be non-negative, not all zero, for ") + what);
+    }
+}
+
+void checkRange(double lo, double hi, const char* what) {
+    if (!(lo <= hi)) {
+        throw std::invalid_argument(std::string("PortfolioGenerator: need min <= max for ") + what);
+    }
+}
+
+const char* kindName(ProductKind kind) {
+    switch (kind) {
+        case ProductKind::EuropeanVanilla: return "european";
+        case ProductKind::EuropeanDigital: return "digital";
+        case ProductKind::American: return "american";
+        case ProductKind::Asian: return "asian";
+    }
+    return "";
+}
+
+}
+
+/**
+ * @brief Construct a generator for a product mix.
+ * @param mix The distributions to draw books from.
+ * @throws std::invalid_argument if a weight is negative, the weights of a distribution are
+ * all zero or do not match its values, a range is inverted, a share is outside [0, 1], or
+ * a tenor, fixing count, spot, volatility or quantity is not positive.
+ */
+PortfolioGenerator::PortfolioGenerator(const PortfolioMix& mix) : _mix(mix) {
+    checkWeights({mix.european_vanilla, mix.european_digital, mix.american, mix.asian}, 4, "product types");
+    checkWeights(mix.tenor_weights, mix.tenors.size(), "tenors");
+    checkWeights(mix.asian_fixing_weights, mix.asian_fixings.size(), "Asian fixing counts");
+    if (!(mix.call_share >= 0.0 && mix.call_share <= 1.0) || !(mix.tenor_jitter >= 0.0 && mix.tenor_jitter < 1.0)) {
+        throw std::invalid_argument("PortfolioGenerator: call share must be in [0, 1] and tenor jitter in [0, 1)");
+    }
+    if (std::any_of(mix.tenors.begin(), mix.tenors.end(), [](double t) { return !(t > 0.0); }) ||
+        std::any_of(mix.asian_fixings.begin(), mix.asian_fixings.end(), [](int n) { return n < 1; })) {
+        throw std::invalid_argument("PortfolioGenerator: tenors and fixing counts must be positive");
+    }
+    if (!(mix.log_moneyness_sd >= 0.0) || !(mix.max_log_moneyness >= 0.0)) {
+        throw std::invalid_argument("PortfolioGenerator: moneyness spread must be non-negative");
+    }
+    if (mix.nb_underlyings == 0 || !(mix.min_spot > 0.0) || !(mix.min_volatility > 0.0) || !(mix.min_quantity > 0.0)) {
+        throw std::invalid_argument("PortfolioGenerator: need an underlying and positive spots, volatilities and quantities");
+    }
+    checkRange(mix.min_spot, mix.max_spot, "spots");
+    checkRange(mix.min_rate, mix.max_rate, "rates");
+    checkRange(mix.min_volatility, mix.max_volatility, "volatilities");
+    checkRange(mix.min_quantity, mix.max_quantity, "quantities");
+}
+
+/**
+ * @brief Draw a new book and its market data, replacing the previous ones.
+ * @details Each underlying gets a spot, a rate and a volatility. Each trade then draws,
+ * in order: its product type, call or put, underlying (uniformly), tenor, strike, fixing
+ * count (Asians only; 1 otherwise) and quantity. The strike is F exp(m) for the forward F
+ * of its underlying at the expiry and m normal, clipped to the maximum log-moneyness.
+ * @param nb_trades The number of trades.
+ * @param seed The seed; the same seed and mix give the same book.
+ */
+void PortfolioGenerator::generate(std::size_t nb_trades, std::uint64_t seed) {
+    Xoshiro256pp gen(seed);
+    _market.resize(_mix.nb_underlyings);
+    for (MarketQuote& quote : _market) {
+        quote.spot = logUniform(gen, _mix.min_spot, _mix.max_spot);
+        quote.rate = uniform(gen, _mix.min_rate, _mix.max_rate);
+        quote.volatility = uniform(gen, _mix.min_volatility, _mix.max_volatility);
+    }
+
+    const std::vector<double> kinds = {_mix.european_vanilla, _mix.european_digital, _mix.american, _mix.asian};
+    _trades.resize(nb_trades);
+    for (SyntheticTrade& trade : _trades) {
+        trade.kind = static_cast<ProductKind>(pick(gen, kinds));
+        trade.type = uniform(gen) < _mix.call_share ? OptionType::Call : OptionType::Put;
+        trade.underlying = std::min(static_cast<std::size_t>(uniform(gen) * _market.size()), _market.size() - 1);
+        trade.expiry = _mix.tenors[pick(gen, _mix.tenor_weights)] * uniform(gen, 1.0 - _mix.tenor_jitter, 1.0 + _mix.tenor_jitter);
+        const MarketQuote& quote = _market[trade.underlying];
+        const double m = std::clamp(_mix.log_moneyness_sd * std::sqrt(trade.expiry) * normal(gen), -_mix.max_log_moneyness,
+                                    _mix.max_log_moneyness);
+        trade.strike = quote.spot * std::exp(quote.rate * trade.expiry + m);
+        trade.nb_fixings = trade.kind == ProductKind::Asian ? _mix.asian_fixings[pick(gen, _mix.asian_fixing_weights)] : 1;
+        trade.quantity = std::max(1.0, std::round(logUniform(gen, _mix.min_quantity, _mix.max_quantity)));
+    }
+}
+
+/**
+ * @return The distributions the books are drawn from.
+ */
+const PortfolioMix& PortfolioGenerator::getMix() const {
+    return _mix;
+}
+
+/**
+ * @return The trades of the last generated book.
+ */
+const std::vector<SyntheticTrade>& PortfolioGenerator::trades() const {
+    return _trades;
+}
+
+/**
+ * @return The quotes of the underlyings of the last generated book, indexed by
+ * SyntheticTrade::underlying.
+ */
+const std::vector<MarketQuote>& PortfolioGenerator::market() const {
+    return _market;
+}
+
+/**
+ * @brief Build the options of the book.
+ * @details The book is cleared first, so that book[i] is the option of trade i. Asian
+ * fixings are evenly spaced, the last on the expiry.
+ * @param book The book to fill.
+ */
+void PortfolioGenerator::fill(OptionBook& book) const {
+    book.clear();
+    book.reserve(_trades.size());
+    std::vector<double> steps;
+    for (const SyntheticTrade& t : _trades) {
+        const bool call = t.type == OptionType::Call;
+        switch (t.kind) {
+            case ProductKind::EuropeanVanilla:
+                call ? static_cast<Option*>(book.add<CallOption>(t.expiry, t.strike)) : book.add<PutOption>(t.expiry, t.strike);
+                break;
+            case ProductKind::EuropeanDigital:
+                call ? static_cast<Option*>(book.add<EuropeanDigitalCallOption>(t.expiry, t.strike))
+                     : book.add<EuropeanDigitalPutOption>(t.expiry, t.strike);
+                break;
+            case ProductKind::American:
+                call ? static_cast<Option*>(book.add<AmericanCallOption>(t.expiry, t.strike))
+                     : book.add<AmericanPutOption>(t.expiry, t.strike);
+                break;
+            case ProductKind::Asian:
+                steps.resize(t.nb_fixings);
+                for (int i = 0; i + 1 < t.nb_fixings; ++i) {
+                    steps[i] = t.expiry * (i + 1) / t.nb_fixings;
+                }
+                steps.back() = t.expiry;
+                call ? static_cast<Option*>(book.add<AsianCallOption>(steps, t.strike)) : book.add<AsianPutOption>(steps, t.strike);
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Append the European vanilla and digital trades to a closed-form batch.
+ * @param input The batch input.
+ * @return The index of the trade of each appended row.
+ */
+std::vector<std::size_t> PortfolioGenerator::fill(BlackScholesBatchInput& input) const {
+    std::vector<std::size_t> rows;
+    for (std::size_t i = 0; i < _trades.size(); ++i) {
+        const SyntheticTrade& t = _trades[i];
+        if (t.kind == ProductKind::EuropeanVanilla || t.kind == ProductKind::EuropeanDigital) {
+            const MarketQuote& quote = _market[t.underlying];
+            input.add(t.type, t.kind == ProductKind::EuropeanDigital, quote.spot, t.strike, t.expiry, quote.rate, quote.volatility);
+            rows.push_back(i);
+        }
+    }
+    return rows;
+}
+
+/**
+ * @brief Add the trades that Monte Carlo can price (all but the Americans) to a batch.
+ * @param batch The batch.
+ * @param book The book built by fill(OptionBook&) from this generator.
+ * @return The index of the trade of each added contract.
+ * @throws std::invalid_argument if the book does not hold one option per trade.
+ */
+std::vector<std::size_t> PortfolioGenerator::fill(BlackScholesMCBatch& batch, const OptionBook& book) const {
+    checkBook(book);
+    std::vector<std::size_t> contracts;
+    for (std::size_t i = 0; i < _trades.size(); ++i) {
+        if (_trades[i].kind != ProductKind::American) {
+            const MarketQuote& quote = _market[_trades[i].underlying];
+            batch.add(book[i], quote.spot, quote.rate, quote.volatility);
+            contracts.push_back(i);
+        }
+    }
+    return contracts;
+}
+
+/**
+ * @brief Add the trades that Monte Carlo can price (all but the Americans) to a portfolio
+ * scheduler, with their quantities.
+ * @param scheduler The scheduler.
+ * @param book The book built by fill(OptionBook&) from this generator.
+ * @return The index of the trade of each added position.
+ * @throws std::invalid_argument if the book does not hold one option per trade.
+ */
+std::vector<std::size_t> PortfolioGenerator::fill(PortfolioMCScheduler& scheduler, const OptionBook& book) const {
+    checkBook(book);
+    std::vector<std::size_t> positions;
+    for (std::size_t i = 0; i < _trades.size(); ++i) {
+        if (_trades[i].kind != ProductKind::American) {
+            const MarketQuote& quote = _market[_trades[i].underlying];
+            scheduler.add(book[i], quote.spot, quote.rate, quote.volatility, _trades[i].quantity);
+            positions.push_back(i);
+        }
+    }
+    return positions;
+}
+
+/**
+ * @brief Write the book as CSV, one line per trade with the quote of its underlying.
+ * @param os The output stream.
+ * @throws std::runtime_error if the stream fails.
+ */
+void PortfolioGenerator::writeCsv(std::ostream& os) const {
+    os << "trade,kind,type,underlying,spot,rate,volatility,expiry,strike,fixings,quantity\n";
+    const auto precision = os.precision(17);
+    for (std::size_t i = 0; i < _trades.size(); ++i) {
+        const SyntheticTrade& t = _trades[i];
+        const MarketQuote& quote = _market[t.underlying];
+        os << i << ',' << kindName(t.kind) << ',' << (t.type == OptionType::Call ? "call" : "put") << ',' << t.underlying << ','
+           << quote.spot << ',' << quote.rate << ',' << quote.volatility << ',' << t.expiry << ',' << t.strike << ',' << t.nb_fixings
+           << ',' << t.quantity << '\n';
+    }
+    os.precision(precision);
+    if (!os) {
+        throw std::runtime_error("PortfolioGenerator: cannot write CSV");
+    }
+}
+
+void PortfolioGenerator::checkBook(const OptionBook& book) const {
+    if (book.size() != _trades.size()) {
+        throw std::invalid_argument("PortfolioGenerator: book was not filled from this generator");
+    }
+}
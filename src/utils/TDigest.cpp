@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include "TDigest.h"
+
+namespace {
+
+constexpr double kBufferFactor = 5.0;
+constexpr std::uint32_t kMagic = 0x54444754; // "TGDT"
+constexpr std::uint32_t kVersion = 1;
+// load() refuses larger compressions: the digest reserves a buffer proportional to it
+constexpr double kMaxLoadedCompression = 1e6;
+
+// k1 scale function: a centroid may span at most one unit of k
+double scale(double q, double compression) {
+    return compression / (2.0 * M_PI) * std::asin(2.0 * q - 1.0);
+}
+
+double inverseScale(double k, double compression) {
+    const double angle = 2.0 * M_PI * k / compression;
+    return angle >= 0.5 * M_PI ? 1.0 : 0.5 * (std::sin(angle) + 1.0);
+}
+
+// integral of the linear interpolation of (q0, x0), (q1, x1) over [a, b] within [q0, q1]
+double segmentIntegral(double q0, double x0, double q1, double x1, double a, double b) {
+    const double slope = q1 > q0 ? (x1 - x0) / (q1 - q0) : 0.0;
+    const double xa = x0 + slope * (a - q0);
+    const double xb = x0 + slope * (b - q0);
+    return 0.5 * (xa + xb) * (b - a);
+}
+
+}
+
+/**
+ * @brief Construct an empty digest.
+ * @param compression The accuracy parameter d: about d centroids; the quantile error at
+ * level p scales as sqrt(p (1 - p)) / d.
+ * @throws std::invalid_argument if compression < 10.
+ */
+TDigest::TDigest(double compression)
+    : _compression(compression),
+      _min(std::numeric_limits<double>::infinity()),
+      _max(-std::numeric_limits<double>::infinity()) {
+    if (!(compression >= 10.0)) {
+        throw std::invalid_argument("TDigest: compression must be at least 10");
+    }
+    _buffer.reserve(static_cast<std::size_t>(kBufferFactor * compression));
+}
+
+/**
+ * @brief Add a value; NaN is ignored.
+ */
+void TDigest::add(double value) {
+    if (std::isnan(value)) {
+        return;
+    }
+    _buffer.push_back(Centroid{value, 1.0});
+    _total += 1.0;
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+    if (_buffer.size() >= kBufferFactor * _compression) {
+        compress();
+    }
+}
+
+/**
+ * @brief Add n values; NaNs are ignored.
+ */
+void TDigest::add(const double* values, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        add(values[i]);
+    }
+}
+
+/**
+ * @brief Fold another digest into this one, as if its values had been added here.
+ * @details The result keeps this digest's compression.
+ */
+void TDigest::merge(const TDigest& other) {
+    if (&other == this || other._total == 0.0) {
+        return;
+    }
+    _buffer.insert(_buffer.end(), other._centroids.begin(), other._centroids.end());
+    _buffer.insert(_buffer.end(), other._buffer.begin(), other._buffer.end());
+    _total += other._total;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+    compress();
+}
+
+/**
+ * @brief Merge the buffered values into the centroids.
+ * @details The buffered values are sorted, merged with the (sorted) centroids and swept
+ * once, adjacent ones being merged while the merged centroid spans at most one unit of the scale
+ * function.
+ */
+void TDigest::compress() {
+    if (_buffer.empty()) {
+        return;
+    }
+    const auto by_mean = [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; };
+    std::sort(_buffer.begin(), _buffer.end(), by_mean);
+    _merged.resize(_buffer.size() + _centroids.size());
+    std::merge(_buffer.begin(), _buffer.end(), _centroids.begin(), _centroids.end(), _merged.begin(), by_mean);
+    _centroids.clear();
+    _centroids.push_back(_merged.front());
+    double weight_before = 0.0;
+    double q_limit = inverseScale(scale(0.0, _compression) + 1.0, _compression);
+    for (std::size_t i = 1; i < _merged.size(); ++i) {
+        const Centroid& next = _merged[i];
+        Centroid& last = _centroids.back();
+        const double q = (weight_before + last.weight + next.weight) / _total;
+        if (q <= q_limit) {
+            last.weight += next.weight;
+            last.mean += (next.mean - last.mean) * next.weight / last.weight;
+        } else {
+            weight_before += last.weight;
+            q_limit = inverseScale(scale(weight_before / _total, _compression) + 1.0, _compression);
+            _centroids.push_back(next);
+        }
+    }
+    _buffer.clear();
+    _knots_q.clear();
+}
+
+/**
+ * @brief Forget every value.
+ */
+void TDigest::clear() {
+    _centroids.clear();
+    _buffer.clear();
+    _knots_q.clear();
+    _total = 0.0;
+    _min = std::numeric_limits<double>::infinity();
+    _max = -std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @return The number of values added, merged digests included.
+ */
+double TDigest::count() const {
+    return _total;
+}
+
+/**
+ * @return The smallest value added.
+ * @throws std::logic_error if the digest is empty.
+ */
+double TDigest::min() const {
+    checkNotEmpty();
+    return _min;
+}
+
+/**
+ * @return The largest value added.
+ * @throws std::logic_error if the digest is empty.
+ */
+double TDigest::max() const {
+    checkNotEmpty();
+    return _max;
+}
+
+/**
+ * @return The compression the digest was built with.
+ */
+double TDigest::getCompression() const {
+    return _compression;
+}
+
+/**
+ * @return The number of centroids once compressed: the memory held, in pairs of doubles.
+ */
+std::size_t TDigest::centroids() {
+    compress();
+    return _centroids.size();
+}
+
+/**
+ * @brief The interpolation knots: (0, min), each centroid's mid-rank and mean, (1, max).
+ */
+void TDigest::buildKnots() {
+    compress();
+    if (!_knots_q.empty()) {
+        return;
+    }
+    _knots_x.clear();
+    _knots_q.push_back(0.0);
+    _knots_x.push_back(_min);
+    double cumulative = 0.0;
+    for (const Centroid& c : _centroids) {
+        _knots_q.push_back((cumulative + 0.5 * c.weight) / _total);
+        _knots_x.push_back(c.mean);
+        cumulative += c.weight;
+    }
+    _knots_q.push_back(1.0);
+    _knots_x.push_back(_max);
+}
+
+/**
+ * @param p The level, in [0, 1].
+ * @return The estimated p-quantile of the values.
+ * @throws std::invalid_argument if p is not in [0, 1].
+ * @throws std::logic_error if the digest is empty.
+ */
+double TDigest::quantile(double p) {
+    if (!(p >= 0.0 && p <= 1.0)) {
+        throw std::invalid_argument("TDigest: quantile level must be in [0, 1]");
+    }
+    checkNotEmpty();
+    buildKnots();
+    const std::size_t hi = static_cast<std::size_t>(std::upper_bound(_knots_q.begin(), _knots_q.end(), p) - _knots_q.begin());
+    if (hi >= _knots_q.size()) {
+        return _max;
+    }
+    const std::size_t lo = hi - 1;
+    const double span = _knots_q[hi] - _knots_q[lo];
+    const double t = span > 0.0 ? (p - _knots_q[lo]) / span : 0.0;
+    return _knots_x[lo] + t * (_knots_x[hi] - _knots_x[lo]);
+}
+
+/**
+ * @brief The mean of the values between two quantile levels.
+ * @details A centroid covers a range of ranks and its mean is the exact mean of the
+ * values there, so the centroids entirely within [from, to] contribute exactly; only the
+ * (at most two) centroids straddling a bound are cut by integrating the interpolated
+ * quantile function. tailMean(0.99, 1) is the mean of the top 1%, tailMean(0, 0.01)
+ * that of the bottom 1%, and tailMean(0, 1) the mean of all values.
+ * @param from The lower level, in [0, 1].
+ * @param to The upper level, in [from, 1].
+ * @return The mean, or quantile(from) if from == to.
+ * @throws std::invalid_argument if the levels are not ordered within [0, 1].
+ * @throws std::logic_error if the digest is empty.
+ */
+double TDigest::tailMean(double from, double to) {
+    if (!(from >= 0.0 && from <= to && to <= 1.0)) {
+        throw std::invalid_argument("TDigest: need 0 <= from <= to <= 1");
+    }
+    if (from == to) {
+        return quantile(from);
+    }
+    checkNotEmpty();
+    buildKnots();
+    double integral = 0.0;
+    double cumulative = 0.0;
+    for (const Centroid& c : _centroids) {
+        const double lo = cumulative / _total;
+        cumulative += c.weight;
+        const double hi = cumulative / _total;
+        const double a = std::max(from, lo);
+        const double b = std::min(to, hi);
+        if (a >= b) {
+            continue;
+        }
+        integral += a == lo && b == hi ? c.mean * (hi - lo) : integrateKnots(a, b);
+    }
+    return integral / (to - from);
+}
+
+/**
+ * @brief The integral of the interpolated quantile function over [from, to].
+ */
+double TDigest::integrateKnots(double from, double to) const {
+    double integral = 0.0;
+    for (std::size_t i = 0; i + 1 < _knots_q.size(); ++i) {
+        const double a = std::max(from, _knots_q[i]);
+        const double b = std::min(to, _knots_q[i + 1]);
+        if (a < b) {
+            integral += segmentIntegral(_knots_q[i], _knots_x[i], _knots_q[i + 1], _knots_x[i + 1], a, b);
+        }
+    }
+    return integral;
+}
+
+/**
+ * @brief The mean of the values above the level quantile, E[X | X >= q_level].
+ * @details For a payoff distribution this is the expected payoff in the upper tail;
+ * tailMean(0, 1 - level) gives the lower tail.
+ * @throws std::invalid_argument if level is not in [0, 1).
+ * @throws std::logic_error if the digest is empty.
+ */
+double TDigest::expectedShortfall(double level) {
+    if (!(level >= 0.0 && level < 1.0)) {
+        throw std::invalid_argument("TDigest: shortfall level must be in [0, 1)");
+    }
+    return tailMean(level, 1.0);
+}
+
+/**
+ * @brief Write the compressed digest in a native binary format, for checkpoints.
+ * @throws std::runtime_error if the stream fails.
+ */
+void TDigest::save(std::ostream& os) {
+    compress();
+    const std::uint32_t header[2] = {kMagic, kVersion};
+    const std::uint64_t size = _centroids.size();
+    const double scalars[4] = {_compression, _total, _min, _max};
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    os.write(reinterpret_cast<const char*>(scalars), sizeof(scalars));
+    os.write(reinterpret_cast<const char*>(_centroids.data()), static_cast<std::streamsize>(size * sizeof(Centroid)));
+    if (!os) {
+        throw std::runtime_error("TDigest: write failed");
+    }
+}
+
+/**
+ * @brief Read a digest written by save().
+ * @details The compression and the number of centroids are checked before anything is
+ * allocated: the compression must be at most 1e6, and a compressed digest holds about
+ * compression centroids, so more than (2 + kBufferFactor) times the compression means a
+ * corrupt size.
+ * @throws std::invalid_argument if the stream does not hold a digest, or is truncated.
+ */
+TDigest TDigest::load(std::istream& is) {
+    std::uint32_t header[2] = {};
+    std::uint64_t size = 0;
+    double scalars[4] = {};
+    if (!is.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != kMagic || header[1] != kVersion) {
+        throw std::invalid_argument("TDigest: not a digest");
+    }
+    if (!is.read(reinterpret_cast<char*>(&size), sizeof(size)) || !is.read(reinterpret_cast<char*>(scalars), sizeof(scalars))) {
+        throw std::invalid_argument("TDigest: truncated digest");
+    }
+    if (!(scalars[0] <= kMaxLoadedCompression) || static_cast<double>(size) > (2.0 + kBufferFactor) * scalars[0]) {
+        throw std::invalid_argument("TDigest: corrupt digest");
+    }
+    TDigest digest(scalars[0]);
+    digest._centroids.resize(size);
+    if (!is.read(reinterpret_cast<char*>(digest._centroids.data()), static_cast<std::streamsize>(size * sizeof(Centroid)))) {
+        throw std::invalid_argument("TDigest: truncated digest");
+    }
+    digest._total = scalars[1];
+    digest._min = scalars[2];
+    digest._max = scalars[3];
+    return digest;
+}
+
+void TDigest::checkNotEmpty() const {
+    if (_total == 0.0) {
+        throw std::logic_error("TDigest: no value added");
+    }
+}
@@ -0,0 +1,327 @@
+#include "TablePack.h"
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'P', 'T', 'B', 'L', 'P', 'A', 'K'};
+constexpr std::size_t kAlignment = 64;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint64_t file_size;
+    std::uint64_t checksum;
+    unsigned char reserved[32];
+};
+
+struct Entry {
+    char name[TablePack::kMaxName + 1];
+    std::uint64_t offset;
+    std::uint64_t count;
+    unsigned char reserved[8];
+};
+
+static_assert(sizeof(Header) == 64 && sizeof(Entry) == 64, "TablePack: header and entries are 64 bytes");
+
+std::uint64_t fnv1a(const unsigned char* data, std::size_t size) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::size_t aligned(std::size_t n) {
+    return (n + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+}
+
+/**
+ * @brief Map a table pack.
+ * @param path The pack file.
+ * @param verify_checksum Whether to check the checksum of the whole file, a single pass
+ * over it; the header and the directory are checked in any case.
+ * @throws std::runtime_error if the file cannot be opened or mapped.
+ * @throws std::invalid_argument if the file is not a pack of this version, is truncated
+ * or does not match its checksum.
+ */
+TablePack::TablePack(const std::string& path, bool verify_checksum) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("TablePack: cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        throw std::invalid_argument("TablePack: not a table pack: " + path);
+    }
+    void* base = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("TablePack: cannot map " + path);
+    }
+    _base = static_cast<const unsigned char*>(base);
+    _size = static_cast<std::size_t>(info.st_size);
+
+    Header header;
+    std::memcpy(&header, _base, sizeof(Header));
+    const char* error = nullptr;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        error = "not a table pack";
+    } else if (header.version != kVersion) {
+        error = "unsupported table pack version";
+    } else if (header.file_size != _size || sizeof(Header) + std::uint64_t(header.count) * sizeof(Entry) > _size) {
+        error = "truncated table pack";
+    } else if (verify_checksum && fnv1a(_base + sizeof(Header), _size - sizeof(Header)) != header.checksum) {
+        error = "table pack checksum mismatch";
+    }
+    if (!error) {
+        _count = header.count;
+        const Entry* entries = reinterpret_cast<const Entry*>(_base + sizeof(Header));
+        for (std::uint32_t i = 0; i < _count && !error; ++i) {
+            const Entry& e = entries[i];
+            if (e.name[kMaxName] != '\0' || e.offset % kAlignment != 0 || e.offset > _size ||
+                e.count > (_size - e.offset) / sizeof(double) || (i > 0 && std::strcmp(entries[i - 1].name, e.name) >= 0)) {
+                error = "corrupt table pack directory";
+            }
+        }
+    }
+    if (error) {
+        unmap();
+        throw std::invalid_argument(std::string("TablePack: ") + error + ": " + path);
+    }
+}
+
+TablePack::TablePack(TablePack&& other) noexcept : _base(other._base), _size(other._size), _count(other._count) {
+    other._base = nullptr;
+    other._size = 0;
+    other._count = 0;
+}
+
+TablePack& TablePack::operator=(TablePack&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(_base, other._base);
+        std::swap(_size, other._size);
+        std::swap(_count, other._count);
+    }
+    return *this;
+}
+
+TablePack::~TablePack() {
+    unmap();
+}
+
+void TablePack::unmap() {
+    if (_base) {
+        ::munmap(const_cast<unsigned char*>(_base), _size);
+    }
+    _base = nullptr;
+    _size = 0;
+    _count = 0;
+}
+
+/**
+ * @return true if no pack is mapped.
+ */
+bool TablePack::empty() const {
+    return _base == nullptr;
+}
+
+/**
+ * @return The number of tables.
+ */
+std::size_t TablePack::size() const {
+    return _count;
+}
+
+/**
+ * @param i The index of the table, in name order.
+ * @return The name of table i.
+ * @throws std::out_of_range if i is out of range.
+ */
+std::string TablePack::name(std::size_t i) const {
+    if (i >= _count) {
+        throw std::out_of_range("TablePack: table index out of range");
+    }
+    return reinterpret_cast<const Entry*>(_base + sizeof(Header))[i].name;
+}
+
+/**
+ * @param name The name of the table.
+ * @return A view of the table in the mapping, empty (null data) if there is no such table.
+ */
+TableView TablePack::find(const std::string& name) const {
+    const Entry* first = reinterpret_cast<const Entry*>(_base + sizeof(Header));
+    const Entry* last = first + _count;
+    const Entry* it = std::lower_bound(first, last, name, [](const Entry& e, const std::string& key) { return key.compare(e.name) > 0; });
+    if (it == last || name != it->name) {
+        return TableView{};
+    }
+    return TableView{reinterpret_cast<const double*>(_base + it->offset), static_cast<std::size_t>(it->count)};
+}
+
+/**
+ * @param name The name of the table.
+ * @return A view of the table in the mapping.
+ * @throws std::out_of_range if there is no such table.
+ */
+TableView TablePack::at(const std::string& name) const {
+    const TableView view = find(name);
+    if (!view.data) {
+        throw std::out_of_range("TablePack: no table " + name);
+    }
+    return view;
+}
+
+namespace {
+
+// the directory of the executable or shared library this code was linked into
+std::string moduleDirectory() {
+    Dl_info info{};
+    if (::dladdr(reinterpret_cast<void*>(&moduleDirectory), &info) == 0 || !info.dli_fname) {
+        return std::string();
+    }
+    const std::string module = info.dli_fname;
+    const std::size_t slash = module.rfind('/');
+    return slash == std::string::npos ? std::string(".") : module.substr(0, slash);
+}
+
+struct DefaultPack {
+    TablePack pack;
+    std::string path;
+};
+
+const DefaultPack& loadDefaultPack() {
+    static const DefaultPack loaded = []() {
+        std::vector<std::string> candidates;
+        if (const char* env = std::getenv("MESIFI_TABLE_PACK")) {
+            candidates.push_back(env);
+        } else {
+            const std::string directory = moduleDirectory();
+            if (!directory.empty()) {
+                candidates.push_back(directory + "/option_pricer_tables.bin");
+#ifdef MESIFI_TABLE_PACK_RELATIVE
+                candidates.push_back(directory + "/" + MESIFI_TABLE_PACK_RELATIVE);
+#endif
+            }
+#ifdef MESIFI_TABLE_PACK_PATH
+            candidates.push_back(MESIFI_TABLE_PACK_PATH);
+#endif
+        }
+        DefaultPack result;
+        for (const std::string& path : candidates) {
+            if (path.empty() || ::access(path.c_str(), R_OK) != 0) {
+                continue;
+            }
+            try {
+                result.pack = TablePack(path);
+                result.path = path;
+            } catch (const std::exception&) {
+            }
+            break;
+        }
+        return result;
+    }();
+    return loaded;
+}
+
+}
+
+/**
+ * @brief The library's own pack, mapped and verified on first use.
+ * @details The file is the one named by the MESIFI_TABLE_PACK environment variable if it
+ * is set (empty for none). Otherwise it is the first readable one of:
+ * option_pricer_tables.bin next to the executable or shared library holding this code,
+ * the installed pack relative to it (share/option-pricer, next to bin and lib), and the
+ * pack of the build tree. The checksum is verified. If there is no such file, or it is
+ * not a valid pack, the default pack is empty and the library computes its tables
+ * instead; defaultPackPath() tells which happened.
+ * @return The default pack, possibly empty.
+ */
+const TablePack& TablePack::defaultPack() {
+    return loadDefaultPack().pack;
+}
+
+/**
+ * @return The file the default pack was mapped from, empty if none was found or valid.
+ */
+const std::string& TablePack::defaultPackPath() {
+    return loadDefaultPack().path;
+}
+
+/**
+ * @brief Add a table; a table of the same name is replaced.
+ * @param name The name, at most kMaxName characters.
+ * @param values The values.
+ * @throws std::invalid_argument if the name is empty or too long.
+ */
+void TablePackWriter::add(const std::string& name, const std::vector<double>& values) {
+    if (name.empty() || name.size() > TablePack::kMaxName || name.find('\0') != std::string::npos) {
+        throw std::invalid_argument("TablePackWriter: table names must have 1 to 39 characters");
+    }
+    const auto it = std::find(_names.begin(), _names.end(), name);
+    if (it != _names.end()) {
+        _tables[static_cast<std::size_t>(it - _names.begin())] = values;
+        return;
+    }
+    _names.push_back(name);
+    _tables.push_back(values);
+}
+
+/**
+ * @brief Write the pack.
+ * @param path The file to write, replaced if it exists.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void TablePackWriter::write(const std::string& path) const {
+    std::vector<std::size_t> order(_names.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return _names[a] < _names[b]; });
+
+    std::size_t offset = aligned(sizeof(Header) + order.size() * sizeof(Entry));
+    std::vector<Entry> entries(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        Entry& e = entries[i];
+        std::memset(&e, 0, sizeof(Entry));
+        std::memcpy(e.name, _names[order[i]].data(), _names[order[i]].size());
+        e.offset = offset;
+        e.count = _tables[order[i]].size();
+        offset = aligned(offset + e.count * sizeof(double));
+    }
+    std::vector<unsigned char> file(offset, 0);
+    std::memcpy(file.data() + sizeof(Header), entries.data(), entries.size() * sizeof(Entry));
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        const std::vector<double>& table = _tables[order[i]];
+        if (!table.empty()) {
+            std::memcpy(file.data() + entries[i].offset, table.data(), table.size() * sizeof(double));
+        }
+    }
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = TablePack::kVersion;
+    header.count = static_cast<std::uint32_t>(order.size());
+    header.file_size = file.size();
+    header.checksum = fnv1a(file.data() + sizeof(Header), file.size() - sizeof(Header));
+    std::memcpy(file.data(), &header, sizeof(Header));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    if (!out) {
+        throw std::runtime_error("TablePackWriter: cannot write " + path);
+    }
+}
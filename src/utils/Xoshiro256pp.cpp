@@ -0,0 +1,219 @@
+#include <cstring>
+#include "Xoshiro256pp.h"
+#include "Ziggurat.h"
+
+namespace {
+
+// outputs generated per step of the streams when filling from a scratch buffer
+constexpr std::size_t kChunk = 256;
+
+std::uint64_t splitmix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// serves the words of a buffer, refilled from the streams when exhausted
+class BufferedBits {
+public:
+    explicit BufferedBits(Xoshiro256ppStreams& streams) : _streams(streams), _next(kChunk) {}
+    std::uint64_t operator()() {
+        if (_next == kChunk) {
+            _streams.fill_bits(_words, kChunk);
+            _next = 0;
+        }
+        return _words[_next++];
+    }
+
+private:
+    Xoshiro256ppStreams& _streams;
+    std::size_t _next;
+    alignas(64) std::uint64_t _words[kChunk];
+};
+
+}
+
+/**
+ * @brief Construct a generator from a 64-bit seed.
+ * @param seed The seed, expanded into the 256-bit state with splitmix64.
+ */
+Xoshiro256pp::Xoshiro256pp(std::uint64_t seed) {
+    this->seed(seed);
+}
+
+/**
+ * @brief Construct a generator from its full state, which must not be all zero.
+ */
+Xoshiro256pp::Xoshiro256pp(std::uint64_t s0, std::uint64_t s1, std::uint64_t s2, std::uint64_t s3) : _s{s0, s1, s2, s3} {}
+
+/**
+ * @brief Reset the state from a 64-bit seed, expanded with splitmix64 as advised by the authors.
+ * @param seed The seed.
+ */
+void Xoshiro256pp::seed(std::uint64_t seed) {
+    for (std::uint64_t& word : _s) {
+        word = splitmix64(seed);
+    }
+}
+
+/**
+ * @brief Advance the generator by 2^128 steps, to start a non-overlapping stream.
+ */
+void Xoshiro256pp::jump() {
+    static constexpr std::uint64_t kJump[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    std::uint64_t s[4] = {0, 0, 0, 0};
+    for (std::uint64_t word : kJump) {
+        for (int b = 0; b < 64; ++b) {
+            if (word & (std::uint64_t(1) << b)) {
+                for (int k = 0; k < 4; ++k) {
+                    s[k] ^= _s[k];
+                }
+            }
+            (*this)();
+        }
+    }
+    std::memcpy(_s, s, sizeof(_s));
+}
+
+/**
+ * @brief Fill a buffer with uniform doubles in [0, 1), 52 random bits each.
+ * @param out The buffer.
+ * @param n The number of values.
+ */
+void Xoshiro256pp::fill_uniform(double* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = Ziggurat::uniform((*this)());
+    }
+}
+
+/**
+ * @brief Fill a buffer with standard normal draws (ziggurat method).
+ * @param out The buffer.
+ * @param n The number of values.
+ */
+void Xoshiro256pp::fill_normal(double* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = Ziggurat::normal(*this);
+    }
+}
+
+/**
+ * @brief Construct the streams from a 64-bit seed.
+ * @param seed The seed of stream 0; stream l is stream 0 jumped l times.
+ */
+Xoshiro256ppStreams::Xoshiro256ppStreams(std::uint64_t seed) {
+    this->seed(seed);
+}
+
+/**
+ * @brief Reset the streams from a 64-bit seed.
+ * @param seed The seed of stream 0, as in Xoshiro256pp::seed(); stream l is stream 0 jumped l times.
+ */
+void Xoshiro256ppStreams::seed(std::uint64_t seed) {
+    Xoshiro256pp generator(seed);
+    for (std::size_t l = 0; l < kStreams; ++l) {
+        _s0[l] = generator._s[0];
+        _s1[l] = generator._s[1];
+        _s2[l] = generator._s[2];
+        _s3[l] = generator._s[3];
+        generator.jump();
+    }
+}
+
+/**
+ * @brief Advance every stream by steps steps, writing output l of step k to out[k * kStreams + l].
+ * @details With GCC and Clang the state is held in vector-extension registers for the
+ * duration of the loop: left to itself, the compiler splits local lane arrays into
+ * scalars and loses the vector form.
+ */
+void Xoshiro256ppStreams::step(std::uint64_t* out, std::size_t steps) {
+#if defined(__GNUC__)
+    typedef std::uint64_t Words __attribute__((vector_size(kStreams * sizeof(std::uint64_t))));
+    Words s0;
+    Words s1;
+    Words s2;
+    Words s3;
+    std::memcpy(&s0, _s0, sizeof(s0));
+    std::memcpy(&s1, _s1, sizeof(s1));
+    std::memcpy(&s2, _s2, sizeof(s2));
+    std::memcpy(&s3, _s3, sizeof(s3));
+    for (std::size_t k = 0; k < steps; ++k, out += kStreams) {
+        const Words sum = s0 + s3;
+        const Words result = ((sum << 23) | (sum >> 41)) + s0;
+        std::memcpy(out, &result, sizeof(result));
+        const Words t = s1 << 17;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = (s3 << 45) | (s3 >> 19);
+    }
+    std::memcpy(_s0, &s0, sizeof(s0));
+    std::memcpy(_s1, &s1, sizeof(s1));
+    std::memcpy(_s2, &s2, sizeof(s2));
+    std::memcpy(_s3, &s3, sizeof(s3));
+#else
+    for (std::size_t k = 0; k < steps; ++k, out += kStreams) {
+        for (std::size_t l = 0; l < kStreams; ++l) {
+            const std::uint64_t sum = _s0[l] + _s3[l];
+            out[l] = ((sum << 23) | (sum >> 41)) + _s0[l];
+            const std::uint64_t t = _s1[l] << 17;
+            _s2[l] ^= _s0[l];
+            _s3[l] ^= _s1[l];
+            _s1[l] ^= _s2[l];
+            _s0[l] ^= _s3[l];
+            _s2[l] ^= t;
+            _s3[l] = (_s3[l] << 45) | (_s3[l] >> 19);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Fill a buffer with random 64-bit words, value i from stream i % kStreams.
+ * @param out The buffer.
+ * @param n The number of words.
+ */
+void Xoshiro256ppStreams::fill_bits(std::uint64_t* out, std::size_t n) {
+    const std::size_t full = n / kStreams;
+    step(out, full);
+    if (full * kStreams < n) {
+        std::uint64_t last[kStreams];
+        step(last, 1);
+        std::memcpy(out + full * kStreams, last, (n - full * kStreams) * sizeof(std::uint64_t));
+    }
+}
+
+/**
+ * @brief Fill a buffer with uniform doubles in [0, 1), 52 random bits each.
+ * @details The words are generated a chunk at a time and converted by a loop that
+ * vectorizes as well.
+ * @param out The buffer.
+ * @param n The number of values.
+ */
+void Xoshiro256ppStreams::fill_uniform(double* out, std::size_t n) {
+    alignas(64) std::uint64_t words[kChunk];
+    for (std::size_t first = 0; first < n; first += kChunk) {
+        const std::size_t count = n - first < kChunk ? n - first : kChunk;
+        fill_bits(words, count);
+        for (std::size_t i = 0; i < count; ++i) {
+            out[first + i] = Ziggurat::uniform(words[i]);
+        }
+    }
+}
+
+/**
+ * @brief Fill a buffer with standard normal draws (ziggurat method).
+ * @details The random words come from the streams a chunk at a time, so only the layer
+ * tests run one value at a time.
+ * @param out The buffer.
+ * @param n The number of values.
+ */
+void Xoshiro256ppStreams::fill_normal(double* out, std::size_t n) {
+    BufferedBits bits(*this);
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = Ziggurat::normal(bits);
+    }
+}
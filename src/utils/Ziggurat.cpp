@@ -0,0 +1,30 @@
+#include <cmath>
+#include "Ziggurat.h"
+
+/**
+ * @brief Build the layer tables on first use.
+ * @details Every layer, the base strip with the tail included, has the area
+ * v = r f(r) + sqrt(pi / 2) erfc(r / sqrt(2)) under f(x) = exp(-x^2 / 2), with r = kTailStart.
+ * Layer i + 1 has its right edge at f^-1(v / x[i] + f(x[i])).
+ * @return The tables.
+ */
+const Ziggurat::Tables& Ziggurat::tables() {
+    static const Tables t = [] {
+        Tables built{};
+        const double r = kTailStart;
+        const double f_r = std::exp(-0.5 * r * r);
+        const double v = r * f_r + std::sqrt(M_PI / 2.0) * std::erfc(r * M_SQRT1_2);
+        built.x[0] = v / f_r;
+        built.x[1] = r;
+        for (int i = 2; i < 256; ++i) {
+            const double prev = built.x[i - 1];
+            built.x[i] = std::sqrt(-2.0 * std::log(v / prev + std::exp(-0.5 * prev * prev)));
+        }
+        built.x[256] = 0.0;
+        for (int i = 0; i <= 256; ++i) {
+            built.f[i] = std::exp(-0.5 * built.x[i] * built.x[i]);
+        }
+        return built;
+    }();
+    return t;
+}
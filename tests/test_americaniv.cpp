@@ -0,0 +1,79 @@
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "option-pricer/options/AmericanCallOption.h"
+#include "option-pricer/options/AmericanPutOption.h"
+#include "option-pricer/pricing/AmericanImpliedVolatility.h"
+#include "option-pricer/pricing/CRRPricer.h"
+
+int main() {
+    const double spot = 100.0;
+    const double rate = 0.03;
+    constexpr int depth = 150;
+
+    // round trip: CRR price at a known volatility is inverted back to it
+    AmericanImpliedVolatility solver(depth);
+    for (double K : {80.0, 100.0, 120.0}) {
+        for (double sigma : {0.15, 0.3, 0.6}) {
+            AmericanPutOption put(0.75, K);
+            AmericanCallOption call(0.75, K);
+            const double put_price = CRRPricer(&put, depth, spot, rate, sigma)();
+            const double call_price = CRRPricer(&call, depth, spot, rate, sigma)();
+            assert(std::fabs(solver.solve(&call, call_price, spot, rate) - sigma) < 1e-6);
+            const double put_vol = solver.solve(&put, put_price, spot, rate);
+            if (put_price > put.payoff(spot) + 1e-4) {
+                assert(std::fabs(put_vol - sigma) < 1e-6);
+            } else {
+                // exercised immediately: every low enough volatility reproduces the price
+                assert(std::fabs(CRRPricer(&put, depth, spot, rate, put_vol)() - put_price) < 1e-8);
+            }
+        }
+    }
+
+    // quotes below intrinsic cannot be inverted
+    AmericanPutOption deep_put(1.0, 150.0);
+    bool below_intrinsic_thrown = false;
+    try {
+        (void)solver.solve(&deep_put, 40.0, spot, rate);
+    } catch (const std::invalid_argument&) {
+        below_intrinsic_thrown = true;
+    }
+    assert(below_intrinsic_thrown);
+
+    // a listed chain inverted in parallel batches matches the serial inversion
+    std::vector<std::unique_ptr<AmericanOption>> chain;
+    std::vector<const AmericanOption*> quoted;
+    std::vector<double> prices;
+    std::vector<double> true_vols;
+    for (double T : {0.1, 0.5, 1.0}) {
+        for (double K = 70.0; K <= 130.0; K += 5.0) {
+            const double sigma = 0.2 + 0.002 * std::fabs(K - 100.0);
+            chain.push_back(std::make_unique<AmericanPutOption>(T, K));
+            chain.push_back(std::make_unique<AmericanCallOption>(T, K));
+            for (std::size_t k = chain.size() - 2; k < chain.size(); ++k) {
+                quoted.push_back(chain[k].get());
+                prices.push_back(CRRPricer(chain[k].get(), depth, spot, rate, sigma)());
+                true_vols.push_back(sigma);
+            }
+        }
+    }
+    quoted.push_back(&deep_put);
+    prices.push_back(40.0);
+    true_vols.push_back(std::nan(""));
+
+    const std::vector<double> parallel = AmericanImpliedVolatility::solve(quoted, prices, spot, rate, depth, 4);
+    const std::vector<double> serial = AmericanImpliedVolatility::solve(quoted, prices, spot, rate, depth, 1);
+    assert(parallel.size() == quoted.size());
+    for (std::size_t j = 0; j + 1 < quoted.size(); ++j) {
+        assert(parallel[j] == serial[j]);
+        if (prices[j] > quoted[j]->payoff(spot) + 1e-4) {
+            assert(std::fabs(parallel[j] - true_vols[j]) < 1e-5);
+        }
+    }
+    assert(std::isnan(parallel.back()));
+
+    return 0;
+}
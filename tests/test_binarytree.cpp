@@ -1,8 +1,13 @@
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
+#include <string>
 #include <stdexcept>
 
 #include "option-pricer/datastruct/BinaryTree.h"
+#include "option-pricer/datastruct/Lattice.h"
+#include "option-pricer/datastruct/LatticeIO.h"
 
 int main() {
     BinaryTree<double> tree;
@@ -36,5 +41,121 @@ int main() {
     try { tree.setNode(2, 4, 0.0); } catch (const std::out_of_range&) { thrown = true; }
     assert(thrown);
 
+    // rows are aligned and padded; shrinking keeps the buffer
+    const double* level3 = tree.row(3).data();
+    for (int n = 0; n <= 3; ++n) {
+        assert(reinterpret_cast<std::uintptr_t>(tree.row(n).data()) % BinaryTree<double>::kAlignment == 0);
+        assert(tree.row(n).size() == static_cast<std::size_t>(n + 1));
+    }
+    tree.setDepth(2);
+    assert(tree.getNode(1, 0) == 0.0);
+    tree.setDepth(3);
+    assert(tree.row(3).data() == level3);
+
+    // trinomial lattice: level n has 2n + 1 nodes
+    Lattice<int, 3> tri(4);
+    assert((Lattice<int, 3>::width(4) == 9));
+    for (int n = 0; n <= 4; ++n) {
+        int k = 0;
+        for (int& v : tri.row(n)) {
+            v = 10 * n + k++;
+        }
+        assert(k == 2 * n + 1);
+    }
+    assert(tri.getNode(4, 8) == 48);
+    assert(tri.node(2, 3) == 23);
+    thrown = false;
+    try { tri.getNode(2, 5); } catch (const std::out_of_range&) { thrown = true; }
+    assert(thrown);
+    std::ostringstream tri_out;
+    tri.display(tri_out);
+    assert(tri_out.str().find("48") != std::string::npos);
+
+    // rolling lattice: two rows of the terminal width, level n in row n % 2
+    Lattice<double, 2> rolling(6, LatticeMode::Rolling);
+    for (int i = 0; i <= 6; ++i) {
+        rolling.node(6, i) = i;
+    }
+    for (int n = 5; n >= 0; --n) {
+        const LatticeRow<double> next = rolling.row(n + 1);
+        LatticeRow<double> cur = rolling.row(n);
+        assert(next.data() != cur.data());
+        for (int i = 0; i <= n; ++i) {
+            cur[i] = 0.5 * (next[i] + next[i + 1]);
+        }
+    }
+    assert(rolling.getNode(0, 0) == 3.0);
+    assert(rolling.row(0).data() == rolling.row(2).data());
+
+    Lattice<double, 2> copy(rolling);
+    assert(copy.mode() == LatticeMode::Rolling && copy.getNode(0, 0) == 3.0);
+
+    thrown = false;
+    try { tree.setDepth(-1); } catch (const std::invalid_argument&) { thrown = true; }
+    assert(thrown);
+
+    // binary dump round trip, CSV and decimated DOT
+    Lattice<double, 2> deep(200);
+    for (int n = 0; n <= 200; ++n) {
+        for (int i = 0; i <= n; ++i) {
+            deep.node(n, i) = 100.0 * n + i + 0.1;
+        }
+    }
+    std::stringstream dump;
+    LatticeIO::writeBinary(deep, dump);
+    Lattice<double, 2> reloaded(3, LatticeMode::Rolling);
+    LatticeIO::readBinary(dump, reloaded);
+    assert(reloaded.mode() == LatticeMode::FullHistory && reloaded.depth() == 200);
+    for (int n = 0; n <= 200; ++n) {
+        for (int i = 0; i <= n; ++i) {
+            assert(reloaded.getNode(n, i) == deep.getNode(n, i));
+        }
+    }
+
+    std::stringstream wrong_type(dump.str());
+    Lattice<double, 3> tri_reload;
+    thrown = false;
+    try { LatticeIO::readBinary(wrong_type, tri_reload); } catch (const std::invalid_argument&) { thrown = true; }
+    assert(thrown);
+    std::stringstream truncated(dump.str().substr(0, 1000));
+    thrown = false;
+    try { LatticeIO::readBinary(truncated, reloaded); } catch (const std::invalid_argument&) { thrown = true; }
+    assert(thrown);
+    assert(reloaded.depth() == 200 && reloaded.getNode(200, 17) == deep.getNode(200, 17));
+
+    // a corrupt depth is rejected before any allocation, and leaves the lattice as it was
+    for (std::uint32_t corrupt_depth : {200000u, 0x7fffffffu, 0xffffffffu}) {
+        std::string bytes = dump.str();
+        std::memcpy(&bytes[12], &corrupt_depth, sizeof(corrupt_depth));
+        std::stringstream corrupt(bytes);
+        thrown = false;
+        try { LatticeIO::readBinary(corrupt, reloaded); } catch (const std::invalid_argument&) { thrown = true; }
+        assert(thrown);
+        assert(reloaded.depth() == 200 && reloaded.getNode(200, 17) == deep.getNode(200, 17));
+    }
+
+    std::ostringstream csv;
+    LatticeIO::writeCsv(deep, csv);
+    assert(csv.str().rfind("level,index,value\n0,0,0.1\n1,0,100.1\n1,1,101.1\n", 0) == 0);
+    assert(csv.str().find("\n200,17,20017.1\n") != std::string::npos);
+
+    std::ostringstream dot;
+    LatticeIO::writeDot(deep, dot, 5, 4);
+    const std::string graph = dot.str();
+    assert(graph.rfind("digraph lattice {", 0) == 0);
+    assert(graph.find("n0_0 [label=\"0.1\"]") != std::string::npos);
+    assert(graph.find("n200_200 [label=\"20200.1\"]") != std::string::npos);
+    assert(graph.find("n50_0 -> n100_0") != std::string::npos);
+    assert(graph.find("n1_0") == std::string::npos);
+    std::size_t labels = 0;
+    for (std::size_t pos = graph.find("label"); pos != std::string::npos; pos = graph.find("label", pos + 1)) {
+        ++labels;
+    }
+    assert(labels <= 5 * 4);
+
+    thrown = false;
+    try { LatticeIO::writeCsv(rolling, csv); } catch (const std::invalid_argument&) { thrown = true; }
+    assert(thrown);
+
     return 0;
-}
\ No newline at end of file
+}
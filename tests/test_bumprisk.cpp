@@ -0,0 +1,78 @@
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "option-pricer/options/AmericanPutOption.h"
+#include "option-pricer/options/AsianCallOption.h"
+#include "option-pricer/options/CallOption.h"
+#include "option-pricer/pricing/BlackScholesPricer.h"
+#include "option-pricer/pricing/BumpRiskEngine.h"
+#include "option-pricer/pricing/CRRPricer.h"
+
+namespace {
+constexpr double kEps = 1e-9;
+}
+
+int main() {
+    const double spot = 100.0;
+    const double rate = 0.05;
+    const double vol = 0.2;
+    const std::vector<Bump> ladder = {
+        {0.0, 0.0, 0.0},
+        {1.0, 0.0, 0.0},
+        {-1.0, 0.0, 0.0},
+        {0.0, 0.01, 0.0},
+        {0.0, -0.01, 0.0},
+        {0.0, 0.0, 0.001},
+        {2.0, 0.01, 0.0},
+    };
+
+    // CRR bumps must reproduce fresh CRRPricer instances
+    constexpr int depth = 200;
+    CallOption call(1.0, 100.0);
+    AmericanPutOption american_put(1.0, 100.0);
+    for (Option* option : std::vector<Option*>{&call, &american_put}) {
+        BumpRiskEngine engine(option, spot, rate, vol);
+        engine.addBumps(ladder);
+        const std::vector<double> prices = engine.priceCRR(depth);
+        assert(prices.size() == ladder.size());
+        for (std::size_t b = 0; b < ladder.size(); ++b) {
+            CRRPricer fresh(option, depth, spot + ladder[b].spot_shift, rate + ladder[b].rate_shift, vol + ladder[b].vol_shift);
+            assert(std::fabs(prices[b] - fresh()) < kEps);
+        }
+    }
+
+    // MC bumps share their normals: the central delta is close to Black-Scholes
+    BumpRiskEngine mc_engine(&call, spot, rate, vol);
+    mc_engine.addBumps(ladder);
+    const std::vector<double> mc_prices = mc_engine.priceMC(20001);
+    BlackScholesPricer bs(&call, spot, rate, vol);
+    assert(std::fabs(mc_prices[0] - bs.price()) < 0.5);
+    const double mc_delta = (mc_prices[1] - mc_prices[2]) / 2.0;
+    assert(std::fabs(mc_delta - bs.delta()) < 0.02);
+    assert(mc_prices[3] > mc_prices[0] && mc_prices[0] > mc_prices[4]); // vega is positive
+
+    AsianCallOption asian({0.25, 0.5, 0.75, 1.0}, 100.0);
+    BumpRiskEngine asian_engine(&asian, spot, rate, vol);
+    asian_engine.addBump({1.0, 0.0, 0.0});
+    assert(asian_engine.priceMC(1000).size() == 1);
+
+    bool asian_crr_thrown = false;
+    try {
+        (void)asian_engine.priceCRR(depth);
+    } catch (const std::invalid_argument&) {
+        asian_crr_thrown = true;
+    }
+    assert(asian_crr_thrown);
+
+    bool negative_vol_thrown = false;
+    try {
+        mc_engine.addBump({0.0, -0.5, 0.0});
+    } catch (const std::invalid_argument&) {
+        negative_vol_thrown = true;
+    }
+    assert(negative_vol_thrown);
+
+    return 0;
+}
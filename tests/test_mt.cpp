@@ -1,7 +1,66 @@
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
 
 #include "option-pricer/utils/MT.h"
+#include "option-pricer/utils/NormalDistribution.h"
+#include "option-pricer/utils/PCG64.h"
+#include "option-pricer/utils/Xoshiro256pp.h"
+
+namespace {
+
+// moments and tails of n normals from fill_normal(), checked to well within their sampling error
+template <class Fill>
+void checkNormals(Fill fill) {
+    const std::size_t n = 1000000;
+    std::vector<double> z(n);
+    fill(z.data(), n);
+    double sum = 0.0;
+    double sq_sum = 0.0;
+    double fourth = 0.0;
+    std::size_t below = 0;
+    std::size_t tail = 0;
+    for (double v : z) {
+        assert(std::isfinite(v));
+        sum += v;
+        sq_sum += v * v;
+        fourth += v * v * v * v;
+        below += v < -1.0 ? 1 : 0;
+        tail += std::fabs(v) > 3.6541528853610088 ? 1 : 0;
+    }
+    const double mean = sum / n;
+    const double var = sq_sum / n - mean * mean;
+    assert(std::fabs(mean) < 0.005);
+    assert(std::fabs(var - 1.0) < 0.007);
+    assert(std::fabs(fourth / n - 3.0) < 0.05); // kurtosis of a normal
+    assert(std::fabs(static_cast<double>(below) / n - NormalDistribution::cdf(-1.0)) < 0.002);
+    const double expected_tail = 2.0 * NormalDistribution::cdf(-3.6541528853610088) * n; // ~258: the tail sampler is used
+    assert(std::fabs(static_cast<double>(tail) - expected_tail) < 5.0 * std::sqrt(expected_tail));
+}
+
+template <class Fill>
+void checkUniforms(Fill fill) {
+    const std::size_t n = 1000000;
+    std::vector<double> u(n);
+    fill(u.data(), n);
+    std::vector<std::size_t> bins(100, 0);
+    double sum = 0.0;
+    for (double v : u) {
+        assert(v >= 0.0 && v < 1.0);
+        sum += v;
+        bins[static_cast<std::size_t>(v * 100.0)]++;
+    }
+    assert(std::fabs(sum / n - 0.5) < 0.002);
+    double chi2 = 0.0;
+    for (std::size_t b : bins) {
+        chi2 += (b - 10000.0) * (b - 10000.0) / 10000.0;
+    }
+    assert(chi2 < 160.0); // 99 degrees of freedom: p < 1e-4 above
+}
+
+}
 
 int main() {
     const int unif_samples = 1000;
@@ -38,5 +97,86 @@ int main() {
     assert(std::abs(norm_mean) < 0.1); // mean near 0
     assert(std::abs(norm_var - 1.0) < 0.2); // variance near 1
 
+    // reference outputs of xoshiro256++ and pcg64
+    Xoshiro256pp xoshiro(1, 2, 3, 4);
+    assert(xoshiro() == 41943041ULL);
+    assert(xoshiro() == 58720359ULL);
+    assert(xoshiro() == 3588806011781223ULL);
+    PCG64 pcg(42, 54);
+    assert(pcg() == 0x86b1da1d72062b68ULL);
+    assert(pcg() == 0x1304aa46c9853d39ULL);
+    assert(pcg() == 0xa3670e9e0dd50358ULL);
+
+    // interleaved streams: stream l is the seeded generator jumped l times
+    Xoshiro256ppStreams streams(2024);
+    std::vector<std::uint64_t> words(3 * Xoshiro256ppStreams::kStreams + 3);
+    streams.fill_bits(words.data(), words.size());
+    for (std::size_t l = 0; l < Xoshiro256ppStreams::kStreams; ++l) {
+        Xoshiro256pp stream(2024);
+        for (std::size_t j = 0; j < l; ++j) {
+            stream.jump();
+        }
+        for (std::size_t step = 0; step < 3; ++step) {
+            assert(words[step * Xoshiro256ppStreams::kStreams + l] == stream());
+        }
+        if (l < 3) {
+            assert(words[3 * Xoshiro256ppStreams::kStreams + l] == stream());
+        }
+    }
+
+    Xoshiro256pp xoshiro_seeded(7);
+    PCG64 pcg_seeded(7);
+    Xoshiro256ppStreams streams_seeded(7);
+    checkUniforms([&](double* out, std::size_t n) { xoshiro_seeded.fill_uniform(out, n); });
+    checkUniforms([&](double* out, std::size_t n) { pcg_seeded.fill_uniform(out, n); });
+    checkUniforms([&](double* out, std::size_t n) { streams_seeded.fill_uniform(out, n); });
+    checkNormals([&](double* out, std::size_t n) { xoshiro_seeded.fill_normal(out, n); });
+    checkNormals([&](double* out, std::size_t n) { pcg_seeded.fill_normal(out, n); });
+    checkNormals([&](double* out, std::size_t n) { streams_seeded.fill_normal(out, n); });
+
+    // every engine is selectable behind MT and reproducible from its seed
+    for (RNGEngine engine : {RNGEngine::MT19937, RNGEngine::Xoshiro256pp, RNGEngine::PCG64, RNGEngine::Xoshiro256ppStreams}) {
+        MT::setEngine(engine, 99);
+        assert(MT::getEngine() == engine);
+        std::vector<double> first(101);
+        MT::fill_normal(first.data(), first.size());
+        const double first_unif = MT::rand_unif();
+        const double first_norm = MT::rand_norm();
+        MT::setEngine(engine, 99);
+        std::vector<double> second(101);
+        MT::fill_normal(second.data(), second.size());
+        assert(first == second);
+        assert(MT::rand_unif() == first_unif);
+        assert(MT::rand_norm() == first_norm);
+        checkNormals([](double* out, std::size_t n) { MT::fill_normal(out, n); });
+        checkUniforms([](double* out, std::size_t n) { MT::fill_uniform(out, n); });
+    }
+
+    // the engine is per thread: seeded workers draw concurrently the same sequence as the
+    // calling thread, whose own engine they leave untouched
+    MT::setEngine(RNGEngine::Xoshiro256pp, 21);
+    std::vector<double> expected(10000);
+    MT::fill_normal(expected.data(), expected.size());
+    MT::setEngine(RNGEngine::PCG64, 5);
+    const double pcg_next = MT::rand_unif();
+    MT::setEngine(RNGEngine::PCG64, 5);
+    std::vector<std::vector<double>> drawn(4, std::vector<double>(expected.size()));
+    std::vector<std::thread> workers;
+    for (std::vector<double>& out : drawn) {
+        workers.emplace_back([&out]() {
+            MT::setEngine(RNGEngine::Xoshiro256pp, 21);
+            MT::fill_normal(out.data(), out.size());
+        });
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    for (const std::vector<double>& out : drawn) {
+        assert(out == expected);
+    }
+    assert(MT::getEngine() == RNGEngine::PCG64);
+    assert(MT::rand_unif() == pcg_next);
+    MT::setEngine(RNGEngine::MT19937);
+
     return 0;
 }
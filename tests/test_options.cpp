@@ -1,5 +1,7 @@
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <memory_resource>
 #include <vector>
 #include <stdexcept>
 
@@ -11,7 +13,29 @@
 #include "option-pricer/options/PutOption.h"
 #include "option-pricer/options/AmericanCallOption.h"
 #include "option-pricer/options/AmericanPutOption.h"
+#include "option-pricer/options/OptionBook.h"
+#include "option-pricer/datastruct/FixingSchedule.h"
 
+namespace {
+
+// upstream resource tracking the bytes an OptionBook has not given back
+struct CountingResource : std::pmr::memory_resource {
+    std::size_t outstanding = 0;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}
 
 int main() {
     CallOption call(1.0, 100.0);
@@ -90,5 +114,93 @@ int main() {
     assert(threw_call);
     assert(threw_put);
 
+    // fixing schedules: inline up to the capacity, spilled to the allocator beyond
+    assert(asian_call.getFixings().isInline());
+    assert(asian_call.getFixings().size() == 4);
+    assert(std::abs(asian_call.getFixings().back() - 1.0) < 1e-12);
+    std::vector<double> daily;
+    for (int i = 1; i <= 252; ++i) {
+        daily.push_back(i / 252.0);
+    }
+    AsianCallOption daily_call(daily, 100.0);
+    assert(!daily_call.getFixings().isInline());
+    assert(daily_call.getTimeSteps() == daily);
+    assert(std::abs(daily_call.getExpiry() - 1.0) < 1e-12);
+    FixingSchedule copy(daily_call.getFixings());
+    copy = asian_call.getFixings();
+    assert(copy.isInline() && copy.size() == 4 && copy[2] == 0.75);
+
+    // option book: everything, spilled fixings included, comes from the arena
+    CountingResource upstream;
+    {
+        OptionBook book(0, &upstream);
+        book.reserve(3);
+        std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        CallOption* booked_call = book.add<CallOption>(1.0, 100.0);
+        AsianCallOption* booked_asian = book.add<AsianCallOption>(daily, 100.0);
+        book.add<AmericanPutOption>(0.5, 90.0);
+        std::pmr::set_default_resource(previous);
+
+        assert(book.size() == 3);
+        assert(book[0] == booked_call && book[1] == booked_asian);
+        assert(std::abs(book[0]->payoff(110.0) - 10.0) < 1e-9);
+        assert(book[1]->isAsianOption() && book[2]->isAmericanOption());
+        assert(booked_asian->getFixings().get_allocator().resource() == book.resource());
+        assert(booked_asian->getTimeSteps() == daily);
+        assert(upstream.outstanding > 0);
+
+        bool threw = false;
+        try {
+            book[3];
+        } catch (const std::out_of_range&) {
+            threw = true;
+        }
+        assert(threw);
+
+        book.clear();
+        assert(book.size() == 0);
+        book.add<PutOption>(1.0, 100.0);
+        assert(std::abs(book[0]->payoff(90.0) - 10.0) < 1e-9);
+    }
+    assert(upstream.outstanding == 0);
+
+    // seasoned Asian: two of four fixings observed, valuation date 0.6
+    AsianCallOption seasoned({0.25, 0.5, 0.75, 1.0}, 100.0);
+    seasoned.setPastFixings(0.6, {90.0, 110.0});
+    assert(seasoned.getNbPastFixings() == 2 && seasoned.getPastFixingSum() == 200.0 && seasoned.getValuationDate() == 0.6);
+    const std::vector<double> remaining = seasoned.getTimeSteps();
+    assert(remaining.size() == 2 && std::abs(remaining[0] - 0.15) < 1e-12 && std::abs(remaining[1] - 0.4) < 1e-12);
+    assert(std::abs(seasoned.payoffPath({100.0, 120.0}) - 5.0) < 1e-12); // (90 + 110 + 100 + 120) / 4 - 100
+    seasoned.setPastFixings(0.5, {90.0, 110.0}); // a fixing on the valuation date is known
+    assert(seasoned.getTimeSteps().size() == 2);
+    int seasoning_errors = 0;
+    try {
+        (void)seasoned.payoffPath({100.0, 120.0, 130.0});
+    } catch (const std::invalid_argument&) {
+        ++seasoning_errors;
+    }
+    for (double date : {-0.1, 1.0}) {
+        try {
+            seasoned.setPastFixings(date, {});
+        } catch (const std::invalid_argument&) {
+            ++seasoning_errors;
+        }
+    }
+    try {
+        seasoned.setPastFixings(0.6, {90.0});
+    } catch (const std::invalid_argument&) {
+        ++seasoning_errors;
+    }
+    try {
+        seasoned.setPastFixings(0.6, {90.0, -1.0});
+    } catch (const std::invalid_argument&) {
+        ++seasoning_errors;
+    }
+    assert(seasoning_errors == 5);
+    assert(seasoned.getNbPastFixings() == 2); // unchanged by the failed calls
+    seasoned.setPastFixings(0.0, {});
+    assert(seasoned.getTimeSteps() == asian_time_steps);
+    assert(std::abs(seasoned.payoffPath({100.0, 100.0, 100.0, 120.0}) - 5.0) < 1e-12);
+
     return 0;
 }
@@ -0,0 +1,138 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "option-pricer/options/AsianCallOption.h"
+#include "option-pricer/options/AsianPutOption.h"
+#include "option-pricer/options/CallOption.h"
+#include "option-pricer/pricing/BlackScholesMCPricer.h"
+#include "option-pricer/utils/MT.h"
+#include "option-pricer/utils/PathStore.h"
+
+namespace {
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+}
+
+int main() {
+    const std::string file = "test_pathstore.bin";
+    int errors = 0;
+
+    // arbitrary doubles come back bit for bit, repeated ones cost about a bit each
+    {
+        const std::vector<double> steps = {0.5, 1.0, 1.5, 2.0};
+        std::vector<double> paths;
+        const double specials[] = {0.0, -0.0, 1e-310, -3.5, std::numeric_limits<double>::infinity(),
+                                   std::numeric_limits<double>::quiet_NaN(), 1e300, 100.0};
+        for (int p = 0; p < 250; ++p) {
+            for (int k = 0; k < 4; ++k) {
+                paths.push_back(p % 5 == 0 ? specials[(p + k) % 8] : 100.0 * std::exp(0.01 * p - 0.003 * k * p));
+            }
+        }
+        const std::vector<double> flat(4 * 1000, 100.0);
+        PathStoreWriter writer(file, steps, 64);
+        writer.add(paths.data(), 250);
+        writer.add(flat.data(), 1000);
+        assert(writer.getNbPaths() == 1250);
+        try { PathStore early(file); } catch (const std::invalid_argument&) { ++errors; }
+        writer.finish();
+        try { writer.add(paths.data(), 1); } catch (const std::logic_error&) { ++errors; }
+        assert(writer.getBytesWritten() < 64 + 32 + 8 * 4 * (250 + 1000 / 8));
+
+        PathStore store(file);
+        assert(store.getNbPaths() == 1250 && store.getNbSteps() == 4 && store.getNbChunks() == 20);
+        assert(store.getTimeSteps() == steps);
+        std::vector<double> spots;
+        for (std::uint64_t i : {1249, 0, 1, 63, 64, 200, 249, 250, 999}) {
+            store.path(i, spots);
+            for (int k = 0; k < 4; ++k) {
+                assert(sameBits(spots[k], i < 250 ? paths[i * 4 + k] : 100.0));
+            }
+        }
+        try { store.path(1250, spots); } catch (const std::out_of_range&) { ++errors; }
+        CallOption call(1.0, 100.0);
+        try { store.price(call, 0.0); } catch (const std::invalid_argument&) { ++errors; }
+    }
+
+    // a stored simulation replays to the same price, and prices other payoffs on the same paths
+    std::vector<double> fixings;
+    for (int m = 1; m <= 12; ++m) {
+        fixings.push_back(m / 12.0);
+    }
+    AsianCallOption asian_call(fixings, 100.0);
+    AsianPutOption asian_put(fixings, 100.0);
+    MT::setEngine(RNGEngine::Xoshiro256pp, 11);
+    BlackScholesMCPricer pricer(&asian_call, 100.0, 0.03, 0.2);
+    {
+        PathStoreWriter writer(file, asian_call.getTimeSteps(), 1000);
+        pricer.setPathStore(&writer);
+        pricer.generate(6001);
+        pricer.generate(4000);
+        pricer.setPathStore(nullptr);
+        writer.finish();
+        // antithetic paths take about a byte per spot and the others seven: 33 bits per spot
+        assert(writer.getNbPaths() == 10001);
+        assert(8.0 * static_cast<double>(writer.getBytesWritten()) / (10001 * 12.0) < 36.0);
+    }
+    {
+        PathStore store(file);
+        assert(store.getNbPaths() == 10001 && store.getNbChunks() == 11);
+        assert(store.price(asian_call, 0.03) == pricer.price());
+
+        MT::setEngine(RNGEngine::Xoshiro256pp, 11);
+        BlackScholesMCPricer put_pricer(&asian_put, 100.0, 0.03, 0.2);
+        put_pricer.generate(6001);
+        put_pricer.generate(4000);
+        assert(store.price(asian_put, 0.03) == put_pricer.price());
+    }
+    MT::setEngine(RNGEngine::MT19937);
+
+    // the simulation must match the store's dates
+    {
+        PathStoreWriter writer(file, {0.5, 1.0});
+        pricer.setPathStore(&writer);
+        try { pricer.generate(10); } catch (const std::invalid_argument&) { ++errors; }
+        pricer.setPathStore(nullptr);
+    }
+
+    // a flipped bit in a chunk fails its checksum
+    {
+        PathStoreWriter writer(file, fixings, 100);
+        pricer.setPathStore(&writer);
+        pricer.generate(1000);
+        pricer.setPathStore(nullptr);
+    }
+    {
+        std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(64 + 12 * 8 + 100);
+        char c = 0;
+        f.seekg(64 + 12 * 8 + 100);
+        f.read(&c, 1);
+        c ^= 0x10;
+        f.seekp(64 + 12 * 8 + 100);
+        f.write(&c, 1);
+    }
+    {
+        PathStore store(file);
+        std::vector<double> spots;
+        store.path(999, spots);
+        try { store.path(0, spots); } catch (const std::invalid_argument&) { ++errors; }
+    }
+    std::ofstream(file, std::ios::binary | std::ios::trunc) << "OPPATH";
+    try { PathStore store(file); } catch (const std::invalid_argument&) { ++errors; }
+    try { PathStore store("no_such_path_store.bin"); } catch (const std::runtime_error&) { ++errors; }
+    try { PathStoreWriter writer(file, {1.0, 0.5}); } catch (const std::invalid_argument&) { ++errors; }
+    std::remove(file.c_str());
+    assert(errors == 9);
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "option-pricer/options/CallOption.h"
+#include "option-pricer/options/EuropeanDigitalCallOption.h"
+#include "option-pricer/options/EuropeanDigitalPutOption.h"
+#include "option-pricer/options/PutOption.h"
+#include "option-pricer/pricing/BlackScholesBatch.h"
+#include "option-pricer/pricing/BlackScholesPricer.h"
+#include "option-pricer/pricing/PnLExplain.h"
+
+namespace {
+constexpr double kEps = 1e-9;
+
+double bumpedPrice(const BlackScholesBatchInput& input, std::size_t j, double dS, double dvol, double dr, double dT) {
+    BlackScholesBatchInput one;
+    one.add(input.type[j], input.is_digital[j] != 0, input.spot[j] + dS, input.strike[j], input.expiry[j] + dT, input.rate[j] + dr, input.volatility[j] + dvol);
+    std::vector<double> prices;
+    BlackScholesBatch::price(one, prices);
+    return prices[0];
+}
+}
+
+int main() {
+    BlackScholesBatchInput input;
+    input.add(OptionType::Call, false, 100.0, 100.0, 1.0, 0.05, 0.2);
+    input.add(OptionType::Put, false, 100.0, 100.0, 1.0, 0.05, 0.2);
+    input.add(OptionType::Call, true, 100.0, 100.0, 1.0, 0.05, 0.2);
+    input.add(OptionType::Put, true, 100.0, 100.0, 1.0, 0.05, 0.2);
+    input.add(OptionType::Call, false, 90.0, 110.0, 0.5, 0.01, 0.35);
+    input.add(OptionType::Put, true, 120.0, 95.0, 2.0, 0.03, 0.15);
+
+    BlackScholesGreeks greeks;
+    BlackScholesBatch::greeks(input, greeks);
+
+    // prices agree with the single-option pricer
+    CallOption call(1.0, 100.0);
+    PutOption put(1.0, 100.0);
+    EuropeanDigitalCallOption digital_call(1.0, 100.0);
+    EuropeanDigitalPutOption digital_put(1.0, 100.0);
+    assert(std::fabs(greeks.price[0] - BlackScholesPricer(&call, 100.0, 0.05, 0.2).price()) < kEps);
+    assert(std::fabs(greeks.price[1] - BlackScholesPricer(&put, 100.0, 0.05, 0.2).price()) < kEps);
+    assert(std::fabs(greeks.price[2] - BlackScholesPricer(&digital_call, 100.0, 0.05, 0.2).price()) < kEps);
+    assert(std::fabs(greeks.price[3] - BlackScholesPricer(&digital_put, 100.0, 0.05, 0.2).price()) < kEps);
+    assert(std::fabs(greeks.delta[0] - BlackScholesPricer(&call, 100.0, 0.05, 0.2).delta()) < kEps);
+    assert(std::fabs(greeks.delta[3] - BlackScholesPricer(&digital_put, 100.0, 0.05, 0.2).delta()) < kEps);
+
+    // every greek against central finite differences
+    const double h = 1e-4;
+    for (std::size_t j = 0; j < input.size(); ++j) {
+        const double S = input.spot[j];
+        const double fd_delta = (bumpedPrice(input, j, h * S, 0, 0, 0) - bumpedPrice(input, j, -h * S, 0, 0, 0)) / (2 * h * S);
+        const double fd_gamma = (bumpedPrice(input, j, h * S, 0, 0, 0) - 2 * greeks.price[j] + bumpedPrice(input, j, -h * S, 0, 0, 0)) / (h * S * h * S);
+        const double fd_vega = (bumpedPrice(input, j, 0, h, 0, 0) - bumpedPrice(input, j, 0, -h, 0, 0)) / (2 * h);
+        const double fd_theta = -(bumpedPrice(input, j, 0, 0, 0, h) - bumpedPrice(input, j, 0, 0, 0, -h)) / (2 * h);
+        const double fd_rho = (bumpedPrice(input, j, 0, 0, h, 0) - bumpedPrice(input, j, 0, 0, -h, 0)) / (2 * h);
+        const double fd_vanna = (bumpedPrice(input, j, h * S, h, 0, 0) - bumpedPrice(input, j, h * S, -h, 0, 0) - bumpedPrice(input, j, -h * S, h, 0, 0) + bumpedPrice(input, j, -h * S, -h, 0, 0)) / (4 * h * h * S);
+        const double fd_volga = (bumpedPrice(input, j, 0, h, 0, 0) - 2 * greeks.price[j] + bumpedPrice(input, j, 0, -h, 0, 0)) / (h * h);
+        assert(std::fabs(greeks.delta[j] - fd_delta) < 1e-6);
+        assert(std::fabs(greeks.gamma[j] - fd_gamma) < 1e-4);
+        assert(std::fabs(greeks.vega[j] - fd_vega) < 1e-5);
+        assert(std::fabs(greeks.theta[j] - fd_theta) < 1e-5);
+        assert(std::fabs(greeks.rho[j] - fd_rho) < 1e-5);
+        assert(std::fabs(greeks.vanna[j] - fd_vanna) < 1e-3);
+        assert(std::fabs(greeks.volga[j] - fd_volga) < 1e-2);
+    }
+
+    // explain: small moves are almost fully explained, totals add up
+    const double one_day = 1.0 / 365.0;
+    PnLExplain explain(one_day, 1);
+    explain.addPosition(&call, 10.0, {100.0, 0.05, 0.2}, {101.0, 0.05, 0.205});
+    explain.addPosition(&put, -5.0, {100.0, 0.05, 0.2}, {99.5, 0.051, 0.19});
+    explain.addPosition(&digital_call, 100.0, {100.0, 0.05, 0.2}, {100.2, 0.05, 0.2});
+    explain.compute();
+    double actual = 0.0;
+    for (std::size_t j = 0; j < explain.size(); ++j) {
+        const PnLExplainLine& line = explain.position(j);
+        assert(std::fabs(line.unexplained) < 0.05 * std::fabs(line.actual) + 1e-3);
+        assert(std::fabs(line.explained + line.unexplained - line.actual) < kEps);
+        actual += line.actual;
+    }
+    assert(std::fabs(explain.total().actual - actual) < kEps);
+
+    // multi-threaded explain gives the same totals as the single-threaded one
+    PnLExplain serial(one_day, 1);
+    PnLExplain parallel(one_day, 4);
+    std::vector<CallOption> calls;
+    calls.reserve(4000);
+    for (int j = 0; j < 4000; ++j) {
+        calls.emplace_back(0.1 + 0.001 * j, 80.0 + 0.01 * j);
+    }
+    for (int j = 0; j < 4000; ++j) {
+        const MarketData start{100.0, 0.02, 0.25};
+        const MarketData end{100.0 + 0.0005 * j, 0.02, 0.25 + 1e-6 * j};
+        serial.addPosition(&calls[j], 1.0, start, end);
+        parallel.addPosition(&calls[j], 1.0, start, end);
+    }
+    serial.compute();
+    parallel.compute();
+    assert(serial.total().actual == parallel.total().actual);
+    assert(serial.total().unexplained == parallel.total().unexplained);
+
+    bool read_before_compute_thrown = false;
+    try {
+        PnLExplain empty(one_day);
+        (void)empty.total();
+    } catch (const std::logic_error&) {
+        read_before_compute_thrown = true;
+    }
+    assert(read_before_compute_thrown);
+
+    bool expired_thrown = false;
+    try {
+        CallOption short_call(0.001, 100.0);
+        PnLExplain late(one_day);
+        late.addPosition(&short_call, 1.0, {100.0, 0.05, 0.2}, {100.0, 0.05, 0.2});
+    } catch (const std::invalid_argument&) {
+        expired_thrown = true;
+    }
+    assert(expired_thrown);
+
+    return 0;
+}
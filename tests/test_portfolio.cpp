@@ -0,0 +1,130 @@
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "option-pricer/options/AsianOption.h"
+#include "option-pricer/options/OptionBook.h"
+#include "option-pricer/pricing/BlackScholesBatch.h"
+#include "option-pricer/pricing/BlackScholesMCBatch.h"
+#include "option-pricer/pricing/BlackScholesPricer.h"
+#include "option-pricer/pricing/PortfolioMCScheduler.h"
+#include "option-pricer/utils/PortfolioGenerator.h"
+
+int main() {
+    const std::size_t n = 20000;
+    PortfolioGenerator generator;
+    generator.generate(n, 7);
+    const std::vector<SyntheticTrade>& trades = generator.trades();
+    const std::vector<MarketQuote>& market = generator.market();
+    assert(trades.size() == n && market.size() == generator.getMix().nb_underlyings);
+
+    // the same seed gives the same book, another seed another
+    {
+        std::ostringstream first;
+        std::ostringstream again;
+        std::ostringstream other;
+        generator.writeCsv(first);
+        PortfolioGenerator twin;
+        twin.generate(n, 7);
+        twin.writeCsv(again);
+        twin.generate(n, 8);
+        twin.writeCsv(other);
+        assert(first.str() == again.str() && first.str() != other.str());
+        assert(first.str().rfind("trade,kind,type,underlying,spot,rate,volatility,expiry,strike,fixings,quantity\n0,", 0) == 0);
+    }
+
+    // the draws follow the mix
+    std::size_t counts[4] = {0, 0, 0, 0};
+    std::size_t calls = 0;
+    std::size_t monthly = 0;
+    double mean_log_moneyness = 0.0;
+    for (const SyntheticTrade& t : trades) {
+        ++counts[static_cast<int>(t.kind)];
+        calls += t.type == OptionType::Call;
+        const MarketQuote& q = market.at(t.underlying);
+        assert(t.expiry > 0.0 && t.expiry <= 11.0 && t.quantity >= 1.0 && t.quantity <= 1000.0);
+        assert(q.spot >= 5.0 && q.spot <= 1000.0 && q.volatility >= 0.08 && q.volatility <= 0.8);
+        const double m = std::log(t.strike / (q.spot * std::exp(q.rate * t.expiry)));
+        assert(std::fabs(m) <= 1.5 + 1e-12);
+        mean_log_moneyness += m / n;
+        if (t.kind == ProductKind::Asian) {
+            monthly += t.nb_fixings == 12;
+        } else {
+            assert(t.nb_fixings == 1);
+        }
+    }
+    const double weights[4] = {0.45, 0.10, 0.20, 0.25};
+    for (int k = 0; k < 4; ++k) {
+        assert(std::fabs(static_cast<double>(counts[k]) / n - weights[k]) < 0.02);
+    }
+    assert(std::fabs(static_cast<double>(calls) / n - 0.5) < 0.02);
+    assert(std::fabs(static_cast<double>(monthly) / counts[3] - 0.5) < 0.03);
+    assert(std::fabs(mean_log_moneyness) < 0.01);
+
+    // a custom mix: Americans only, all calls, one tenor
+    {
+        PortfolioMix mix;
+        mix.european_vanilla = mix.european_digital = mix.asian = 0.0;
+        mix.call_share = 1.0;
+        mix.tenors = {2.0};
+        mix.tenor_weights = {1.0};
+        mix.tenor_jitter = 0.0;
+        PortfolioGenerator americans(mix);
+        americans.generate(100, 1);
+        for (const SyntheticTrade& t : americans.trades()) {
+            assert(t.kind == ProductKind::American && t.type == OptionType::Call && t.expiry == 2.0);
+        }
+    }
+
+    // the batch inputs
+    OptionBook book;
+    generator.fill(book);
+    assert(book.size() == n);
+    BlackScholesBatchInput input;
+    const std::vector<std::size_t> rows = generator.fill(input);
+    assert(input.size() == rows.size() && rows.size() == counts[0] + counts[1]);
+    std::vector<double> prices;
+    BlackScholesBatch::price(input, prices);
+    for (std::size_t r = 0; r < rows.size(); r += 997) {
+        const SyntheticTrade& t = trades[rows[r]];
+        const MarketQuote& q = market[t.underlying];
+        assert(book[rows[r]]->getExpiry() == t.expiry);
+        double expected = 0.0;
+        if (t.kind == ProductKind::EuropeanVanilla) {
+            expected = BlackScholesPricer(static_cast<EuropeanVanillaOption*>(book[rows[r]]), q.spot, q.rate, q.volatility)();
+        } else {
+            expected = BlackScholesPricer(static_cast<EuropeanDigitalOption*>(book[rows[r]]), q.spot, q.rate, q.volatility)();
+        }
+        assert(std::fabs(prices[r] - expected) < 1e-9 * std::max(1.0, expected));
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(book[i]->isAmericanOption() == (trades[i].kind == ProductKind::American));
+        if (trades[i].kind == ProductKind::Asian) {
+            const std::vector<double> steps = book[i]->getTimeSteps();
+            assert(static_cast<int>(steps.size()) == trades[i].nb_fixings && steps.back() == trades[i].expiry);
+        }
+    }
+    BlackScholesMCBatch batch;
+    PortfolioMCScheduler scheduler;
+    const std::vector<std::size_t> contracts = generator.fill(batch, book);
+    assert(batch.size() == contracts.size() && contracts.size() == n - counts[2]);
+    assert(generator.fill(scheduler, book).size() == contracts.size());
+
+    int errors = 0;
+    OptionBook stale;
+    try { generator.fill(batch, stale); } catch (const std::invalid_argument&) { ++errors; }
+    PortfolioMix bad;
+    bad.tenor_weights.pop_back();
+    try { PortfolioGenerator g(bad); } catch (const std::invalid_argument&) { ++errors; }
+    bad = PortfolioMix();
+    bad.european_vanilla = bad.european_digital = bad.american = bad.asian = 0.0;
+    try { PortfolioGenerator g(bad); } catch (const std::invalid_argument&) { ++errors; }
+    bad = PortfolioMix();
+    bad.min_spot = 0.0;
+    try { PortfolioGenerator g(bad); } catch (const std::invalid_argument&) { ++errors; }
+    assert(errors == 4);
+    return 0;
+}
@@ -1,21 +1,80 @@
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include "option-pricer/options/AmericanCallOption.h"
 #include "option-pricer/options/AmericanPutOption.h"
+#include "option-pricer/options/AsianCallOption.h"
+#include "option-pricer/options/AsianPutOption.h"
 #include "option-pricer/options/CallOption.h"
 #include "option-pricer/options/EuropeanDigitalCallOption.h"
 #include "option-pricer/options/EuropeanDigitalPutOption.h"
 #include "option-pricer/options/PutOption.h"
+#include "option-pricer/pricing/Black76Pricer.h"
+#include "option-pricer/pricing/BlackScholesBatch.h"
 #include "option-pricer/pricing/BlackScholesPricer.h"
+#include "option-pricer/pricing/BlackScholesMCBatch.h"
 #include "option-pricer/pricing/BlackScholesMCPricer.h"
 #include "option-pricer/pricing/CRRPricer.h"
+#include "option-pricer/pricing/FixedDepthCRR.h"
+#include "option-pricer/pricing/GaussHermitePricer.h"
+#include "option-pricer/pricing/PortfolioMCScheduler.h"
+#include "option-pricer/pricing/TurnbullWakemanPricer.h"
+#include "option-pricer/pricing/VectorizedCRR.h"
+#include "option-pricer/pricing/PricerPool.h"
+#include "option-pricer/utils/MT.h"
 
 namespace {
 constexpr double kEps = 1e-6;
 }
 
+// American payoff outside the vanilla fast path
+class AmericanStraddle : public AmericanOption {
+public:
+    AmericanStraddle(double expiry, double strike) : AmericanOption(expiry, strike) {}
+    OptionType getOptionType() const override { return OptionType::Call; }
+    double payoff(double spot) const override { return std::fabs(spot - _strike); }
+};
+
+// payoffs of both signs: a forward and an American capped long position
+class ForwardContract : public Option {
+public:
+    ForwardContract(double expiry, double strike) : Option(expiry), _strike(strike) {}
+    OptionType getOptionType() const override { return OptionType::Call; }
+    double payoff(double spot) const override { return spot - _strike; }
+private:
+    double _strike;
+};
+
+class AmericanCappedForward : public AmericanOption {
+public:
+    AmericanCappedForward(double expiry, double strike) : AmericanOption(expiry, strike) {}
+    OptionType getOptionType() const override { return OptionType::Call; }
+    double payoff(double spot) const override { return std::min(spot - _strike, 10.0); }
+};
+
+// smooth payoff with a closed-form expectation
+class PowerOption : public Option {
+public:
+    explicit PowerOption(double expiry) : Option(expiry) {}
+    OptionType getOptionType() const override { return OptionType::Call; }
+    double payoff(double spot) const override { return spot * spot; }
+};
+
+// call spread: two kinks the quadrature has to split at
+class CallSpread : public Option {
+public:
+    CallSpread(double expiry, double low, double high) : Option(expiry), _low(low), _high(high) {}
+    OptionType getOptionType() const override { return OptionType::Call; }
+    double payoff(double spot) const override { return std::min(std::max(spot - _low, 0.0), _high - _low); }
+    std::vector<double> getPayoffKinks() const override { return {_low, _high}; }
+private:
+    double _low;
+    double _high;
+};
+
 int main() {
     CallOption call(1.0, 100.0);
     PutOption put(1.0, 100.0);
@@ -55,6 +114,57 @@ int main() {
     assert(std::fabs(digital_call_pricer.delta() - expected_digital_delta) < kEps);
     assert(std::fabs(digital_put_pricer.delta() + expected_digital_delta) < kEps);
 
+    // ----Black76Pricer tests----
+    // spot model mapped to forward / discount factor gives the Black-Scholes prices
+    const double disc = std::exp(-rate * 1.0);
+    const double fwd = spot / disc;
+    Black76Pricer b76_call(&call, fwd, disc, vol);
+    Black76Pricer b76_put(&put, fwd, disc, vol);
+    assert(std::fabs(b76_call.price() - expected_call) < kEps);
+    assert(std::fabs(b76_put() - expected_put) < kEps);
+    assert(std::fabs(b76_call.delta() * fwd / spot - expected_call_delta) < kEps);
+    Black76Pricer b76_digital_call(&digital_call, fwd, disc, vol);
+    assert(std::fabs(b76_digital_call.price() - expected_digital_call) < kEps);
+    assert(std::fabs(b76_digital_call.delta() * fwd / spot - expected_digital_delta) < kEps);
+
+    // put on a future (Hull): F=20, K=20, r=9%, sigma=25%, T=4 months
+    PutOption futures_put(4.0 / 12.0, 20.0);
+    Black76Pricer futures_put_pricer(&futures_put, 20.0, std::exp(-0.09 * 4.0 / 12.0), 0.25);
+    assert(std::fabs(futures_put_pricer.price() - 1.1166) < 1e-4);
+
+    // put-call parity on the forward
+    CallOption futures_call(4.0 / 12.0, 20.0);
+    Black76Pricer futures_call_pricer(&futures_call, 20.0, std::exp(-0.09 * 4.0 / 12.0), 0.25);
+    assert(std::fabs(futures_call_pricer.price() - futures_put_pricer.price()) < kEps);
+
+    bool b76_invalid_thrown = false;
+    try {
+        Black76Pricer invalid(&call, fwd, 0.0, vol);
+    } catch (const std::invalid_argument&) {
+        b76_invalid_thrown = true;
+    }
+    assert(b76_invalid_thrown);
+
+    // a chain sharing its expiry, priced in batch, matches option-by-option pricing
+    BlackScholesBatchInput chain;
+    for (double K = 60.0; K <= 140.0; K += 5.0) {
+        chain.add(OptionType::Call, false, spot, K, 1.0, rate, vol + 0.001 * (K - 100.0));
+        chain.add(OptionType::Put, true, spot, K, 2.0, rate, vol);
+    }
+    std::vector<double> chain_prices;
+    BlackScholesBatch::price(chain, chain_prices);
+    for (std::size_t j = 0; j < chain.size(); ++j) {
+        double single = 0.0;
+        if (chain.is_digital[j]) {
+            EuropeanDigitalPutOption option(chain.expiry[j], chain.strike[j]);
+            single = BlackScholesPricer(&option, spot, rate, chain.volatility[j]).price();
+        } else {
+            CallOption option(chain.expiry[j], chain.strike[j]);
+            single = BlackScholesPricer(&option, spot, rate, chain.volatility[j]).price();
+        }
+        assert(std::fabs(chain_prices[j] - single) < 1e-12);
+    }
+
     // ----BlackScholesMCPricer tests----
 //     constexpr int mc_paths = 200000;
 //     BlackScholesMCPricer mc_call_pricer(&call, spot, rate, vol);
@@ -203,5 +313,426 @@ int main() {
     assert(std::fabs(american_put_pricer.get(0, 0) - expected_american_put) < kEps);
     assert(!american_put_pricer.getExercise(0, 0));
 
+    // ----reconfigure() and pricer pools----
+    CRRPricer reused;
+    bool unconfigured_thrown = false;
+    try {
+        (void)reused();
+    } catch (const std::logic_error&) {
+        unconfigured_thrown = true;
+    }
+    assert(unconfigured_thrown);
+    for (int depth : {50, 20, 50, 3}) {
+        reused.reconfigure(&american_put, depth, americanPutS0, ctor_rate, ctor_sigma);
+        CRRPricer fresh(&american_put, depth, americanPutS0, ctor_rate, ctor_sigma);
+        assert(std::fabs(reused() - fresh()) < kEps);
+    }
+    reused.reconfigure(&crr_call, crrDepth, crrS0, crrU, crrD, crrR);
+    assert(std::fabs(reused() - expected_crr_call) < kEps);
+
+    bool bad_reconfigure_thrown = false;
+    try {
+        reused.reconfigure(&crr_call, crrDepth, crrS0, 0.9, 0.95, 0.9);
+    } catch (const std::invalid_argument&) {
+        bad_reconfigure_thrown = true;
+    }
+    assert(bad_reconfigure_thrown);
+    assert(std::fabs(reused() - expected_crr_call) < kEps); // left unchanged
+
+    BlackScholesMCPricer reused_mc(&call, spot, rate, vol);
+    reused_mc.generate(1000);
+    reused_mc.reconfigure(&put, spot, rate, vol);
+    assert(reused_mc.getNbPaths() == 0);
+    reused_mc.generate(1000);
+    assert(reused_mc.getNbPaths() == 1000);
+
+    std::vector<PutOption> book;
+    for (int j = 0; j < 64; ++j) {
+        book.emplace_back(0.5 + 0.01 * j, 90.0 + 0.5 * j);
+    }
+    std::vector<double> pooled(book.size());
+    PricerPool<CRRPricer> pool(4);
+    for (int round = 0; round < 2; ++round) {
+        pool.forEach(book.size(), [&](CRRPricer& pricer, std::size_t j) {
+            pricer.reconfigure(&book[j], 40, spot, rate, vol);
+            pooled[j] = pricer();
+        });
+    }
+    for (std::size_t j = 0; j < book.size(); ++j) {
+        assert(std::fabs(pooled[j] - CRRPricer(&book[j], 40, spot, rate, vol)()) < kEps);
+    }
+
+    // compile-time depth kernels agree with the generic tree at every supported depth
+    AmericanPutOption shallow_put(1.0, 105.0);
+    CallOption shallow_call(1.0, 95.0);
+    for (int depth = 1; depth <= FixedDepthCRR::kMaxDepth; ++depth) {
+        const double fixed_put = FixedDepthCRR::price(&shallow_put, depth, spot, rate, vol);
+        const double fixed_call = FixedDepthCRR::price(&shallow_call, depth, spot, rate, vol);
+        assert(std::fabs(fixed_put - CRRPricer(&shallow_put, depth, spot, rate, vol)()) < 1e-10);
+        assert(std::fabs(fixed_call - CRRPricer(&shallow_call, depth, spot, rate, vol)()) < 1e-10);
+    }
+    assert(std::fabs(FixedDepthCRR::price(&shallow_put, 0, spot, 1.1, 0.9, 1.01) - shallow_put.payoff(spot)) < kEps);
+    assert(FixedDepthCRR::supports(64) && !FixedDepthCRR::supports(65));
+    bool unsupported_thrown = false;
+    try {
+        FixedDepthCRR::price(&shallow_put, 65, spot, rate, vol);
+    } catch (const std::invalid_argument&) {
+        unsupported_thrown = true;
+    }
+    assert(unsupported_thrown);
+
+    // vectorized deep-tree kernel: same tree as CRRPricer, across tile and block edges
+    VectorizedCRR vectorized;
+    AmericanStraddle straddle(1.0, 100.0);
+    EuropeanDigitalCallOption deep_digital(1.0, 100.0);
+    for (int depth : {1, 63, 64, 65, 1023, 1100, 2500}) {
+        for (Option* option : std::vector<Option*>{&shallow_put, &shallow_call, &straddle, &deep_digital}) {
+            const double reference = CRRPricer(option, depth, spot, rate, vol)();
+            assert(std::fabs(vectorized.price(option, depth, spot, rate, vol) - reference) < 1e-9);
+        }
+    }
+    // negative payoffs are not flushed: out-of-the-money forwards keep their sign
+    ForwardContract forward(1.0, 120.0);
+    AmericanCappedForward capped(1.0, 120.0);
+    for (int depth : {65, 1100}) {
+        const double forward_price = vectorized.price(&forward, depth, spot, rate, vol);
+        assert(forward_price < 0.0);
+        assert(std::fabs(forward_price - CRRPricer(&forward, depth, spot, rate, vol)()) < 1e-9);
+        assert(std::fabs(forward_price - (spot - 120.0 * std::exp(-rate))) < 1e-9);
+        const double capped_price = vectorized.price(&capped, depth, spot, rate, vol);
+        assert(capped_price < 0.0);
+        assert(std::fabs(capped_price - CRRPricer(&capped, depth, spot, rate, vol)()) < 1e-9);
+    }
+    AmericanCallOption deep_call(1.0, 95.0); // never exercised early without dividends
+    assert(std::fabs(vectorized.price(&deep_call, 3000, spot, rate, vol) - vectorized.price(&shallow_call, 3000, spot, rate, vol)) < 1e-9);
+    assert(std::fabs(vectorized.price(&shallow_put, 0, spot, 1.1, 0.9, 1.01) - shallow_put.payoff(spot)) < kEps);
+
+    // truncated lattice: the error is of the order of the normal tail beyond the band
+    VectorizedCRR truncated(6.0);
+    VectorizedCRR wide(8.0);
+    assert(truncated.getTruncation() == 6.0);
+    for (Option* option : std::vector<Option*>{&shallow_put, &shallow_call, &straddle, &deep_digital}) {
+        const double full = vectorized.price(option, 4000, spot, rate, vol);
+        assert(std::fabs(truncated.price(option, 4000, spot, rate, vol) - full) < 1e-7);
+        assert(std::fabs(wide.price(option, 4000, spot, rate, vol) - full) < 1e-12);
+    }
+    PutOption far_put(1.0, 300.0); // deep in the money: the whole band prices off the boundary
+    assert(std::fabs(truncated.price(&far_put, 4000, spot, rate, vol) - vectorized.price(&far_put, 4000, spot, rate, vol)) < 1e-7);
+    bool negative_truncation_thrown = false;
+    try {
+        truncated.setTruncation(-1.0);
+    } catch (const std::invalid_argument&) {
+        negative_truncation_thrown = true;
+    }
+    assert(negative_truncation_thrown);
+
+    // checkpointed storage: every node and exercise decision as in the full tree
+    constexpr int checkpointDepth = 300;
+    CRRPricer full_tree(&shallow_put, checkpointDepth, spot, rate, vol);
+    const double full_tree_price = full_tree();
+    for (int interval : {0, 1, 7, 25, 300}) {
+        CRRPricer checkpointed(&shallow_put, checkpointDepth, spot, rate, vol);
+        checkpointed.setStorage(CRRStorage::Checkpointed, interval, 2);
+        const double checkpointed_price = checkpointed();
+        assert(checkpointed_price == full_tree_price);
+        assert(checkpointed.getCheckpointInterval() == (interval == 0 ? 18 : interval));
+        for (int n = checkpointDepth; n >= 0; n -= 13) {
+            for (int i = 0; i <= n; i += 5) {
+                assert(checkpointed.get(n, i) == full_tree.get(n, i));
+                assert(checkpointed.getExercise(n, i) == full_tree.getExercise(n, i));
+                assert(checkpointed.get(checkpointDepth - n, i % (checkpointDepth - n + 1)) ==
+                       full_tree.get(checkpointDepth - n, i % (checkpointDepth - n + 1)));
+            }
+        }
+        bool no_full_tree_thrown = false;
+        try {
+            (void)checkpointed.getOptionTree();
+        } catch (const std::logic_error&) {
+            no_full_tree_thrown = true;
+        }
+        assert(no_full_tree_thrown);
+        bool node_out_of_range_thrown = false;
+        try {
+            (void)checkpointed.get(checkpointDepth + 1, 0);
+        } catch (const std::out_of_range&) {
+            node_out_of_range_thrown = true;
+        }
+        assert(node_out_of_range_thrown);
+        checkpointed.setStorage(CRRStorage::FullTree);
+        const double full_storage_price = checkpointed();
+        assert(full_storage_price == full_tree_price && checkpointed.getExercise(checkpointDepth, 0));
+    }
+    bool bad_storage_thrown = false;
+    try {
+        full_tree.setStorage(CRRStorage::Checkpointed, 4, 0);
+    } catch (const std::invalid_argument&) {
+        bad_storage_thrown = true;
+    }
+    assert(bad_storage_thrown);
+
+    // lane-per-contract MC: heterogeneous markets and step counts in one batch
+    BlackScholesMCBatch mc_batch;
+    std::vector<PutOption> mc_puts;
+    std::vector<CallOption> mc_calls;
+    for (int j = 0; j < 11; ++j) {
+        mc_puts.emplace_back(0.5 + 0.1 * j, 90.0 + 2.0 * j);
+        mc_calls.emplace_back(0.5 + 0.1 * j, 90.0 + 2.0 * j);
+    }
+    AsianCallOption mc_asian({0.25, 0.5, 0.75, 1.0}, 100.0);
+    AsianCallOption mc_single_fixing({1.0}, 100.0);
+    EuropeanDigitalCallOption mc_digital(1.0, 100.0);
+    std::vector<double> mc_expected;
+    for (int j = 0; j < 11; ++j) {
+        const double s0 = 80.0 + 4.0 * j;
+        const double sigma = 0.1 + 0.03 * j;
+        mc_batch.add(&mc_puts[j], s0, rate, sigma);
+        mc_expected.push_back(BlackScholesPricer(&mc_puts[j], s0, rate, sigma).price());
+        mc_batch.add(&mc_calls[j], s0, 0.01 * j, sigma);
+        mc_expected.push_back(BlackScholesPricer(&mc_calls[j], s0, 0.01 * j, sigma).price());
+    }
+    const std::size_t digital_index = mc_batch.add(&mc_digital, spot, rate, vol);
+    const std::size_t single_fixing_index = mc_batch.add(&mc_single_fixing, spot, rate, vol);
+    const std::size_t asian_index = mc_batch.add(&mc_asian, spot, rate, vol);
+    mc_batch.generate(100001);
+    for (std::size_t j = 0; j < mc_expected.size(); ++j) {
+        const std::vector<double> ci = mc_batch.confidenceInterval(j);
+        assert(mc_batch.getNbPaths(j) == 100001);
+        assert(std::fabs(mc_batch.price(j) - mc_expected[j]) < 2.6 * (ci[1] - ci[0]) + 1e-12); // 5 standard errors
+    }
+    const auto within = [&](std::size_t j, double expected) {
+        const std::vector<double> ci = mc_batch.confidenceInterval(j);
+        return std::fabs(mc_batch.price(j) - expected) < 2.6 * (ci[1] - ci[0]);
+    };
+    assert(within(digital_index, BlackScholesPricer(&digital_call, spot, rate, vol).price()));
+    assert(within(single_fixing_index, expected_call));
+    BlackScholesMCPricer mc_asian_reference(&mc_asian, spot, rate, vol);
+    mc_asian_reference.generate(100000);
+    const std::vector<double> asian_ci = mc_asian_reference.confidenceInterval();
+    const std::vector<double> batch_asian_ci = mc_batch.confidenceInterval(asian_index);
+    // two independent estimates: 5 standard errors of their difference
+    assert(std::fabs(mc_batch.price(asian_index) - mc_asian_reference.price()) <
+           2.6 * std::hypot(asian_ci[1] - asian_ci[0], batch_asian_ci[1] - batch_asian_ci[0]));
+    // log-returns outside the range of exp saturate instead of wrapping the exponent: at a
+    // volatility of 38 they spread around -722, every path ends near 0 and a put is worth
+    // its discounted strike
+    BlackScholesMCBatch extreme_batch;
+    PutOption extreme_put(1.0, 100.0);
+    extreme_batch.add(&extreme_put, spot, rate, 38.0);
+    extreme_batch.generate(1001);
+    assert(std::fabs(extreme_batch.price(0) - 100.0 * std::exp(-rate)) < 1e-9);
+    bool batch_index_thrown = false;
+    try {
+        (void)mc_batch.price(mc_batch.size());
+    } catch (const std::out_of_range&) {
+        batch_index_thrown = true;
+    }
+    assert(batch_index_thrown);
+
+    // moment matching: exact moments per block, batch-means confidence interval with the
+    // t quantile of four blocks (the normal one would cover about 86% of the runs)
+    MT::setEngine(RNGEngine::Xoshiro256pp, 11);
+    int covered = 0;
+    double matched_width = 0.0;
+    double plain_width = 0.0;
+    constexpr int mm_runs = 400;
+    for (int run = 0; run < mm_runs; ++run) {
+        BlackScholesMCPricer matched(&call, spot, rate, vol);
+        matched.setMomentMatching(true, BlackScholesMCPricer::kMinBlockPairs);
+        matched.generate(8 * BlackScholesMCPricer::kMinBlockPairs);
+        const std::vector<double> ci = matched.confidenceInterval();
+        covered += ci[0] <= expected_call && expected_call <= ci[1] ? 1 : 0;
+        matched_width += ci[1] - ci[0];
+        BlackScholesMCPricer plain(&call, spot, rate, vol);
+        plain.generate(8 * BlackScholesMCPricer::kMinBlockPairs);
+        const std::vector<double> plain_ci = plain.confidenceInterval();
+        plain_width += plain_ci[1] - plain_ci[0];
+    }
+    assert(covered >= 0.93 * mm_runs && covered <= 0.97 * mm_runs); // 95% within two binomial deviations
+    assert(matched_width < 0.8 * plain_width);
+
+    BlackScholesMCPricer matched_asian(&mc_asian, spot, rate, vol);
+    matched_asian.setMomentMatching(true);
+    assert(matched_asian.getMomentMatching());
+    matched_asian.generate(100001);
+    const std::vector<double> matched_asian_ci = matched_asian.confidenceInterval();
+    assert(matched_asian.getNbPaths() == 100001);
+    assert(std::fabs(matched_asian.price() - mc_asian_reference.price()) <
+           2.6 * std::hypot(asian_ci[1] - asian_ci[0], matched_asian_ci[1] - matched_asian_ci[0]));
+
+    BlackScholesMCPricer one_block(&call, spot, rate, vol);
+    one_block.setMomentMatching(true, BlackScholesMCPricer::kMinBlockPairs);
+    one_block.generate(100);
+    bool one_block_thrown = false;
+    try {
+        (void)one_block.confidenceInterval();
+    } catch (const std::logic_error&) {
+        one_block_thrown = true;
+    }
+    assert(one_block_thrown);
+    bool small_block_thrown = false;
+    try {
+        one_block.setMomentMatching(true, BlackScholesMCPricer::kMinBlockPairs - 1);
+    } catch (const std::invalid_argument&) {
+        small_block_thrown = true;
+    }
+    assert(small_block_thrown);
+    MT::setEngine(RNGEngine::MT19937);
+
+    // Gauss-Hermite quadrature
+    GaussHermitePricer quadrature;
+    assert(quadrature.getNodes() == GaussHermitePricer::kDefaultNodes);
+    assert(std::fabs(quadrature.price(&call, spot, rate, vol) - expected_call) < 1e-10);
+    assert(std::fabs(quadrature.price(&put, spot, rate, vol) - expected_put) < 1e-10);
+    assert(std::fabs(quadrature.price(&digital_call, spot, rate, vol) - digital_call_pricer.price()) < 1e-10);
+    assert(std::fabs(quadrature.price(&digital_put, spot, rate, vol) - digital_put_pricer.price()) < 1e-10);
+    for (double strike : {60.0, 95.0, 140.0, 300.0}) {
+        CallOption otm_call(0.5, strike);
+        PutOption otm_put(2.0, strike);
+        const double bs_call = BlackScholesPricer(&otm_call, spot, rate, 0.35).price();
+        const double bs_put = BlackScholesPricer(&otm_put, spot, rate, 0.35).price();
+        assert(std::fabs(quadrature.price(&otm_call, spot, rate, 0.35) - bs_call) < 1e-10);
+        assert(std::fabs(quadrature.price(&otm_put, spot, rate, 0.35) - bs_put) < 1e-10);
+    }
+
+    PowerOption power(1.0);
+    const double expected_power = std::exp(-rate) * spot * spot * std::exp(2.0 * rate + vol * vol);
+    assert(std::fabs(quadrature.price(&power, spot, rate, vol) / expected_power - 1.0) < 1e-12);
+
+    CallSpread spread(1.0, 90.0, 120.0);
+    CallOption call_90(1.0, 90.0);
+    CallOption call_120(1.0, 120.0);
+    const double expected_spread =
+        BlackScholesPricer(&call_90, spot, rate, vol).price() - BlackScholesPricer(&call_120, spot, rate, vol).price();
+    assert(std::fabs(quadrature.price(&spread, spot, rate, vol) - expected_spread) < 1e-10);
+
+    CallOption expired(0.0, 90.0);
+    assert(quadrature.price(&expired, spot, rate, vol) == 10.0);
+
+    AsianCallOption asian_for_quadrature({0.5, 1.0}, 100.0);
+    AmericanPutOption american_for_quadrature(1.0, 100.0);
+    int quadrature_errors = 0;
+    for (Option* option : std::vector<Option*>{nullptr, &asian_for_quadrature, &american_for_quadrature}) {
+        try {
+            (void)quadrature.price(option, spot, rate, vol);
+        } catch (const std::invalid_argument&) {
+            ++quadrature_errors;
+        }
+    }
+    try {
+        (void)quadrature.price(&call, spot, rate, 0.0);
+    } catch (const std::invalid_argument&) {
+        ++quadrature_errors;
+    }
+    try {
+        GaussHermitePricer too_few(1);
+    } catch (const std::invalid_argument&) {
+        ++quadrature_errors;
+    }
+    assert(quadrature_errors == 5);
+
+    // portfolio MC scheduler: batches go where they cut the portfolio error most
+    MT::setEngine(RNGEngine::Xoshiro256pp, 5);
+    PortfolioMCScheduler portfolio;
+    int scheduler_errors = 0;
+    try {
+        (void)portfolio.run(0.1);
+    } catch (const std::logic_error&) {
+        ++scheduler_errors;
+    }
+    const std::size_t big = portfolio.add(&call, spot, rate, vol, 2.0);
+    const std::size_t tiny = portfolio.add(&put, spot, rate, vol, 0.001);
+    const std::size_t digital = portfolio.add(&digital_call, spot, rate, vol, 10.0);
+    assert(portfolio.size() == 3);
+    portfolio.setBatchPaths(4096, 8192);
+    const bool pilots_converged = portfolio.run(0.0, 0.0); // no time budget: pilots only
+    assert(!pilots_converged);
+    assert(portfolio.getBatches() == 0);
+    assert(portfolio.getNbPaths(big) == 4096 && portfolio.getNbPaths(tiny) == 4096);
+    const bool converged = portfolio.run(0.1);
+    assert(converged);
+    const std::vector<double> portfolio_ci = portfolio.confidenceInterval();
+    assert(0.5 * (portfolio_ci[1] - portfolio_ci[0]) <= 0.1);
+    assert(portfolio.getBatches() > 0 && portfolio.getElapsed() > 0.0);
+    assert(portfolio.getNbPaths(tiny) == 4096); // never worth a batch
+    assert(portfolio.getNbPaths(big) > 4096 && portfolio.getNbPaths(digital) > 4096);
+    const double expected_portfolio = 2.0 * expected_call + 0.001 * expected_put + 10.0 * digital_call_pricer.price();
+    assert(std::fabs(portfolio.price() - expected_portfolio) < 3.0 * portfolio.standardError());
+    assert(std::fabs(portfolio.price(big) - expected_call) < 0.1);
+    try {
+        (void)portfolio.price(3);
+    } catch (const std::out_of_range&) {
+        ++scheduler_errors;
+    }
+    try {
+        portfolio.setBatchPaths(1, 100);
+    } catch (const std::invalid_argument&) {
+        ++scheduler_errors;
+    }
+    try {
+        (void)portfolio.run(0.0);
+    } catch (const std::invalid_argument&) {
+        ++scheduler_errors;
+    }
+    assert(scheduler_errors == 4);
+    MT::setEngine(RNGEngine::MT19937);
+
+    // seasoned Asians: only the remaining fixings are simulated
+    MT::setEngine(RNGEngine::Xoshiro256pp, 8);
+    std::vector<double> monthly;
+    for (int m = 1; m <= 12; ++m) {
+        monthly.push_back(m / 12.0);
+    }
+    AsianCallOption fresh_asian(monthly, 100.0);
+    BlackScholesMCPricer fresh_mc(&fresh_asian, spot, rate, vol);
+    fresh_mc.generate(200000);
+    const std::vector<double> fresh_ci = fresh_mc.confidenceInterval();
+    const double fresh_tw = TurnbullWakemanPricer(&fresh_asian, spot, rate, vol).price();
+    assert(std::fabs(fresh_tw - fresh_mc.price()) < 0.02 * fresh_tw + 0.5 * (fresh_ci[1] - fresh_ci[0]));
+
+    // with one fixing left, the option is a call on S struck at n K - past sum, over n
+    AsianCallOption last_fixing(monthly, 100.0);
+    AsianPutOption last_fixing_put(monthly, 100.0);
+    const std::vector<double> eleven_fixings(11, 101.0);
+    last_fixing.setPastFixings(0.95, eleven_fixings);
+    last_fixing_put.setPastFixings(0.95, eleven_fixings);
+    CallOption residual_call(1.0 - 0.95, 12.0 * 100.0 - 11.0 * 101.0);
+    PutOption residual_put(1.0 - 0.95, 12.0 * 100.0 - 11.0 * 101.0);
+    const double expected_last = BlackScholesPricer(&residual_call, spot, rate, vol).price() / 12.0;
+    const double expected_last_put = BlackScholesPricer(&residual_put, spot, rate, vol).price() / 12.0;
+    assert(std::fabs(TurnbullWakemanPricer(&last_fixing, spot, rate, vol).price() - expected_last) < 1e-12);
+    assert(std::fabs(TurnbullWakemanPricer(&last_fixing_put, spot, rate, vol).price() - expected_last_put) < 1e-12);
+    BlackScholesMCPricer last_fixing_mc(&last_fixing, spot, rate, vol);
+    last_fixing_mc.generate(100000);
+    const std::vector<double> last_ci = last_fixing_mc.confidenceInterval();
+    assert(last_ci[0] < expected_last && expected_last < last_ci[1]);
+
+    // half seasoned: approximation and both MC engines agree
+    AsianCallOption half_seasoned(monthly, 100.0);
+    half_seasoned.setPastFixings(0.5, std::vector<double>(6, 104.0));
+    BlackScholesMCPricer half_mc(&half_seasoned, spot, rate, vol);
+    half_mc.generate(200000);
+    const std::vector<double> half_ci = half_mc.confidenceInterval();
+    const double half_tw = TurnbullWakemanPricer(&half_seasoned, spot, rate, vol).price();
+    assert(std::fabs(half_tw - half_mc.price()) < 0.01 * half_tw + 0.5 * (half_ci[1] - half_ci[0]));
+    BlackScholesMCBatch seasoned_batch;
+    seasoned_batch.add(&half_seasoned, spot, rate, vol);
+    seasoned_batch.generate(200000);
+    const std::vector<double> half_batch_ci = seasoned_batch.confidenceInterval(0);
+    assert(std::fabs(seasoned_batch.price(0) - half_mc.price()) <
+           2.6 * std::hypot(half_ci[1] - half_ci[0], half_batch_ci[1] - half_batch_ci[0]));
+
+    // deep in the money: the realised sum alone beats the strike
+    AsianCallOption locked_call(monthly, 100.0);
+    AsianPutOption locked_put(monthly, 100.0);
+    locked_call.setPastFixings(0.5, std::vector<double>(6, 250.0));
+    locked_put.setPastFixings(0.5, std::vector<double>(6, 250.0));
+    BlackScholesMCPricer locked_mc(&locked_call, spot, rate, vol);
+    locked_mc.generate(100000);
+    const std::vector<double> locked_ci = locked_mc.confidenceInterval();
+    const double locked_tw = TurnbullWakemanPricer(&locked_call, spot, rate, vol).price();
+    assert(locked_ci[0] < locked_tw && locked_tw < locked_ci[1]);
+    assert(TurnbullWakemanPricer(&locked_put, spot, rate, vol).price() == 0.0);
+    MT::setEngine(RNGEngine::MT19937);
+
     return 0;
 }
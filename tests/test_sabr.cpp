@@ -0,0 +1,91 @@
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "option-pricer/models/SABRModel.h"
+#include "option-pricer/options/CallOption.h"
+#include "option-pricer/options/PutOption.h"
+#include "option-pricer/pricing/BlackScholesPricer.h"
+
+int main() {
+    const double forward = 100.0;
+    const double expiry = 2.0;
+
+    // at the money the expansion reduces to alpha / F^(1 - beta) times the correction term
+    SABRModel lognormal(0.2, 1.0, -0.3, 0.4);
+    const double atm = lognormal.impliedVolatility(forward, forward, expiry);
+    const double expected_atm = 0.2 * (1.0 + (0.25 * -0.3 * 0.4 * 0.2 + (2.0 - 3.0 * 0.09) / 24.0 * 0.16) * expiry);
+    assert(std::fabs(atm - expected_atm) < 1e-12);
+
+    // the near-the-money expansion joins the exact branch continuously
+    SABRModel model(2.0, 0.5, -0.25, 0.45);
+    for (double eps : {1e-10, 1e-7, 1e-5, 1e-3}) {
+        const double below = model.impliedVolatility(forward, forward * (1.0 - eps), expiry);
+        const double above = model.impliedVolatility(forward, forward * (1.0 + eps), expiry);
+        const double at = model.impliedVolatility(forward, forward, expiry);
+        assert(std::fabs(below - at) < 10 * eps && std::fabs(above - at) < 10 * eps);
+    }
+
+    // batch evaluation matches the scalar one
+    const std::vector<double> strikes = {60.0, 70.0, 80.0, 90.0, 95.0, 100.0, 105.0, 110.0, 120.0, 140.0, 160.0};
+    const std::vector<double> vols = model.impliedVolatilities(forward, expiry, strikes);
+    for (std::size_t j = 0; j < strikes.size(); ++j) {
+        assert(vols[j] == model.impliedVolatility(forward, strikes[j], expiry));
+        assert(vols[j] > 0.0);
+    }
+    assert(vols.front() > vols[5]); // negative rho: downward skew
+
+    // exact jacobian against finite differences
+    const double h = 1e-6;
+    for (double K : {70.0, 100.0, 100.0 + 1e-6, 130.0}) {
+        double vol = 0.0;
+        double grad[3];
+        model.jacobian(forward, K, expiry, vol, grad);
+        assert(std::fabs(vol - model.impliedVolatility(forward, K, expiry)) < 1e-14);
+        const double fd_alpha = (SABRModel(2.0 + h, 0.5, -0.25, 0.45).impliedVolatility(forward, K, expiry) - SABRModel(2.0 - h, 0.5, -0.25, 0.45).impliedVolatility(forward, K, expiry)) / (2 * h);
+        const double fd_rho = (SABRModel(2.0, 0.5, -0.25 + h, 0.45).impliedVolatility(forward, K, expiry) - SABRModel(2.0, 0.5, -0.25 - h, 0.45).impliedVolatility(forward, K, expiry)) / (2 * h);
+        const double fd_nu = (SABRModel(2.0, 0.5, -0.25, 0.45 + h).impliedVolatility(forward, K, expiry) - SABRModel(2.0, 0.5, -0.25, 0.45 - h).impliedVolatility(forward, K, expiry)) / (2 * h);
+        assert(std::fabs(grad[0] - fd_alpha) < 1e-6);
+        assert(std::fabs(grad[1] - fd_rho) < 1e-6);
+        assert(std::fabs(grad[2] - fd_nu) < 1e-6);
+    }
+
+    // calibration recovers the parameters that generated the smile
+    double rmse = 1.0;
+    const SABRModel fitted = SABRModel::calibrate(forward, expiry, strikes, vols, 0.5, &rmse);
+    assert(rmse < 1e-8);
+    assert(std::fabs(fitted.getAlpha() - 2.0) < 1e-5);
+    assert(std::fabs(fitted.getRho() + 0.25) < 1e-5);
+    assert(std::fabs(fitted.getNu() - 0.45) < 1e-5);
+
+    // a whole chain is priced from the SABR parameters
+    const double spot = 95.0;
+    const double rate = 0.03;
+    const std::vector<OptionType> types(strikes.size(), OptionType::Call);
+    const std::vector<double> prices = model.priceChain(spot, rate, expiry, strikes, types);
+    const double chain_forward = spot * std::exp(rate * expiry);
+    for (std::size_t j = 0; j < strikes.size(); ++j) {
+        CallOption call(expiry, strikes[j]);
+        const double vol = model.impliedVolatility(chain_forward, strikes[j], expiry);
+        assert(std::fabs(prices[j] - BlackScholesPricer(&call, spot, rate, vol).price()) < 1e-9);
+    }
+
+    bool invalid_thrown = false;
+    try {
+        SABRModel invalid(0.2, 0.5, 1.0, 0.3);
+    } catch (const std::invalid_argument&) {
+        invalid_thrown = true;
+    }
+    assert(invalid_thrown);
+
+    bool too_few_thrown = false;
+    try {
+        (void)SABRModel::calibrate(forward, expiry, {90.0, 100.0}, {0.2, 0.2}, 0.5);
+    } catch (const std::invalid_argument&) {
+        too_few_thrown = true;
+    }
+    assert(too_few_thrown);
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "option-pricer/options/AsianCallOption.h"
+#include "option-pricer/options/CallOption.h"
+#include "option-pricer/pricing/BlackScholesPricer.h"
+#include "option-pricer/pricing/MCShard.h"
+
+namespace {
+
+// run a worker in a child process; a crashing worker dies on its first chunk, without answering
+pid_t spawnWorker(Option* option, const MCShardJob& job, unsigned short port, bool crash = false, unsigned delay_us = 0) {
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        ::usleep(delay_us);
+        try {
+            MCShardWorker worker(option, job);
+            worker.setChunkCallback([crash](std::uint64_t) {
+                if (crash) {
+                    ::_exit(3);
+                }
+            });
+            worker.run("127.0.0.1", port);
+        } catch (const std::exception&) {
+            ::_exit(1);
+        }
+        ::_exit(0);
+    }
+    return pid;
+}
+
+int waitFor(pid_t pid) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+}
+
+int main() {
+    CallOption call(1.0, 100.0);
+    MCShardJob job;
+    job.initial_price = 100.0;
+    job.interest_rate = 0.05;
+    job.volatility = 0.2;
+    job.seed = 2024;
+    job.chunk_paths = 5000;
+    job.digest_compression = 100.0;
+    job.histogram_lower = 0.0;
+    job.histogram_upper = 80.0;
+    job.histogram_bins = 40;
+    const std::uint64_t nb_paths = 250001; // last chunk shorter, and odd
+
+    MCShardCoordinator local(&call, job);
+    local.runLocal(nb_paths);
+    assert(local.getNbPaths() == nb_paths);
+    const double expected = BlackScholesPricer(&call, 100.0, 0.05, 0.2).price();
+    const std::vector<double> local_ci = local.confidenceInterval();
+    assert(local_ci[0] < expected && expected < local_ci[1]);
+    assert(local.getHistogram().getTotal() == nb_paths && local.getQuantiles().count() == nb_paths);
+
+    // three workers, one of which dies: same result, bit for bit
+    MCShardCoordinator coordinator(&call, job);
+    coordinator.setWorkerTimeout(30.0);
+    const unsigned short port = coordinator.listen();
+    const pid_t workers[3] = {spawnWorker(&call, job, port, true), spawnWorker(&call, job, port), spawnWorker(&call, job, port)};
+    coordinator.run(nb_paths);
+    int crashed = 0;
+    for (pid_t pid : workers) {
+        crashed += waitFor(pid) == 3 ? 1 : 0;
+    }
+    assert(crashed == 1);
+    assert(coordinator.getReissued() == 1 && coordinator.getWorkers() >= 2);
+    assert(coordinator.getNbPaths() == nb_paths);
+    assert(coordinator.price() == local.price());
+    assert(coordinator.confidenceInterval() == local_ci);
+    assert(coordinator.getQuantiles().quantile(0.9) == local.getQuantiles().quantile(0.9));
+    for (int i = 0; i < job.histogram_bins; ++i) {
+        assert(coordinator.getHistogram().getCount(i) == local.getHistogram().getCount(i));
+    }
+
+    // a single worker on a second run of the same coordinator
+    const pid_t single = spawnWorker(&call, job, port);
+    coordinator.run(nb_paths);
+    assert(waitFor(single) == 0);
+    assert(coordinator.getReissued() == 0 && coordinator.price() == local.price());
+
+    // workers with another job, another strike or another job id are turned away and report it
+    MCShardJob other = job;
+    other.seed = 7;
+    CallOption other_strike(1.0, 105.0);
+    MCShardJob other_id = job;
+    other_id.job_id = 1;
+    const pid_t strangers[3] = {spawnWorker(&call, other, port), spawnWorker(&other_strike, job, port), spawnWorker(&call, other_id, port)};
+    const pid_t helper = spawnWorker(&call, job, port, false, 300000);
+    coordinator.run(40000);
+    for (pid_t pid : strangers) {
+        assert(waitFor(pid) == 1);
+    }
+    assert(waitFor(helper) == 0);
+    assert(coordinator.getWorkers() == 1);
+
+    // an Asian option goes through the same way
+    AsianCallOption asian({0.25, 0.5, 0.75, 1.0}, 100.0);
+    MCShardJob asian_job = job;
+    asian_job.digest_compression = 0.0;
+    asian_job.histogram_bins = 0;
+    MCShardCoordinator asian_local(&asian, asian_job);
+    asian_local.runLocal(60000);
+    MCShardCoordinator asian_coordinator(&asian, asian_job);
+    const unsigned short asian_port = asian_coordinator.listen();
+    const pid_t asian_worker = spawnWorker(&asian, asian_job, asian_port);
+    asian_coordinator.run(60000);
+    assert(waitFor(asian_worker) == 0);
+    assert(asian_coordinator.price() == asian_local.price());
+
+    int errors = 0;
+    try {
+        MCShardCoordinator(&call, job).run(10);
+    } catch (const std::logic_error&) {
+        ++errors;
+    }
+    try {
+        (void)asian_local.getQuantiles();
+    } catch (const std::logic_error&) {
+        ++errors;
+    }
+    try {
+        MCShardJob tiny = job;
+        tiny.chunk_paths = 1;
+        MCShardWorker worker(&call, tiny);
+    } catch (const std::invalid_argument&) {
+        ++errors;
+    }
+    try {
+        MCShardCoordinator(&call, job).listen("not an address");
+    } catch (const std::invalid_argument&) {
+        ++errors;
+    }
+    MCShardCoordinator abandoned(&call, job);
+    abandoned.listen();
+    try {
+        abandoned.setRunTimeout(-1.0);
+    } catch (const std::invalid_argument&) {
+        ++errors;
+    }
+    abandoned.setRunTimeout(0.3);
+    try {
+        abandoned.run(nb_paths); // no worker ever connects
+    } catch (const std::runtime_error&) {
+        ++errors;
+    }
+    assert(errors == 6);
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "option-pricer/options/CallOption.h"
+#include "option-pricer/pricing/BlackScholesMCPricer.h"
+#include "option-pricer/utils/Histogram.h"
+#include "option-pricer/utils/MT.h"
+#include "option-pricer/utils/NormalDistribution.h"
+#include "option-pricer/utils/TDigest.h"
+
+int main() {
+    MT::setEngine(RNGEngine::Xoshiro256pp, 3);
+    const std::size_t n = 1000000;
+    std::vector<double> u(n);
+    MT::fill_uniform(u.data(), n);
+
+    // quantiles of uniforms against the sample quantiles, the tails most accurate
+    std::vector<double> sorted(u);
+    std::sort(sorted.begin(), sorted.end());
+    const auto sample_quantile = [&](double p) { return sorted[static_cast<std::size_t>(p * (n - 1))]; };
+    TDigest digest;
+    digest.add(u.data(), n);
+    assert(digest.count() == n);
+    assert(digest.centroids() <= static_cast<std::size_t>(digest.getCompression()));
+    for (double p : {0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999}) {
+        assert(std::fabs(digest.quantile(p) - sample_quantile(p)) < 5e-3 * std::sqrt(p * (1.0 - p)));
+    }
+    assert(digest.quantile(0.0) == digest.min() && digest.quantile(1.0) == digest.max());
+    assert(std::fabs(digest.tailMean(0.0, 1.0) - 0.5) < 1e-3);
+    assert(std::fabs(digest.expectedShortfall(0.95) - 0.975) < 1e-3);
+
+    // four partial digests merge into one as accurate
+    TDigest parts[4];
+    for (std::size_t i = 0; i < n; ++i) {
+        parts[i % 4].add(u[i]);
+    }
+    TDigest merged;
+    for (const TDigest& part : parts) {
+        merged.merge(part);
+    }
+    assert(merged.count() == n);
+    for (double p : {0.001, 0.01, 0.5, 0.99, 0.999}) {
+        assert(std::fabs(merged.quantile(p) - sample_quantile(p)) < 5e-3 * std::sqrt(p * (1.0 - p)));
+    }
+
+    // tail mean of exponentials: E[X | X >= q_0.99] = q_0.99 + 1
+    TDigest exponential(100.0);
+    for (double v : u) {
+        exponential.add(-std::log(1.0 - v));
+    }
+    assert(std::fabs(exponential.quantile(0.99) + std::log(0.01)) < 0.02);
+    assert(std::fabs(exponential.expectedShortfall(0.99) - (1.0 - std::log(0.01))) < 0.03);
+
+    // checkpoints round trip
+    std::stringstream digest_dump;
+    merged.save(digest_dump);
+    TDigest reloaded = TDigest::load(digest_dump);
+    assert(reloaded.count() == merged.count() && reloaded.getCompression() == merged.getCompression());
+    assert(reloaded.quantile(0.37) == merged.quantile(0.37));
+
+    // histograms
+    Histogram histogram(0.0, 1.0, 10);
+    histogram.add(u.data(), n);
+    histogram.add(-1.0);
+    histogram.add(1.0);
+    histogram.add(std::nan(""));
+    assert(histogram.getTotal() == n + 3);
+    assert(histogram.getUnderflow() == 1 && histogram.getOverflow() == 2);
+    for (int i = 0; i < histogram.getBins(); ++i) {
+        assert(std::fabs(histogram.getCount(i) - n / 10.0) < 5.0 * std::sqrt(n / 10.0));
+    }
+    assert(histogram.getEdge(0) == 0.0 && histogram.getEdge(10) == 1.0 && std::fabs(histogram.getEdge(3) - 0.3) < 1e-15);
+    Histogram other(0.0, 1.0, 10);
+    other.add(0.05);
+    other.merge(histogram);
+    assert(other.getCount(0) == histogram.getCount(0) + 1 && other.getTotal() == n + 4);
+    std::stringstream histogram_dump;
+    other.save(histogram_dump);
+    Histogram reloaded_histogram = Histogram::load(histogram_dump);
+    assert(reloaded_histogram.getCount(4) == other.getCount(4) && reloaded_histogram.getOverflow() == 2);
+
+    int errors = 0;
+    try {
+        Histogram(0.0, 2.0, 10).merge(histogram);
+    } catch (const std::invalid_argument&) {
+        ++errors;
+    }
+    try {
+        Histogram(1.0, 1.0, 10);
+    } catch (const std::invalid_argument&) {
+        ++errors;
+    }
+    try {
+        (void)histogram.getCount(10);
+    } catch (const std::out_of_range&) {
+        ++errors;
+    }
+    try {
+        (void)TDigest().quantile(0.5);
+    } catch (const std::logic_error&) {
+        ++errors;
+    }
+    try {
+        (void)digest.quantile(1.5);
+    } catch (const std::invalid_argument&) {
+        ++errors;
+    }
+    try {
+        std::stringstream garbage("not a digest at all");
+        (void)TDigest::load(garbage);
+    } catch (const std::invalid_argument&) {
+        ++errors;
+    }
+    // a corrupt centroid count or compression is rejected before anything is allocated
+    for (std::size_t field : {8, 16}) {
+        std::string bytes = digest_dump.str();
+        const std::uint64_t huge_size = std::uint64_t(1) << 60;
+        const double huge_compression = 1e300;
+        if (field == 8) {
+            std::memcpy(&bytes[field], &huge_size, sizeof(huge_size));
+        } else {
+            std::memcpy(&bytes[field], &huge_compression, sizeof(huge_compression));
+        }
+        std::stringstream corrupt(bytes);
+        try {
+            (void)TDigest::load(corrupt);
+        } catch (const std::invalid_argument&) {
+            ++errors;
+        }
+    }
+    assert(errors == 8);
+
+    // payoff distribution of a call, streamed from two pricers and merged
+    const double spot = 100.0;
+    const double rate = 0.05;
+    const double vol = 0.2;
+    CallOption call(1.0, 100.0);
+    TDigest thread_digests[2];
+    Histogram thread_histograms[2] = {Histogram(0.0, 100.0, 50), Histogram(0.0, 100.0, 50)};
+    for (int t = 0; t < 2; ++t) {
+        BlackScholesMCPricer pricer(&call, spot, rate, vol);
+        pricer.setSketches(&thread_digests[t], &thread_histograms[t]);
+        pricer.generate(200001);
+    }
+    thread_digests[0].merge(thread_digests[1]);
+    thread_histograms[0].merge(thread_histograms[1]);
+    assert(thread_digests[0].count() == 400002 && thread_histograms[0].getTotal() == 400002);
+    assert(thread_histograms[0].getUnderflow() == 0);
+
+    // discounted payoff quantile: exp(-r) (S0 exp(r - vol^2 / 2 + vol z_p) - K) above the exercise probability
+    const double exercised = NormalDistribution::cdf(rate / vol - 0.5 * vol);
+    assert(thread_digests[0].quantile(0.5 * (1.0 - exercised)) == 0.0);
+    const double z_90 = 1.2815515655446004;
+    const double expected_q90 = std::exp(-rate) * (spot * std::exp(rate - 0.5 * vol * vol + vol * z_90) - 100.0);
+    assert(std::fabs(thread_digests[0].quantile(0.9) - expected_q90) < 0.01 * expected_q90);
+    assert(static_cast<double>(thread_histograms[0].getCount(0)) / 400002 > 1.0 - exercised);
+
+    MT::setEngine(RNGEngine::MT19937);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "option-pricer/options/CallOption.h"
+#include "option-pricer/pricing/BlackScholesPricer.h"
+#include "option-pricer/pricing/GaussHermitePricer.h"
+#include "option-pricer/utils/TablePack.h"
+
+namespace {
+
+void flipByte(const std::string& path, long offset) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(offset);
+    char c = 0;
+    file.read(&c, 1);
+    c ^= 0x01;
+    file.seekp(offset);
+    file.write(&c, 1);
+}
+
+}
+
+int main() {
+    const std::string path = "test_tablepack.bin";
+    int errors = 0;
+
+    // round trip, tables found by name whatever the order they were added in
+    std::vector<double> ramp(1000);
+    for (std::size_t i = 0; i < ramp.size(); ++i) {
+        ramp[i] = 0.5 * static_cast<double>(i);
+    }
+    TablePackWriter writer;
+    writer.add("ramp", ramp);
+    writer.add("constants", {M_PI, M_E, -0.0});
+    writer.add("empty", {});
+    writer.add("constants", {M_PI, M_E});
+    writer.write(path);
+    {
+        TablePack pack(path);
+        assert(!pack.empty() && pack.size() == 3);
+        assert(pack.name(0) == "constants" && pack.name(1) == "empty" && pack.name(2) == "ramp");
+        const TableView view = pack.at("ramp");
+        assert(view.size == ramp.size());
+        assert(reinterpret_cast<std::uintptr_t>(view.data) % 64 == 0);
+        assert(std::vector<double>(view.begin(), view.end()) == ramp);
+        assert(pack.at("constants").size == 2 && pack.at("constants")[0] == M_PI);
+        assert(pack.at("empty").empty());
+        assert(!pack.find("missing").data);
+
+        TablePack moved(std::move(pack));
+        assert(pack.empty() && pack.size() == 0 && moved.at("ramp")[999] == 499.5);
+    }
+    try { TablePack(path).at("missing"); } catch (const std::out_of_range&) { ++errors; }
+    try { TablePackWriter().add(std::string(40, 'x'), {}); } catch (const std::invalid_argument&) { ++errors; }
+    try { TablePackWriter().add("", {}); } catch (const std::invalid_argument&) { ++errors; }
+    try { TablePack("no_such_table_pack.bin"); } catch (const std::runtime_error&) { ++errors; }
+
+    // a flipped bit in a table fails the checksum, unless it is not verified
+    flipByte(path, 64 * 4);
+    try { TablePack pack(path); } catch (const std::invalid_argument&) { ++errors; }
+    assert(TablePack(path, false).at("constants")[0] != M_PI);
+    flipByte(path, 0);
+    try { TablePack pack(path, false); } catch (const std::invalid_argument&) { ++errors; }
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "OPTBL";
+    try { TablePack pack(path); } catch (const std::invalid_argument&) { ++errors; }
+    std::remove(path.c_str());
+    assert(errors == 7);
+
+    // the pack generated by the build holds the quadrature rules bit for bit
+    const TablePack& pack = TablePack::defaultPack();
+    assert(!pack.empty() && !TablePack::defaultPackPath().empty());
+    for (int nodes : {16, 48, 256}) {
+        std::vector<double> hermite_nodes, hermite_weights, legendre_nodes, legendre_weights;
+        GaussHermitePricer::computeRules(nodes, hermite_nodes, hermite_weights, legendre_nodes, legendre_weights);
+        const std::string n = std::to_string(nodes);
+        const TableView packed = pack.at("gauss_hermite/" + n + "/weights");
+        assert(std::vector<double>(packed.begin(), packed.end()) == hermite_weights);
+        const TableView packed_legendre = pack.at("gauss_legendre/" + n + "/nodes");
+        assert(std::vector<double>(packed_legendre.begin(), packed_legendre.end()) == legendre_nodes);
+    }
+    CallOption call(1.0, 100.0);
+    BlackScholesPricer bs(&call, 100.0, 0.03, 0.2);
+    assert(std::fabs(GaussHermitePricer().price(&call, 100.0, 0.03, 0.2) - bs()) < 1e-10);
+    assert(std::fabs(GaussHermitePricer(50).price(&call, 100.0, 0.03, 0.2) - bs()) < 1e-10);
+    return 0;
+}
@@ -0,0 +1,33 @@
+// Generates the library's table pack at build time; see TablePack.h for the format.
+//
+//   make_table_pack output.bin
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <vector>
+#include "GaussHermitePricer.h"
+#include "TablePack.h"
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s output.bin\n", argv[0]);
+        return 2;
+    }
+    try {
+        TablePackWriter writer;
+        for (int nodes : {16, 24, 32, 48, 64, 96, 128, 256}) {
+            std::vector<double> hermite_nodes, hermite_weights, legendre_nodes, legendre_weights;
+            GaussHermitePricer::computeRules(nodes, hermite_nodes, hermite_weights, legendre_nodes, legendre_weights);
+            const std::string n = std::to_string(nodes);
+            writer.add("gauss_hermite/" + n + "/nodes", hermite_nodes);
+            writer.add("gauss_hermite/" + n + "/weights", hermite_weights);
+            writer.add("gauss_legendre/" + n + "/nodes", legendre_nodes);
+            writer.add("gauss_legendre/" + n + "/weights", legendre_weights);
+        }
+        writer.write(argv[1]);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}